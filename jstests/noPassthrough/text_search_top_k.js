@@ -0,0 +1,101 @@
+// Text searches sorted by text score with a limit stop reading the text index once the top
+// results are known, and return the same results as reading every matching index key.
+(function() {
+    "use strict";
+
+    load("jstests/libs/analyze_plan.js");
+
+    var conn = MongoRunner.runMongod({});
+    assert.neq(null, conn, "mongod was unable to start up");
+    var testDB = conn.getDB("test");
+    var coll = testDB.text_search_top_k;
+    coll.drop();
+
+    // Word i appears in roughly one document in i, so low numbered words are common and high
+    // numbered words are rare. Documents repeat words a varying number of times so that their
+    // scores differ.
+    var nDocs = 3000;
+    var nWords = 50;
+    Random.setRandomSeed(0);
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < nDocs; i++) {
+        var words = [];
+        for (var w = 1; w <= nWords; w++) {
+            if (Random.randInt(w) === 0) {
+                var repeat = 1 + Random.randInt(4);
+                for (var r = 0; r < repeat; r++) {
+                    words.push("word" + w);
+                }
+            }
+        }
+        for (var f = Random.randInt(20); f > 0; f--) {
+            words.push("filler" + Random.randInt(1000));
+        }
+        bulk.insert({_id: i, body: words.join(" ")});
+    }
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(coll.createIndex({body: "text"}));
+
+    function runTopK(search, limit) {
+        return coll.find({$text: {$search: search}}, {score: {$meta: "textScore"}})
+            .sort({score: {$meta: "textScore"}})
+            .limit(limit)
+            .toArray();
+    }
+
+    function totalKeysExamined(search, limit) {
+        var explain = coll.find({$text: {$search: search}}, {score: {$meta: "textScore"}})
+                          .sort({score: {$meta: "textScore"}})
+                          .limit(limit)
+                          .explain("executionStats");
+        return explain.executionStats.totalKeysExamined;
+    }
+
+    function setTopKEnabled(enabled) {
+        assert.commandWorked(
+            testDB.adminCommand({setParameter: 1, internalQueryExecEnableTextTopK: enabled}));
+    }
+
+    var searches = ["word1", "word1 word2", "word2 word3 word40", "word1 word2 word3 word4 word5"];
+    searches.forEach(function(search) {
+        [1, 20].forEach(function(limit) {
+            setTopKEnabled(false);
+            var expected = runTopK(search, limit);
+            var fullKeys = totalKeysExamined(search, limit);
+
+            setTopKEnabled(true);
+            var actual = runTopK(search, limit);
+            var topKKeys = totalKeysExamined(search, limit);
+
+            // Documents with equal scores may come back in either order, so compare scores.
+            assert.eq(expected.length, actual.length, search);
+            for (var i = 0; i < expected.length; i++) {
+                assert.close(expected[i].score, actual[i].score, search + " result " + i, 10);
+            }
+            assert.lte(topKKeys, fullKeys, search);
+            print("text top-k search '" + search + "' limit " + limit + ": " + topKKeys +
+                  " keys examined, versus " + fullKeys + " reading every key");
+        });
+    });
+
+    // A common term with a small limit does not need to read every posting.
+    var explain = coll.find({$text: {$search: "word1"}}, {score: {$meta: "textScore"}})
+                      .sort({score: {$meta: "textScore"}})
+                      .limit(5)
+                      .explain("executionStats");
+    var textOr = getPlanStage(explain.executionStats.executionStages, "TEXT_OR");
+    assert.neq(null, textOr, tojson(explain));
+    assert.eq(5, textOr.topK, tojson(textOr));
+    assert(textOr.stoppedEarly, tojson(textOr));
+    assert.lt(explain.executionStats.totalKeysExamined, nDocs, tojson(explain));
+
+    // Negated terms and phrases can reject documents after scoring, so every key is read.
+    explain = coll.find({$text: {$search: "word1 -word2"}}, {score: {$meta: "textScore"}})
+                  .sort({score: {$meta: "textScore"}})
+                  .limit(5)
+                  .explain("executionStats");
+    textOr = getPlanStage(explain.executionStats.executionStages, "TEXT_OR");
+    assert.eq(undefined, textOr.topK, tojson(textOr));
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,47 @@
+// The TTL monitor deletes expired documents in batches of at most ttlMonitorBatchSize, paced over
+// ttlMonitorSleepSecs, and carries whatever a pass did not get to over to the next passes.
+(function() {
+    "use strict";
+
+    var conn = MongoRunner.runMongod(
+        {setParameter: {ttlMonitorSleepSecs: 1, ttlMonitorBatchSize: 7}});
+    assert.neq(null, conn, "mongod was unable to start up");
+    var testDB = conn.getDB("test");
+    var coll = testDB.ttl_batched;
+    coll.drop();
+
+    var nDocs = 100;
+    var past = new Date(new Date().getTime() - 60 * 60 * 1000);
+    var future = new Date(new Date().getTime() + 60 * 60 * 1000);
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < nDocs; i++) {
+        bulk.insert({_id: i, x: past});
+    }
+    bulk.insert({_id: nDocs, x: future});
+    assert.writeOK(bulk.execute());
+
+    var ttlStats = testDB.serverStatus().metrics.ttl;
+    assert.commandWorked(coll.createIndex({x: 1}, {expireAfterSeconds: 60}));
+
+    assert.soon(function() {
+        return coll.find().itcount() === 1;
+    }, "expired documents were not deleted: " + tojson(coll.find().toArray()));
+    assert.eq(future, coll.findOne().x);
+
+    var newStats = testDB.serverStatus().metrics.ttl;
+    assert.eq(nDocs, newStats.deletedDocuments - ttlStats.deletedDocuments);
+    assert.gte(newStats.batches - ttlStats.batches, Math.ceil(nDocs / 7), tojson(newStats));
+
+    // A rate limit spreads the deletes out but still removes every expired document.
+    assert.commandWorked(testDB.adminCommand({setParameter: 1, ttlMonitorMaxDeletesPerSecond: 50}));
+    bulk = coll.initializeUnorderedBulkOp();
+    for (var j = 0; j < 20; j++) {
+        bulk.insert({x: past});
+    }
+    assert.writeOK(bulk.execute());
+    assert.soon(function() {
+        return coll.find().itcount() === 1;
+    }, "rate limited TTL pass did not delete the expired documents");
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,46 @@
+// Multi-updates applied in batches must update every matching document exactly once, including
+// when the update moves documents forward in the index being scanned.
+(function() {
+    'use strict';
+
+    var conn = MongoRunner.runMongod({setParameter: "internalUpdateMaxBatchSize=7"});
+    assert.neq(null, conn, "mongod was unable to start up");
+    var testDB = conn.getDB("test");
+    var coll = testDB.update_multi_batched;
+    coll.drop();
+
+    var nDocs = 100;
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < nDocs; i++) {
+        bulk.insert({_id: i, a: i, b: i % 2});
+    }
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(coll.createIndex({a: 1}));
+
+    // Every document is seen once even though incrementing 'a' moves it ahead of the scan.
+    var res = coll.update({a: {$gte: 0}}, {$inc: {a: nDocs}}, {multi: true});
+    assert.writeOK(res);
+    assert.eq(nDocs, res.nMatched);
+    assert.eq(nDocs, res.nModified);
+    assert.eq(nDocs, coll.find({a: {$gte: nDocs}}).itcount());
+
+    // Batches which are only partially filled by the filter.
+    res = coll.update({b: 1}, {$set: {c: 1}}, {multi: true});
+    assert.writeOK(res);
+    assert.eq(nDocs / 2, res.nMatched);
+    assert.eq(nDocs / 2, coll.find({c: 1}).itcount());
+
+    // Documents that already match the update are matched but not modified.
+    res = coll.update({}, {$set: {c: 1}}, {multi: true});
+    assert.writeOK(res);
+    assert.eq(nDocs, res.nMatched);
+    assert.eq(nDocs / 2, res.nModified);
+
+    // Batching can be disabled at runtime.
+    assert.commandWorked(testDB.adminCommand({setParameter: 1, internalUpdateMaxBatchSize: 1}));
+    res = coll.update({}, {$unset: {c: 1}}, {multi: true});
+    assert.writeOK(res);
+    assert.eq(nDocs, res.nModified);
+
+    MongoRunner.stopMongod(conn);
+})();
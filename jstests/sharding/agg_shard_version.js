@@ -0,0 +1,66 @@
+// Tests that aggregations which mongos sends to the shards with a shard version attached are
+// accepted, on both sharded and unsharded collections.
+(function() {
+    "use strict";
+
+    var st = new ShardingTest({shards: 2, mongos: 2});
+
+    var dbName = jsTest.name();
+    var testDB = st.s.getDB(dbName);
+
+    assert.commandWorked(st.s.adminCommand({enableSharding: dbName}));
+    st.ensurePrimaryShard(dbName, 'shard0000');
+
+    var shardedColl = testDB.sharded;
+    assert.commandWorked(
+        st.s.adminCommand({shardCollection: shardedColl.getFullName(), key: {_id: 1}}));
+    assert.commandWorked(st.s.adminCommand({split: shardedColl.getFullName(), middle: {_id: 0}}));
+    assert.commandWorked(st.s.adminCommand(
+        {moveChunk: shardedColl.getFullName(), find: {_id: 0}, to: 'shard0001'}));
+
+    var unshardedColl = testDB.unsharded;
+
+    for (var i = -50; i < 50; i++) {
+        assert.writeOK(shardedColl.insert({_id: i, x: (i + 50) % 5}));
+        assert.writeOK(unshardedColl.insert({_id: i, x: (i + 50) % 5}));
+    }
+
+    var pipeline = [{$group: {_id: "$x", count: {$sum: 1}}}, {$sort: {_id: 1}}];
+    var expected = [
+        {_id: 0, count: 20},
+        {_id: 1, count: 20},
+        {_id: 2, count: 20},
+        {_id: 3, count: 20},
+        {_id: 4, count: 20}
+    ];
+
+    // Aggregations which target both shards and a single shard of a sharded collection
+    assert.eq(expected, shardedColl.aggregate(pipeline).toArray());
+    assert.eq([{_id: 0, count: 10}, {_id: 1, count: 10}, {_id: 2, count: 10}],
+              shardedColl.aggregate([{$match: {_id: {$gte: 0}, x: {$lt: 3}}}].concat(pipeline))
+                  .toArray());
+    assert.commandWorked(shardedColl.explain().aggregate(pipeline));
+
+    // Aggregations on an unsharded collection in a sharded database
+    assert.eq(expected, unshardedColl.aggregate(pipeline).toArray());
+    assert.commandWorked(unshardedColl.explain().aggregate(pipeline));
+
+    // An aggregation sent with a stale shard version is retried after refreshing the routing
+    // table of the mongos which sent it
+    var staleMongos = st.s1;
+    assert.eq(expected, staleMongos.getDB(dbName).sharded.aggregate(pipeline).toArray());
+    assert.commandWorked(st.s.adminCommand(
+        {moveChunk: shardedColl.getFullName(), find: {_id: -1}, to: 'shard0001'}));
+    assert.eq(expected, staleMongos.getDB(dbName).sharded.aggregate(pipeline).toArray());
+
+    // The shards accept the shard version as part of the aggregate command itself
+    var res = st.shard1.getDB(dbName).runCommand({
+        aggregate: shardedColl.getName(),
+        pipeline: [],
+        cursor: {},
+        shardVersion: [Timestamp(0, 0), ObjectId()]
+    });
+    assert.neq(ErrorCodes.FailedToParse, res.code, tojson(res));
+
+    st.stop();
+})();
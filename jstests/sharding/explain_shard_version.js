@@ -0,0 +1,50 @@
+// Explain commands sent through mongos carry the shard version of the explained collection, which
+// the shards check against that collection rather than against the database.
+(function() {
+    'use strict';
+
+    var st = new ShardingTest({shards: 2, mongos: 2});
+
+    var dbName = "test";
+    var testDB = st.s0.getDB(dbName);
+    var coll = testDB.explain_shard_version;
+
+    assert.commandWorked(testDB.adminCommand({enableSharding: dbName}));
+    st.ensurePrimaryShard(dbName, 'shard0000');
+    assert.commandWorked(testDB.adminCommand({shardCollection: coll.getFullName(), key: {a: 1}}));
+    assert.commandWorked(testDB.adminCommand({split: coll.getFullName(), middle: {a: 0}}));
+    assert.commandWorked(
+        testDB.adminCommand({moveChunk: coll.getFullName(), find: {a: 0}, to: 'shard0001'}));
+
+    for (var i = -5; i < 5; i++) {
+        assert.writeOK(coll.insert({a: i, b: i}));
+    }
+
+    function checkExplains(numShards) {
+        var explain = coll.explain("executionStats").find({b: {$gte: 0}}).finish();
+        assert.commandWorked(explain);
+        assert.eq(5, explain.executionStats.nReturned, tojson(explain));
+        assert.eq(
+            numShards, explain.executionStats.executionStages.shards.length, tojson(explain));
+
+        explain = coll.explain("executionStats").count({b: {$gte: -5}});
+        assert.commandWorked(explain);
+        assert.eq(
+            numShards, explain.executionStats.executionStages.shards.length, tojson(explain));
+
+        assert.commandWorked(coll.explain().distinct("b"));
+        assert.commandWorked(coll.explain().find({a: 3}).finish());
+    }
+
+    checkExplains(2);
+
+    // Move a chunk through the other mongos, so that the first one routes the explains with a
+    // stale shard version and has to refresh and retry them.
+    assert.commandWorked(st.s1.adminCommand(
+        {moveChunk: coll.getFullName(), find: {a: -1}, to: 'shard0001', _waitForDelete: true}));
+
+    // All the chunks are now on the same shard.
+    checkExplains(1);
+
+    st.stop();
+})();
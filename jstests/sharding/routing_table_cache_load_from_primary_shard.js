@@ -0,0 +1,55 @@
+// A router without any routing information for a sharded collection starts from the routing table
+// which the primary shard of the database persisted in its routing metadata cache, and only reads
+// the chunks which changed since then from the config servers.
+(function() {
+    'use strict';
+
+    var st = new ShardingTest({shards: 2, mongos: 2});
+
+    var dbName = "test";
+    var ns = dbName + ".foo";
+    var testDB = st.s0.getDB(dbName);
+
+    assert.commandWorked(st.s0.adminCommand({enableSharding: dbName}));
+    st.ensurePrimaryShard(dbName, 'shard0000');
+    assert.commandWorked(st.s0.adminCommand({shardCollection: ns, key: {x: 1}}));
+
+    for (var i = 1; i <= 5; i++) {
+        assert.commandWorked(st.s0.adminCommand({split: ns, middle: {x: i * 10}}));
+    }
+    assert.commandWorked(
+        st.s0.adminCommand({moveChunk: ns, find: {x: 50}, to: 'shard0001', _waitForDelete: true}));
+
+    assert.writeOK(testDB.foo.insert({x: 0}));
+    assert.writeOK(testDB.foo.insert({x: 55}));
+
+    // The primary shard refreshed its metadata after donating the chunk, so its cache holds the
+    // complete routing table
+    var numChunks = st.s0.getDB("config").chunks.count({ns: ns});
+    assert.eq(6, numChunks);
+
+    var cacheDB = st.shard0.getDB("config");
+    assert.eq(false, cacheDB.cache.collections.findOne({_id: ns}).refreshing);
+    assert.eq(numChunks, cacheDB.getCollection("cache.chunks." + ns).count());
+
+    assert.commandWorked(
+        st.shard0.adminCommand({_getCachedRoutingTable: ns}), "shard cannot return its cache");
+    assert.commandFailedWithCode(st.shard0.adminCommand({_getCachedRoutingTable: dbName + ".none"}),
+                                 ErrorCodes.NamespaceNotFound);
+
+    // A restarted router loads the routing table from the primary shard
+    st.restartMongos(1);
+
+    var fromShardCacheBefore =
+        st.s1.getDB("admin").serverStatus().metrics.sharding.chunkManager.chunksFromShardCache;
+    assert.eq(2, st.s1.getDB(dbName).foo.find().itcount());
+    var fromShardCacheAfter =
+        st.s1.getDB("admin").serverStatus().metrics.sharding.chunkManager.chunksFromShardCache;
+    assert.eq(numChunks, fromShardCacheAfter - fromShardCacheBefore);
+
+    // The router targets the documents on both shards
+    assert.eq(1, st.s1.getDB(dbName).foo.find({x: 0}).itcount());
+    assert.eq(1, st.s1.getDB(dbName).foo.find({x: 55}).itcount());
+
+    st.stop();
+})();
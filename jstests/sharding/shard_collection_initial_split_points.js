@@ -0,0 +1,151 @@
+// Pre-splitting an empty collection, with a ranged shard key using initialSplitPoints or with a
+// hashed shard key using numInitialChunks, creates the initial chunks directly on all the shards
+// without any migrations. Writes which reach the primary shard while the collection is being
+// sharded never leave documents outside of the chunks owned by their shard.
+(function() {
+    'use strict';
+
+    load("jstests/libs/check_log.js");
+
+    var st = new ShardingTest({shards: 3, mongos: 2});
+
+    var dbName = "test";
+    var testDB = st.s.getDB(dbName);
+    var configDB = st.s.getDB("config");
+
+    assert.commandWorked(testDB.adminCommand({enableSharding: dbName}));
+    st.ensurePrimaryShard(dbName, 'shard0001');
+
+    // Split points must be valid shard keys.
+    assert.commandFailedWithCode(
+        testDB.adminCommand(
+            {shardCollection: dbName + ".bad", key: {x: 1}, initialSplitPoints: [{y: 10}]}),
+        ErrorCodes.InvalidOptions);
+
+    // Split points cannot be given for hashed shard keys.
+    assert.commandFailedWithCode(
+        testDB.adminCommand(
+            {shardCollection: dbName + ".bad", key: {x: "hashed"}, initialSplitPoints: [{x: 10}]}),
+        ErrorCodes.InvalidOptions);
+
+    // Split points cannot be given for a collection which already contains data.
+    assert.writeOK(testDB.nonEmpty.insert({x: 1}));
+    assert.commandWorked(testDB.nonEmpty.createIndex({x: 1}));
+    assert.commandFailedWithCode(
+        testDB.adminCommand(
+            {shardCollection: dbName + ".nonEmpty", key: {x: 1}, initialSplitPoints: [{x: 10}]}),
+        ErrorCodes.InvalidOptions);
+
+    var splitPoints = [];
+    for (var i = 1; i < 12; i++) {
+        splitPoints.push({x: i * 100});
+    }
+
+    assert.commandWorked(testDB.adminCommand(
+        {shardCollection: dbName + ".foo", key: {x: 1}, initialSplitPoints: splitPoints}));
+
+    assert.eq(12, configDB.chunks.count({ns: dbName + ".foo"}));
+    assert.eq(0, configDB.changelog.count({what: "moveChunk.commit", ns: dbName + ".foo"}));
+
+    // Every shard owns chunks and has the shard key index.
+    configDB.shards.find().forEach(function(shard) {
+        assert.eq(4, configDB.chunks.count({ns: dbName + ".foo", shard: shard._id}), shard._id);
+
+        var shardConn = new Mongo(shard.host);
+        var indexes = shardConn.getDB(dbName).foo.getIndexes();
+        assert(indexes.some(function(index) {
+            return bsonWoCompare(index.key, {x: 1}) === 0;
+        }),
+               "shard key index missing on " + shard._id + ": " + tojson(indexes));
+    });
+
+    // Inserts across the key space are accepted by all the shards.
+    var bulk = testDB.foo.initializeUnorderedBulkOp();
+    for (var x = 0; x < 1200; x++) {
+        bulk.insert({x: x});
+    }
+    assert.writeOK(bulk.execute());
+    assert.eq(1200, testDB.foo.find().itcount());
+
+    // Hashed shard keys are distributed the same way.
+    assert.commandWorked(testDB.adminCommand(
+        {shardCollection: dbName + ".hashed", key: {x: "hashed"}, numInitialChunks: 6}));
+    assert.eq(6, configDB.chunks.count({ns: dbName + ".hashed"}));
+    assert.eq(0, configDB.changelog.count({what: "moveChunk.commit", ns: dbName + ".hashed"}));
+    configDB.shards.find().forEach(function(shard) {
+        assert.eq(2, configDB.chunks.count({ns: dbName + ".hashed", shard: shard._id}), shard._id);
+    });
+
+    // A document inserted directly on the primary shard after the collection was found to be
+    // empty, but before the chunks are created, makes the primary create all the chunks itself.
+    assert.commandWorked(st.s.adminCommand(
+        {configureFailPoint: "hangBeforeCreatingPreSplitChunks", mode: "alwaysOn"}));
+
+    var awaitShardCollection = startParallelShell(function() {
+        assert.commandWorked(db.adminCommand({
+            shardCollection: "test.notEmpty",
+            key: {x: 1},
+            initialSplitPoints: [{x: 100}, {x: 200}]
+        }));
+    }, st.s.port);
+
+    checkLog.contains(st.s, "hangBeforeCreatingPreSplitChunks fail point enabled");
+    assert.writeOK(st.shard1.getDB(dbName).notEmpty.insert({_id: 0, x: 150}));
+
+    assert.commandWorked(
+        st.s.adminCommand({configureFailPoint: "hangBeforeCreatingPreSplitChunks", mode: "off"}));
+    awaitShardCollection();
+
+    assert.eq(3, configDB.chunks.count({ns: dbName + ".notEmpty", shard: "shard0001"}));
+    assert.eq(3, configDB.chunks.count({ns: dbName + ".notEmpty"}));
+    assert.eq([{_id: 0, x: 150}], testDB.notEmpty.find({x: 150}).toArray());
+
+    // Writes from a router which still considers the collection unsharded wait on the primary
+    // shard while the chunks are created, and are then retried on the shards owning the documents.
+    var staleDB = st.s1.getDB(dbName);
+    assert.eq(null, staleDB.race.findOne());
+
+    assert.commandWorked(st.shard1.adminCommand(
+        {configureFailPoint: "hangInShardCollectionCriticalSection", mode: "alwaysOn"}));
+
+    awaitShardCollection = startParallelShell(function() {
+        assert.commandWorked(db.adminCommand({
+            shardCollection: "test.race",
+            key: {x: 1},
+            initialSplitPoints: [{x: 100}, {x: 200}]
+        }));
+    }, st.s.port);
+
+    checkLog.contains(st.shard1, "hangInShardCollectionCriticalSection fail point enabled");
+
+    var awaitInserts = startParallelShell(function() {
+        var bulk = db.getSiblingDB("test").race.initializeOrderedBulkOp();
+        bulk.insert({_id: 0, x: 50});
+        bulk.insert({_id: 1, x: 150});
+        bulk.insert({_id: 2, x: 250});
+        assert.writeOK(bulk.execute());
+    }, st.s1.port);
+
+    assert.soon(function() {
+        return st.shard1.getDB("admin").currentOp({ns: dbName + ".race", op: "insert"}).inprog
+                   .length > 0;
+    });
+    assert.eq(0, st.shard1.getDB(dbName).race.count());
+
+    assert.commandWorked(st.shard1.adminCommand(
+        {configureFailPoint: "hangInShardCollectionCriticalSection", mode: "off"}));
+    awaitShardCollection();
+    awaitInserts();
+
+    // The chunks are assigned round-robin, so each shard owns one of the documents.
+    assert.eq(3, configDB.chunks.count({ns: dbName + ".race"}));
+    assert.eq(0, configDB.changelog.count({what: "moveChunk.commit", ns: dbName + ".race"}));
+    [st.shard0, st.shard1, st.shard2].forEach(function(shardConn, i) {
+        assert.eq([{_id: i, x: 50 + 100 * i}],
+                  shardConn.getDB(dbName).race.find().toArray(),
+                  "shard" + i);
+    });
+    assert.eq(3, testDB.race.find().itcount());
+
+    st.stop();
+})();
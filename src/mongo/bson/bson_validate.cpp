@@ -36,8 +36,14 @@
 #include "mongo/bson/oid.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/server_parameters.h"
+#include "mongo/platform/bits.h"
 #include "mongo/platform/decimal128.h"
 
+#if defined(_M_AMD64) || defined(__amd64__)
+#include <emmintrin.h>
+#define MONGO_BSON_VALIDATE_HAVE_SSE2
+#endif
+
 namespace mongo {
 
 namespace {
@@ -66,6 +72,26 @@ Status NOINLINE_DECL makeError(StringData baseMsg, BSONElement idElem, StringDat
     return Status(ErrorCodes::InvalidBSON, msg);
 }
 
+/**
+ * Returns a pointer to the first NUL byte in [begin, end), or nullptr if there is none.
+ *
+ * Field names and regex strings are almost always short, so the per-call setup of memchr
+ * dominates the scan. On x86_64 the first 64 bytes are checked 16 at a time with SSE2 (which
+ * every x86_64 target has) before deferring to memchr for long strings and the unaligned tail.
+ */
+inline const char* findNulByte(const char* begin, const char* end) {
+#if defined(MONGO_BSON_VALIDATE_HAVE_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    for (int i = 0; i < 4 && end - begin >= 16; ++i, begin += 16) {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+        const uint32_t mask = _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, zero));
+        if (mask)
+            return begin + countTrailingZeros64(mask);
+    }
+#endif
+    return static_cast<const char*>(memchr(begin, 0, end - begin));
+}
+
 class Buffer {
 public:
     Buffer(const char* buffer, uint64_t maxLength, BSONVersion version)
@@ -88,10 +114,10 @@ public:
      * reading, if it exists. Otherwise, it should be empty.
      */
     Status readCString(StringData elemName, StringData* out) {
-        const void* x = memchr(_buffer + _position, 0, _maxLength - _position);
+        const char* x = findNulByte(_buffer + _position, _buffer + _maxLength);
         if (!x)
             return makeError("no end of c-string", _idElem, elemName);
-        uint64_t len = static_cast<uint64_t>(static_cast<const char*>(x) - (_buffer + _position));
+        uint64_t len = static_cast<uint64_t>(x - (_buffer + _position));
 
         StringData data(_buffer + _position, len);
         _position += len + 1;
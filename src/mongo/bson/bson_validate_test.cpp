@@ -193,6 +193,30 @@ TEST(BSONValidate, Fuzz) {
     }
 }
 
+TEST(BSONValidate, FieldNamesAcrossVectorBoundaries) {
+    // Field names are scanned in 16 byte blocks, so vary both the name length and its offset
+    // within the buffer and check every truncation of the document is rejected.
+    for (size_t padLength = 0; padLength < 16; ++padLength) {
+        for (size_t nameLength = 0; nameLength < 80; ++nameLength) {
+            const std::string name(nameLength, 'f');
+            BSONObj obj = BSON("p" << std::string(padLength, 'x') << name << 1 << "r"
+                                   << BSONRegEx(name, "i"));
+
+            ASSERT_OK(validateBSON(obj.objdata(), obj.objsize(), BSONVersion::kLatest));
+            for (int maxLength = 0; maxLength < obj.objsize(); ++maxLength) {
+                ASSERT_NOT_OK(validateBSON(obj.objdata(), maxLength, BSONVersion::kLatest));
+            }
+
+            // Drop the terminator of the field name; the scan must run on to the next NUL.
+            BSONObj mine = obj.copy();
+            char* data = const_cast<char*>(mine.objdata());
+            BSONElement elem = mine.getField(name);
+            data[elem.fieldName() - mine.objdata() + nameLength] = 'f';
+            ASSERT_NOT_OK(validateBSON(mine.objdata(), mine.objsize(), BSONVersion::kLatest));
+        }
+    }
+}
+
 TEST(BSONValidateFast, Empty) {
     BSONObj x;
     ASSERT_OK(validateBSON(x.objdata(), x.objsize(), BSONVersion::kLatest));
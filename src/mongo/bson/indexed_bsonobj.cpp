@@ -0,0 +1,117 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/indexed_bsonobj.h"
+
+namespace mongo {
+
+const size_t IndexedBSONObj::kMinFieldsToIndex;
+const size_t IndexedBSONObj::kMinLookupsToIndex;
+
+uint32_t IndexedBSONObj::_hashFieldName(StringData name) {
+    // FNV-1a. Field names are short, so a simple byte-at-a-time hash is cheaper than anything
+    // which needs setup.
+    uint32_t hash = 2166136261U;
+    for (char c : name) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 16777619U;
+    }
+    return hash;
+}
+
+void IndexedBSONObj::_buildIndex() const {
+    _indexBuildAttempted = true;
+
+    std::vector<uint32_t> offsets;
+    for (auto&& elem : _obj) {
+        offsets.push_back(static_cast<uint32_t>(elem.rawdata() - _obj.objdata()));
+    }
+
+    if (offsets.size() < kMinFieldsToIndex) {
+        return;
+    }
+
+    size_t numSlots = 1;
+    while (numSlots < offsets.size() * 2) {
+        numSlots <<= 1;
+    }
+    const size_t mask = numSlots - 1;
+
+    std::vector<Slot> slots(numSlots);
+    for (uint32_t offset : offsets) {
+        const StringData name = BSONElement(_obj.objdata() + offset).fieldNameStringData();
+        const uint32_t hash = _hashFieldName(name);
+
+        size_t i = hash & mask;
+        bool duplicate = false;
+        while (slots[i].offset != 0) {
+            if (slots[i].hash == hash &&
+                BSONElement(_obj.objdata() + slots[i].offset).fieldNameStringData() == name) {
+                duplicate = true;
+                break;
+            }
+            i = (i + 1) & mask;
+        }
+
+        // Elements are inserted in document order, so keeping the existing slot for a duplicate
+        // name matches BSONObj::getField returning the first occurrence.
+        if (!duplicate) {
+            slots[i].offset = offset;
+            slots[i].hash = hash;
+        }
+    }
+
+    _slots = std::move(slots);
+}
+
+BSONElement IndexedBSONObj::getField(StringData name) const {
+    if (!_indexBuildAttempted) {
+        _buildIndex();
+    }
+
+    if (_slots.empty()) {
+        return _obj.getField(name);
+    }
+
+    const uint32_t hash = _hashFieldName(name);
+    const size_t mask = _slots.size() - 1;
+    for (size_t i = hash & mask; _slots[i].offset != 0; i = (i + 1) & mask) {
+        if (_slots[i].hash != hash) {
+            continue;
+        }
+        BSONElement elem(_obj.objdata() + _slots[i].offset);
+        if (elem.fieldNameStringData() == name) {
+            return elem;
+        }
+    }
+    return BSONElement();
+}
+
+}  // namespace mongo
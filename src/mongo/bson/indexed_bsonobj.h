@@ -0,0 +1,117 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonelement.h"
+#include "mongo/bson/bsonobj.h"
+
+namespace mongo {
+
+/**
+ * A read-only view of a BSONObj for code which looks up many top-level fields of the same
+ * document.
+ *
+ * BSONObj::getField is a linear scan, so each lookup on a wide document walks the elements again.
+ * The caller says up front how many lookups it expects to make. If that is at least
+ * kMinLookupsToIndex and the object has at least kMinFieldsToIndex top-level fields, the first
+ * lookup builds a small open-addressing hash table from field name to element offset, and every
+ * lookup then costs a hash and a probe. Otherwise building the table would cost more than it
+ * saves, and every lookup is the same linear scan as BSONObj::getField. Results are the same as
+ * BSONObj::getField: when a field name is duplicated, the first occurrence wins.
+ *
+ * The view does not own or copy the object, so the object must outlive it. It is not safe for
+ * concurrent use and is intended to live on the stack for the duration of one operation.
+ */
+class IndexedBSONObj {
+    MONGO_DISALLOW_COPYING(IndexedBSONObj);
+
+public:
+    /**
+     * Objects with fewer top-level fields than this are always scanned linearly.
+     */
+    static const size_t kMinFieldsToIndex = 16;
+
+    /**
+     * Building the table costs about as much as a few linear scans, so views which expect fewer
+     * lookups than this are always scanned linearly.
+     */
+    static const size_t kMinLookupsToIndex = 4;
+
+    IndexedBSONObj(const BSONObj& obj, size_t expectedLookups)
+        : _obj(obj), _indexBuildAttempted(expectedLookups < kMinLookupsToIndex) {}
+
+    const BSONObj& obj() const {
+        return _obj;
+    }
+
+    /**
+     * Returns the first top-level element named 'name', or an EOO element if there is none.
+     */
+    BSONElement getField(StringData name) const;
+
+    BSONElement operator[](StringData name) const {
+        return getField(name);
+    }
+
+    bool hasField(StringData name) const {
+        return !getField(name).eoo();
+    }
+
+    /**
+     * Returns true once the hash table has been built. Exposed for testing.
+     */
+    bool isIndexed() const {
+        return !_slots.empty();
+    }
+
+private:
+    struct Slot {
+        uint32_t offset = 0;  // Offset of the element from objdata(). Zero marks an empty slot.
+        uint32_t hash = 0;
+    };
+
+    static uint32_t _hashFieldName(StringData name);
+
+    void _buildIndex() const;
+
+    const BSONObj& _obj;
+
+    mutable bool _indexBuildAttempted;
+
+    // Open-addressing table with linear probing. The size is a power of two and at least twice the
+    // number of fields, so probe sequences stay short and always reach an empty slot.
+    mutable std::vector<Slot> _slots;
+};
+
+}  // namespace mongo
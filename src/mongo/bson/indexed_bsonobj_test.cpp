@@ -0,0 +1,111 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/indexed_bsonobj.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+BSONObj makeWideObj(int numFields) {
+    BSONObjBuilder bob;
+    for (int i = 0; i < numFields; ++i) {
+        bob.append(str::stream() << "field" << i, i);
+    }
+    return bob.obj();
+}
+
+TEST(IndexedBSONObjTest, NarrowObjectIsNotIndexed) {
+    BSONObj obj = makeWideObj(IndexedBSONObj::kMinFieldsToIndex - 1);
+    IndexedBSONObj indexed(obj, 100);
+    ASSERT_EQ(0, indexed["field0"].numberInt());
+    ASSERT_EQ(3, indexed["field3"].numberInt());
+    ASSERT_FALSE(indexed.isIndexed());
+    ASSERT_TRUE(indexed["missing"].eoo());
+}
+
+TEST(IndexedBSONObjTest, FewExpectedLookupsAreNotIndexed) {
+    BSONObj obj = makeWideObj(200);
+    IndexedBSONObj indexed(obj, IndexedBSONObj::kMinLookupsToIndex - 1);
+
+    for (int i = 0; i < 200; ++i) {
+        const std::string name = str::stream() << "field" << i;
+        ASSERT_EQ(i, indexed[name].numberInt());
+    }
+    ASSERT_FALSE(indexed.isIndexed());
+    ASSERT_TRUE(indexed["field200"].eoo());
+}
+
+TEST(IndexedBSONObjTest, IndexIsBuiltOnFirstLookup) {
+    BSONObj obj = makeWideObj(200);
+    IndexedBSONObj indexed(obj, IndexedBSONObj::kMinLookupsToIndex);
+    ASSERT_FALSE(indexed.isIndexed());
+
+    ASSERT_EQ(150, indexed["field150"].numberInt());
+    ASSERT_TRUE(indexed.isIndexed());
+
+    for (int i = 0; i < 200; ++i) {
+        const std::string name = str::stream() << "field" << i;
+        BSONElement elem = indexed.getField(name);
+        ASSERT_EQ(obj.getField(name).rawdata(), elem.rawdata());
+        ASSERT_EQ(i, elem.numberInt());
+    }
+
+    ASSERT_TRUE(indexed["field200"].eoo());
+    ASSERT_FALSE(indexed.hasField(""));
+    ASSERT_FALSE(indexed.hasField("field1.x"));
+}
+
+TEST(IndexedBSONObjTest, DuplicateFieldNamesReturnFirstOccurrence) {
+    BSONObjBuilder bob;
+    bob.appendElements(makeWideObj(20));
+    bob.append("dup", 1);
+    bob.append("dup", 2);
+    bob.append("", 3);
+    BSONObj obj = bob.obj();
+
+    IndexedBSONObj indexed(obj, 10);
+    ASSERT_EQ(1, indexed["dup"].numberInt());
+    ASSERT_EQ(1, indexed["dup"].numberInt());
+    ASSERT_TRUE(indexed.isIndexed());
+    ASSERT_EQ(3, indexed[""].numberInt());
+}
+
+TEST(IndexedBSONObjTest, EmptyObject) {
+    BSONObj obj;
+    IndexedBSONObj indexed(obj, 10);
+    ASSERT_TRUE(indexed["a"].eoo());
+    ASSERT_TRUE(indexed["a"].eoo());
+    ASSERT_FALSE(indexed.isIndexed());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,95 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/util/builder.h"
+
+#include "mongo/base/init.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/util/concurrency/threadlocal.h"
+
+namespace mongo {
+
+namespace {
+MONGO_TRIVIALLY_CONSTRUCTIBLE_THREAD_LOCAL long long bufBuilderHeapAllocations;
+
+/// This flag indicates whether the per-thread cache of ScratchBufBuilder buffers is initialized
+/// and ready for use. Until this flag is true, ScratchBufBuilder instances must not use the cache.
+bool isThreadScratchBufferCacheInitialized = false;
+
+MONGO_INITIALIZER(ScratchBufBuilder)(InitializerContext*) {
+    isThreadScratchBufferCacheInitialized = true;
+    return Status::OK();
+}
+}  // namespace
+
+TSP_DECLARE(std::unique_ptr<BufBuilder>, threadScratchBufferCache);
+TSP_DEFINE(std::unique_ptr<BufBuilder>, threadScratchBufferCache);
+
+namespace {
+// During unittests, where we don't use quickExit(), static finalization may destroy the
+// cache before its last use, so mark it as not initialized in that case.
+// This must be after the TSP_DEFINE so that it is destroyed first.
+struct ThreadScratchBufferCacheFinalizer {
+    ~ThreadScratchBufferCacheFinalizer() {
+        isThreadScratchBufferCacheInitialized = false;
+    }
+} threadScratchBufferCacheFinalizer;
+}  // namespace
+
+const int ScratchBufBuilder::kMaxCachedSize;
+
+ScratchBufBuilder::ScratchBufBuilder() {
+    if (isThreadScratchBufferCacheInitialized && threadScratchBufferCache.getMake()->get()) {
+        _builder = std::move(*threadScratchBufferCache.get());
+    } else {
+        _builder = stdx::make_unique<BufBuilder>();
+    }
+}
+
+ScratchBufBuilder::~ScratchBufBuilder() {
+    if (_builder->getSize() > kMaxCachedSize) {
+        return;
+    }
+
+    _builder->reset();
+    if (isThreadScratchBufferCacheInitialized && !threadScratchBufferCache.getMake()->get()) {
+        *threadScratchBufferCache.get() = std::move(_builder);
+    }
+}
+
+void noteBufBuilderHeapAllocation() {
+    ++bufBuilderHeapAllocations;
+}
+
+long long getBufBuilderHeapAllocations() {
+    return bufBuilderHeapAllocations;
+}
+
+}  // namespace mongo
@@ -31,6 +31,7 @@
 
 #include <cfloat>
 #include <cstdint>
+#include <memory>
 #include <sstream>
 #include <stdio.h>
 #include <string.h>
@@ -73,6 +74,18 @@ const int BufferMaxSize = 64 * 1024 * 1024;
 template <typename Allocator>
 class StringBuilderImpl;
 
+/**
+ * Records that a BufBuilder buffer went to the heap on the current thread, either for its initial
+ * allocation or to grow. Lets CurOp attribute builder allocations to the operation which caused
+ * them; see OpDebug::bufBuilderAllocations.
+ */
+void noteBufBuilderHeapAllocation();
+
+/**
+ * Returns the number of BufBuilder heap allocations made so far on the current thread.
+ */
+long long getBufBuilderHeapAllocations();
+
 class SharedBufferAllocator {
     MONGO_DISALLOW_COPYING(SharedBufferAllocator);
 
@@ -80,9 +93,11 @@ public:
     SharedBufferAllocator() = default;
 
     void malloc(size_t sz) {
+        noteBufBuilderHeapAllocation();
         _buf = SharedBuffer::allocate(sz);
     }
     void realloc(size_t sz) {
+        noteBufBuilderHeapAllocation();
         _buf.realloc(sz);
     }
     void free() {
@@ -108,16 +123,20 @@ public:
 
     enum { SZ = 512 };
     void malloc(size_t sz) {
-        if (sz > SZ)
+        if (sz > SZ) {
+            noteBufBuilderHeapAllocation();
             _ptr = mongoMalloc(sz);
+        }
     }
     void realloc(size_t sz) {
         if (_ptr == _buf) {
             if (sz > SZ) {
+                noteBufBuilderHeapAllocation();
                 _ptr = mongoMalloc(sz);
                 memcpy(_ptr, _buf, SZ);
             }
         } else {
+            noteBufBuilderHeapAllocation();
             _ptr = mongoRealloc(_ptr, sz);
         }
     }
@@ -356,6 +375,34 @@ public:
     void release() = delete;  // not allowed. not implemented.
 };
 
+/**
+ * Lends out a BufBuilder for short-lived data which is copied elsewhere before the
+ * ScratchBufBuilder goes out of scope, such as the frame of an oplog entry or the metadata of a
+ * command reply. Unlike StackBufBuilder it can back a BSONObjBuilder.
+ *
+ * The buffer is cached per thread and reused, so once it has grown to fit what is built in it,
+ * building does not go to the heap. A ScratchBufBuilder created while another one is in scope on
+ * the same thread gets a new buffer. A BSONObj built with BSONObjBuilder::done() in the buffer is
+ * only valid while the ScratchBufBuilder is in scope.
+ */
+class ScratchBufBuilder {
+    MONGO_DISALLOW_COPYING(ScratchBufBuilder);
+
+public:
+    // Buffers which have grown past this size are freed rather than cached for the next use.
+    static const int kMaxCachedSize = 64 * 1024;
+
+    ScratchBufBuilder();
+    ~ScratchBufBuilder();
+
+    BufBuilder& get() {
+        return *_builder;
+    }
+
+private:
+    std::unique_ptr<BufBuilder> _builder;
+};
+
 /** std::stringstream deals with locale so this is a lot faster than std::stringstream for UTF8 */
 template <typename Allocator>
 class StringBuilderImpl {
@@ -76,4 +76,62 @@ TEST(Builder, BooleanOstreamOperator) {
     sb << "{abc: " << true << ", def: " << false << "}";
     ASSERT_EQUALS("{abc: 1, def: 0}", sb.str());
 }
+
+TEST(Builder, HeapAllocationsAreCounted) {
+    const long long start = getBufBuilderHeapAllocations();
+    {
+        StackBufBuilder sbb;
+        sbb.appendStr("fits on the stack");
+    }
+    ASSERT_EQUALS(start, getBufBuilderHeapAllocations());
+
+    {
+        BufBuilder bb;
+        bb.appendStr("initial allocation");
+        ASSERT_EQUALS(start + 1, getBufBuilderHeapAllocations());
+
+        bb.skip(1024);
+        ASSERT_EQUALS(start + 2, getBufBuilderHeapAllocations());
+    }
+
+    {
+        StackBufBuilder sbb;
+        sbb.skip(StackAllocator::SZ + 1);
+        ASSERT_EQUALS(start + 3, getBufBuilderHeapAllocations());
+    }
+}
+
+TEST(Builder, ScratchBufBuilderReusesItsBuffer) {
+    {
+        ScratchBufBuilder warmUp;
+        warmUp.get().skip(1024);
+    }
+
+    const long long start = getBufBuilderHeapAllocations();
+    {
+        ScratchBufBuilder scratch;
+        ASSERT_EQUALS(0, scratch.get().len());
+        scratch.get().skip(1024);
+    }
+    ASSERT_EQUALS(start, getBufBuilderHeapAllocations());
+
+    // A nested ScratchBufBuilder cannot share the cached buffer.
+    {
+        ScratchBufBuilder outer;
+        ScratchBufBuilder inner;
+        ASSERT_NOT_EQUALS(static_cast<const void*>(outer.get().buf()),
+                          static_cast<const void*>(inner.get().buf()));
+        ASSERT_EQUALS(start + 1, getBufBuilderHeapAllocations());
+    }
+
+    // A buffer which grew too large is not kept.
+    {
+        ScratchBufBuilder scratch;
+        scratch.get().skip(ScratchBufBuilder::kMaxCachedSize + 1);
+    }
+    {
+        ScratchBufBuilder scratch;
+        ASSERT_LESS_THAN_OR_EQUALS(scratch.get().getSize(), ScratchBufBuilder::kMaxCachedSize);
+    }
+}
 }
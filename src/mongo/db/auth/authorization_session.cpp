@@ -286,6 +286,11 @@ Status AuthorizationSession::checkAuthForAggregate(const NamespaceString& ns,
         } else if (str::equals("$collStats", firstPipelineStage.firstElementFieldName())) {
             Privilege::addPrivilegeToPrivilegeVector(
                 &privileges, Privilege(inputResource, ActionType::collStats));
+        } else if (str::equals("$queryShapeStats", firstPipelineStage.firstElementFieldName())) {
+            // Query shapes include the values of the first query seen with each shape, like the
+            // plan cache does.
+            Privilege::addPrivilegeToPrivilegeVector(
+                &privileges, Privilege(inputResource, ActionType::planCacheRead));
         } else {
             // If no source requiring an alternative permission scheme is specified then default to
             // requiring find() privileges on the given namespace.
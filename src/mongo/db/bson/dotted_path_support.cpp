@@ -37,6 +37,7 @@
 #include "mongo/bson/bsonmisc.h"
 #include "mongo/bson/bsonobj.h"
 #include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/bson/indexed_bsonobj.h"
 
 namespace mongo {
 namespace dotted_path_support {
@@ -185,12 +186,16 @@ BSONObj extractElementsBasedOnTemplate(const BSONObj& obj,
                                        bool useNullIfMissing) {
     // scanandorder.h can make a zillion of these, so we start the allocation very small.
     BSONObjBuilder b(32);
+    // Wide templates look up many fields of the same object, so index its top-level fields.
+    IndexedBSONObj indexedObj(obj, pattern.nFields());
     BSONObjIterator i(pattern);
     while (i.moreWithEOO()) {
         BSONElement e = i.next();
         if (e.eoo())
             break;
-        BSONElement x = extractElementAtPath(obj, e.fieldName());
+        BSONElement x = indexedObj.getField(e.fieldNameStringData());
+        if (x.eoo() && strchr(e.fieldName(), '.'))
+            x = extractElementAtPath(obj, e.fieldName());
         if (!x.eoo())
             b.appendAs(x, e.fieldName());
         else if (useNullIfMissing)
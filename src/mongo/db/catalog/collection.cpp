@@ -306,6 +306,7 @@ Status Collection::checkValidation(OperationContext* txn, const BSONObj& documen
     if (documentValidationDisabled(txn))
         return Status::OK();
 
+    WritePhaseTimer validationTimer(txn, WritePhase::kValidation);
     if (_validator->matchesBSON(document))
         return Status::OK();
 
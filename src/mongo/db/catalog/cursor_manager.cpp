@@ -323,24 +323,39 @@ CursorManager::~CursorManager() {
     globalCursorIdCache->destroyed(_collectionCacheRuntimeId, _nss.ns());
 }
 
+CursorManager::Partition& CursorManager::_partitionForCursor(CursorId id) {
+    // The low half of a cursor id is random, so it spreads cursors evenly over the partitions.
+    return _partitions[static_cast<uint32_t>(id) % kNumPartitions];
+}
+
+CursorManager::Partition& CursorManager::_partitionForExecutor(PlanExecutor* exec) {
+    // Drop the low bits, which are the same for every executor because of allocation alignment.
+    const uintptr_t address = reinterpret_cast<uintptr_t>(exec);
+    return _partitions[(address >> 6) % kNumPartitions];
+}
+
 void CursorManager::invalidateAll(bool collectionGoingAway, const std::string& reason) {
+    fassert(28819, !BackgroundOperation::inProgForNs(_nss));
+
     vector<ClientCursor*> toDelete;
 
-    {
-        stdx::lock_guard<SimpleMutex> lk(_mutex);
-        fassert(28819, !BackgroundOperation::inProgForNs(_nss));
+    for (auto&& partition : _partitions) {
+        stdx::lock_guard<SimpleMutex> lk(partition.mutex);
 
-        for (ExecSet::iterator it = _nonCachedExecutors.begin(); it != _nonCachedExecutors.end();
+        for (ExecSet::iterator it = partition.nonCachedExecutors.begin();
+             it != partition.nonCachedExecutors.end();
              ++it) {
             // we kill the executor, but it deletes itself
             PlanExecutor* exec = *it;
             exec->kill(reason);
         }
-        _nonCachedExecutors.clear();
+        partition.nonCachedExecutors.clear();
 
         if (collectionGoingAway) {
             // we're going to wipe out the world
-            for (CursorMap::const_iterator i = _cursors.begin(); i != _cursors.end(); ++i) {
+            for (CursorMap::const_iterator i = partition.cursors.begin();
+                 i != partition.cursors.end();
+                 ++i) {
                 ClientCursor* cc = i->second;
 
                 cc->kill();
@@ -359,7 +374,9 @@ void CursorManager::invalidateAll(bool collectionGoingAway, const std::string& r
             CursorMap newMap;
 
             // collection will still be around, just all PlanExecutors are invalid
-            for (CursorMap::const_iterator i = _cursors.begin(); i != _cursors.end(); ++i) {
+            for (CursorMap::const_iterator i = partition.cursors.begin();
+                 i != partition.cursors.end();
+                 ++i) {
                 ClientCursor* cc = i->second;
 
                 // Note that a valid ClientCursor state is "no cursor no executor."  This is because
@@ -384,14 +401,15 @@ void CursorManager::invalidateAll(bool collectionGoingAway, const std::string& r
                 }
             }
 
-            _cursors = newMap;
+            partition.cursors = newMap;
         }
     }
 
-    // ClientCursors must be destroyed without holding '_mutex'. This is because the destruction of
-    // a ClientCursor may itself require accessing another CursorManager (e.g. when deregistering a
-    // non-cached PlanExecutor from a $lookup stage). We won't access this CursorManger when
-    // destroying a ClientCursor because we've already killed all of its non-cached PlanExecutors.
+    // ClientCursors must be destroyed without holding a partition mutex. This is because the
+    // destruction of a ClientCursor may itself require accessing another CursorManager (e.g. when
+    // deregistering a non-cached PlanExecutor from a $lookup stage). We won't access this
+    // CursorManger when destroying a ClientCursor because we've already killed all of its
+    // non-cached PlanExecutors.
     for (auto* cursor : toDelete) {
         delete cursor;
     }
@@ -406,45 +424,51 @@ void CursorManager::invalidateDocument(OperationContext* txn,
         return;
     }
 
-    stdx::lock_guard<SimpleMutex> lk(_mutex);
-
-    for (ExecSet::iterator it = _nonCachedExecutors.begin(); it != _nonCachedExecutors.end();
-         ++it) {
-        PlanExecutor* exec = *it;
-        exec->invalidate(txn, dl, type);
-    }
+    for (auto&& partition : _partitions) {
+        stdx::lock_guard<SimpleMutex> lk(partition.mutex);
 
-    for (CursorMap::const_iterator i = _cursors.begin(); i != _cursors.end(); ++i) {
-        PlanExecutor* exec = i->second->getExecutor();
-        if (exec) {
+        for (ExecSet::iterator it = partition.nonCachedExecutors.begin();
+             it != partition.nonCachedExecutors.end();
+             ++it) {
+            PlanExecutor* exec = *it;
             exec->invalidate(txn, dl, type);
         }
+
+        for (CursorMap::const_iterator i = partition.cursors.begin(); i != partition.cursors.end();
+             ++i) {
+            PlanExecutor* exec = i->second->getExecutor();
+            if (exec) {
+                exec->invalidate(txn, dl, type);
+            }
+        }
     }
 }
 
 std::size_t CursorManager::timeoutCursors(int millisSinceLastCall) {
     vector<ClientCursor*> toDelete;
 
-    {
-        stdx::lock_guard<SimpleMutex> lk(_mutex);
+    for (auto&& partition : _partitions) {
+        stdx::lock_guard<SimpleMutex> lk(partition.mutex);
 
-        for (CursorMap::const_iterator i = _cursors.begin(); i != _cursors.end(); ++i) {
+        const size_t firstToDelete = toDelete.size();
+        for (CursorMap::const_iterator i = partition.cursors.begin(); i != partition.cursors.end();
+             ++i) {
             ClientCursor* cc = i->second;
             // shouldTimeout() ensures that we skip pinned cursors.
             if (cc->shouldTimeout(millisSinceLastCall))
                 toDelete.push_back(cc);
         }
 
-        for (vector<ClientCursor*>::const_iterator i = toDelete.begin(); i != toDelete.end(); ++i) {
-            ClientCursor* cc = *i;
-            _deregisterCursor_inlock(cc);
+        for (size_t i = firstToDelete; i < toDelete.size(); ++i) {
+            ClientCursor* cc = toDelete[i];
+            _deregisterCursor_inlock(&partition, cc);
             cc->kill();
         }
     }
 
-    // ClientCursors must be destroyed without holding '_mutex'. This is because the destruction of
-    // a ClientCursor may itself require accessing this CursorManager (e.g. when deregistering a
-    // non-cached PlanExecutor).
+    // ClientCursors must be destroyed without holding a partition mutex. This is because the
+    // destruction of a ClientCursor may itself require accessing this CursorManager (e.g. when
+    // deregistering a non-cached PlanExecutor).
     for (auto* cursor : toDelete) {
         delete cursor;
     }
@@ -453,20 +477,23 @@ std::size_t CursorManager::timeoutCursors(int millisSinceLastCall) {
 }
 
 void CursorManager::registerExecutor(PlanExecutor* exec) {
-    stdx::lock_guard<SimpleMutex> lk(_mutex);
-    const std::pair<ExecSet::iterator, bool> result = _nonCachedExecutors.insert(exec);
+    Partition& partition = _partitionForExecutor(exec);
+    stdx::lock_guard<SimpleMutex> lk(partition.mutex);
+    const std::pair<ExecSet::iterator, bool> result = partition.nonCachedExecutors.insert(exec);
     invariant(result.second);  // make sure this was inserted
 }
 
 void CursorManager::deregisterExecutor(PlanExecutor* exec) {
-    stdx::lock_guard<SimpleMutex> lk(_mutex);
-    _nonCachedExecutors.erase(exec);
+    Partition& partition = _partitionForExecutor(exec);
+    stdx::lock_guard<SimpleMutex> lk(partition.mutex);
+    partition.nonCachedExecutors.erase(exec);
 }
 
 StatusWith<ClientCursorPin> CursorManager::pinCursor(CursorId id) {
-    stdx::lock_guard<SimpleMutex> lk(_mutex);
-    CursorMap::const_iterator it = _cursors.find(id);
-    if (it == _cursors.end()) {
+    Partition& partition = _partitionForCursor(id);
+    stdx::lock_guard<SimpleMutex> lk(partition.mutex);
+    CursorMap::const_iterator it = partition.cursors.find(id);
+    if (it == partition.cursors.end()) {
         return {ErrorCodes::CursorNotFound, str::stream() << "cursor id " << id << " not found"};
     }
 
@@ -477,7 +504,8 @@ StatusWith<ClientCursorPin> CursorManager::pinCursor(CursorId id) {
 }
 
 void CursorManager::unpin(ClientCursor* cursor) {
-    stdx::lock_guard<SimpleMutex> lk(_mutex);
+    Partition& partition = _partitionForCursor(cursor->cursorid());
+    stdx::lock_guard<SimpleMutex> lk(partition.mutex);
 
     invariant(cursor->_isPinned);
     cursor->_isPinned = false;
@@ -488,69 +516,79 @@ bool CursorManager::ownsCursorId(CursorId cursorId) const {
 }
 
 void CursorManager::getCursorIds(std::set<CursorId>* openCursors) const {
-    stdx::lock_guard<SimpleMutex> lk(_mutex);
+    for (auto&& partition : _partitions) {
+        stdx::lock_guard<SimpleMutex> lk(partition.mutex);
 
-    for (CursorMap::const_iterator i = _cursors.begin(); i != _cursors.end(); ++i) {
-        ClientCursor* cc = i->second;
-        openCursors->insert(cc->cursorid());
+        for (CursorMap::const_iterator i = partition.cursors.begin(); i != partition.cursors.end();
+             ++i) {
+            ClientCursor* cc = i->second;
+            openCursors->insert(cc->cursorid());
+        }
     }
 }
 
 size_t CursorManager::numCursors() const {
-    stdx::lock_guard<SimpleMutex> lk(_mutex);
-    return _cursors.size();
+    size_t count = 0;
+    for (auto&& partition : _partitions) {
+        stdx::lock_guard<SimpleMutex> lk(partition.mutex);
+        count += partition.cursors.size();
+    }
+    return count;
 }
 
-CursorId CursorManager::_allocateCursorId_inlock() {
-    for (int i = 0; i < 10000; i++) {
-        unsigned mypart = static_cast<unsigned>(_random->nextInt32());
-        CursorId id = cursorIdFromParts(_collectionCacheRuntimeId, mypart);
-        if (_cursors.count(id) == 0)
-            return id;
-    }
-    fassertFailed(17360);
+CursorId CursorManager::_allocateCursorId() {
+    stdx::lock_guard<SimpleMutex> lk(_randomMutex);
+    unsigned mypart = static_cast<unsigned>(_random->nextInt32());
+    return cursorIdFromParts(_collectionCacheRuntimeId, mypart);
 }
 
 ClientCursorPin CursorManager::registerCursor(const ClientCursorParams& cursorParams) {
-    stdx::lock_guard<SimpleMutex> lk(_mutex);
-    CursorId cursorId = _allocateCursorId_inlock();
-    std::unique_ptr<ClientCursor, ClientCursor::Deleter> clientCursor(
-        new ClientCursor(cursorParams, this, cursorId));
-    return _registerCursor_inlock(std::move(clientCursor));
+    return _registerCursor([&](CursorId cursorId) {
+        return new ClientCursor(cursorParams, this, cursorId);
+    });
 }
 
 ClientCursorPin CursorManager::registerRangePreserverCursor(const Collection* collection) {
-    stdx::lock_guard<SimpleMutex> lk(_mutex);
-    CursorId cursorId = _allocateCursorId_inlock();
-    std::unique_ptr<ClientCursor, ClientCursor::Deleter> clientCursor(
-        new ClientCursor(collection, this, cursorId));
-    return _registerCursor_inlock(std::move(clientCursor));
+    return _registerCursor([&](CursorId cursorId) {
+        return new ClientCursor(collection, this, cursorId);
+    });
 }
 
-ClientCursorPin CursorManager::_registerCursor_inlock(
-    std::unique_ptr<ClientCursor, ClientCursor::Deleter> clientCursor) {
-    CursorId cursorId = clientCursor->cursorid();
-    invariant(cursorId);
+ClientCursorPin CursorManager::_registerCursor(
+    const stdx::function<ClientCursor*(CursorId)>& makeCursor) {
+    for (int i = 0; i < 10000; i++) {
+        CursorId cursorId = _allocateCursorId();
+        invariant(cursorId);
+
+        Partition& partition = _partitionForCursor(cursorId);
+        stdx::lock_guard<SimpleMutex> lk(partition.mutex);
+        if (partition.cursors.count(cursorId) > 0) {
+            continue;
+        }
 
-    // Transfer ownership of the cursor to '_cursors'.
-    ClientCursor* unownedCursor = clientCursor.release();
-    _cursors[cursorId] = unownedCursor;
-    return ClientCursorPin(unownedCursor);
+        // Transfer ownership of the cursor to the partition's cursor map.
+        ClientCursor* unownedCursor = makeCursor(cursorId);
+        partition.cursors[cursorId] = unownedCursor;
+        return ClientCursorPin(unownedCursor);
+    }
+    fassertFailed(17360);
 }
 
 void CursorManager::deregisterCursor(ClientCursor* cc) {
-    stdx::lock_guard<SimpleMutex> lk(_mutex);
-    _deregisterCursor_inlock(cc);
+    Partition& partition = _partitionForCursor(cc->cursorid());
+    stdx::lock_guard<SimpleMutex> lk(partition.mutex);
+    _deregisterCursor_inlock(&partition, cc);
 }
 
 Status CursorManager::eraseCursor(OperationContext* txn, CursorId id, bool shouldAudit) {
     ClientCursor* cursor;
 
     {
-        stdx::lock_guard<SimpleMutex> lk(_mutex);
+        Partition& partition = _partitionForCursor(id);
+        stdx::lock_guard<SimpleMutex> lk(partition.mutex);
 
-        CursorMap::iterator it = _cursors.find(id);
-        if (it == _cursors.end()) {
+        CursorMap::iterator it = partition.cursors.find(id);
+        if (it == partition.cursors.end()) {
             if (shouldAudit) {
                 audit::logKillCursorsAuthzCheck(
                     txn->getClient(), _nss, id, ErrorCodes::CursorNotFound);
@@ -574,19 +612,19 @@ Status CursorManager::eraseCursor(OperationContext* txn, CursorId id, bool shoul
         }
 
         cursor->kill();
-        _deregisterCursor_inlock(cursor);
+        _deregisterCursor_inlock(&partition, cursor);
     }
 
-    // ClientCursors must be destroyed without holding '_mutex'. This is because the destruction of
-    // a ClientCursor may itself require accessing this CursorManager (e.g. when deregistering a
-    // non-cached PlanExecutor).
+    // ClientCursors must be destroyed without holding a partition mutex. This is because the
+    // destruction of a ClientCursor may itself require accessing this CursorManager (e.g. when
+    // deregistering a non-cached PlanExecutor).
     delete cursor;
     return Status::OK();
 }
 
-void CursorManager::_deregisterCursor_inlock(ClientCursor* cc) {
+void CursorManager::_deregisterCursor_inlock(Partition* partition, ClientCursor* cc) {
     invariant(cc);
     CursorId id = cc->cursorid();
-    _cursors.erase(id);
+    partition->cursors.erase(id);
 }
 }  // namespace mongo
@@ -30,12 +30,14 @@
 
 #pragma once
 
+#include <array>
 
 #include "mongo/db/clientcursor.h"
 #include "mongo/db/invalidation_type.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/record_id.h"
 #include "mongo/platform/unordered_set.h"
+#include "mongo/stdx/functional.h"
 #include "mongo/util/concurrency/mutex.h"
 
 namespace mongo {
@@ -67,7 +69,11 @@ class PlanExecutor;
  * cursor manager.
  *
  * The CursorManager is internally synchronized; operations on a given collection may call methods
- * concurrently on that collection's CursorManager.
+ * concurrently on that collection's CursorManager. Cursors and registered executors are spread
+ * over a fixed number of partitions, each with its own mutex, so that pinning, unpinning and
+ * yielding on different cursors of a busy collection rarely contend. Cursors are assigned to a
+ * partition by their id and bare executors by their address. Operations which touch every cursor,
+ * such as invalidation and timeouts, visit the partitions one at a time.
  *
  * See clientcursor.h for more information.
  */
@@ -187,10 +193,32 @@ public:
 private:
     friend class ClientCursorPin;
 
-    CursorId _allocateCursorId_inlock();
-    void _deregisterCursor_inlock(ClientCursor* cc);
-    ClientCursorPin _registerCursor_inlock(
-        std::unique_ptr<ClientCursor, ClientCursor::Deleter> clientCursor);
+    typedef unordered_set<PlanExecutor*> ExecSet;
+    typedef std::map<CursorId, ClientCursor*> CursorMap;
+
+    /**
+     * The cursors and bare executors assigned to one partition, along with the mutex which guards
+     * them and the pinned state of the cursors.
+     */
+    struct Partition {
+        mutable SimpleMutex mutex;
+        ExecSet nonCachedExecutors;
+        CursorMap cursors;
+    };
+
+    static const size_t kNumPartitions = 16;
+
+    Partition& _partitionForCursor(CursorId id);
+    Partition& _partitionForExecutor(PlanExecutor* exec);
+
+    CursorId _allocateCursorId();
+    void _deregisterCursor_inlock(Partition* partition, ClientCursor* cc);
+
+    /**
+     * Allocates an unused cursor id and registers the cursor constructed for it by 'makeCursor',
+     * which is called with the lock on the id's partition held.
+     */
+    ClientCursorPin _registerCursor(const stdx::function<ClientCursor*(CursorId)>& makeCursor);
 
     void deregisterCursor(ClientCursor* cc);
 
@@ -198,14 +226,11 @@ private:
 
     NamespaceString _nss;
     unsigned _collectionCacheRuntimeId;
-    std::unique_ptr<PseudoRandom> _random;
 
-    mutable SimpleMutex _mutex;
-
-    typedef unordered_set<PlanExecutor*> ExecSet;
-    ExecSet _nonCachedExecutors;
+    // Guards '_random', which is only used to allocate cursor ids.
+    SimpleMutex _randomMutex;
+    std::unique_ptr<PseudoRandom> _random;
 
-    typedef std::map<CursorId, ClientCursor*> CursorMap;
-    CursorMap _cursors;
+    std::array<Partition, kNumPartitions> _partitions;
 };
 }  // namespace mongo
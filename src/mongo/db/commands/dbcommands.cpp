@@ -1448,7 +1448,9 @@ bool Command::run(OperationContext* txn,
     appendCommandStatus(inPlaceReplyBob, result, errmsg);
     inPlaceReplyBob.doneFast();
 
-    BSONObjBuilder metadataBob;
+    // The metadata is copied into the reply, so it is built in a reused buffer.
+    ScratchBufBuilder metadataBuf;
+    BSONObjBuilder metadataBob(metadataBuf.get());
     appendOpTimeMetadata(txn, request, &metadataBob);
     replyBuilder->setMetadata(metadataBob.done());
 
@@ -1620,7 +1622,8 @@ void mongo::execCommandDatabase(OperationContext* txn,
                 txn, NamespaceString(sce->getns()), sce->getVersionReceived());
         }
 
-        BSONObjBuilder metadataBob;
+        ScratchBufBuilder metadataBuf;
+        BSONObjBuilder metadataBob(metadataBuf.get());
         appendOpTimeMetadata(txn, request, &metadataBob);
 
         Command::generateErrorResponse(txn, replyBuilder, e, request, command, metadataBob.done());
@@ -84,6 +84,25 @@ public:
         help << "explain database reads and writes";
     }
 
+    /**
+     * The namespace of an explain is the namespace of the nested command, so that a shard version
+     * sent along with the explain is checked against the collection being explained.
+     */
+    std::string parseNs(const std::string& dbname, const BSONObj& cmdObj) const override {
+        if (Object != cmdObj.firstElement().type()) {
+            return Command::parseNs(dbname, cmdObj);
+        }
+
+        BSONObj explainObj = cmdObj.firstElement().Obj();
+
+        Command* commToExplain = Command::findCommand(explainObj.firstElementFieldName());
+        if (NULL == commToExplain) {
+            return Command::parseNs(dbname, cmdObj);
+        }
+
+        return commToExplain->parseNs(dbname, explainObj);
+    }
+
     /**
      * You are authorized to run an explain if you are authorized to run
      * the command that you are explaining. The auth check is performed recursively
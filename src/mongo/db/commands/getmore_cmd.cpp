@@ -47,6 +47,7 @@
 #include "mongo/db/query/cursor_response.h"
 #include "mongo/db/query/find.h"
 #include "mongo/db/query/find_common.h"
+#include "mongo/db/query/get_executor.h"
 #include "mongo/db/query/getmore_request.h"
 #include "mongo/db/query/plan_summary_stats.h"
 #include "mongo/db/repl/oplog.h"
@@ -328,6 +329,10 @@ public:
         exec->reattachToOperationContext(txn);
         exec->restoreState();
 
+        if (ctx && ctx->getCollection() && exec->getCanonicalQuery()) {
+            setCurOpQueryShape(txn, ctx->getCollection(), *exec->getCanonicalQuery());
+        }
+
         auto planSummary = Explain::getPlanSummary(exec);
         {
             stdx::lock_guard<Client> lk(*txn->getClient());
@@ -272,9 +272,27 @@ void CurOp::setNS_inlock(StringData ns) {
 void CurOp::ensureStarted() {
     if (_start == 0) {
         _start = curTimeMicros64();
+        _bufBuilderAllocationsAtStart = getBufBuilderHeapAllocations();
+        _cpuTimer.start();
+        _blockInputBytesAtStart = getThreadBlockInputBytes();
+        _allocatedBytesAtStart = getThreadAllocatedBytes();
     }
 }
 
+void CurOp::done() {
+    _end = curTimeMicros64();
+    _debug.bufBuilderAllocations = getBufBuilderHeapAllocations() - _bufBuilderAllocationsAtStart;
+
+    if (!_cpuTimer.isStarted()) {
+        return;
+    }
+    _debug.cpuMicros = _cpuTimer.elapsedMicros();
+    if (_blockInputBytesAtStart >= 0) {
+        _debug.storageBytesRead = getThreadBlockInputBytes() - _blockInputBytesAtStart;
+    }
+    _debug.allocatedBytes = getThreadAllocatedBytes() - _allocatedBytesAtStart;
+}
+
 void CurOp::enter_inlock(const char* ns, int dbProfileLevel) {
     ensureStarted();
     _ns = ns;
@@ -339,6 +357,10 @@ void CurOp::reportState(BSONObjBuilder* builder) {
         builder->append("microsecs_running", static_cast<long long int>(elapsedMicros()));
     }
 
+    if (ThreadCpuTimer::isSupported() && _cpuTimer.isStarted() && !isDone()) {
+        builder->append("cpuMicros", _cpuTimer.elapsedMicros());
+    }
+
     builder->append("op", logicalOpToString(_logicalOp));
     builder->append("ns", _ns);
 
@@ -506,6 +528,28 @@ string OpDebug::report(Client* client,
         s << " writeConflicts:" << writeConflicts;
     }
 
+    if (bufBuilderAllocations > 0) {
+        s << " bufBuilderAllocations:" << bufBuilderAllocations;
+    }
+
+    if (!writePhases.empty()) {
+        BSONObjBuilder phases;
+        writePhases.append(&phases);
+        s << " writePhaseMicros:" << phases.obj().toString();
+    }
+
+    if (cpuMicros > 0) {
+        s << " cpuMicros:" << cpuMicros;
+    }
+
+    if (storageBytesRead > 0) {
+        s << " storageBytesRead:" << storageBytesRead;
+    }
+
+    if (allocatedBytes > 0) {
+        s << " allocatedBytes:" << allocatedBytes;
+    }
+
     if (!exceptionInfo.empty()) {
         s << " exception: " << redact(exceptionInfo.msg);
         if (exceptionInfo.code)
@@ -610,6 +654,27 @@ void OpDebug::append(const CurOp& curop,
         b.appendNumber("writeConflicts", writeConflicts);
     }
 
+    if (bufBuilderAllocations > 0) {
+        b.appendNumber("bufBuilderAllocations", bufBuilderAllocations);
+    }
+
+    if (!writePhases.empty()) {
+        BSONObjBuilder phases(b.subobjStart("writePhaseMicros"));
+        writePhases.append(&phases);
+    }
+
+    if (cpuMicros > 0) {
+        b.appendNumber("cpuMicros", cpuMicros);
+    }
+
+    if (storageBytesRead > 0) {
+        b.appendNumber("storageBytesRead", storageBytesRead);
+    }
+
+    if (allocatedBytes > 0) {
+        b.appendNumber("allocatedBytes", allocatedBytes);
+    }
+
     b.appendNumber("numYield", curop.numYields());
 
     {
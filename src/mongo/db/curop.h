@@ -35,10 +35,13 @@
 #include "mongo/db/commands.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/server_options.h"
+#include "mongo/db/stats/write_phase_latency_histogram.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/util/net/message.h"
 #include "mongo/util/progress_meter.h"
+#include "mongo/util/thread_resource_usage.h"
 #include "mongo/util/time_support.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -117,6 +120,16 @@ public:
     long long keysInserted{0};  // Number of index keys inserted.
     long long keysDeleted{0};   // Number of index keys removed.
     long long writeConflicts{0};
+    long long bufBuilderAllocations{0};  // Heap allocations made by BufBuilders for this op.
+    WritePhaseTimings writePhases;       // Time spent in each phase of the write path.
+    long long cpuMicros{0};              // CPU time used by the thread running this op.
+    long long storageBytesRead{0};       // Bytes read from disk by the thread running this op.
+    long long allocatedBytes{0};         // Bytes allocated, if trackThreadAllocations is set.
+
+    // The plan cache key and shape of the query this op ran, if any. Used to aggregate the op's
+    // statistics by query shape.
+    std::string queryShapeKey;
+    BSONObj queryShape;
 
     BSONObj execStats;  // Owned here.
 
@@ -290,9 +303,7 @@ public:
         ensureStarted();
         return _start;
     }
-    void done() {
-        _end = curTimeMicros64();
-    }
+    void done();
     bool isDone() const {
         return _end > 0;
     }
@@ -431,6 +442,12 @@ private:
     Command* _command{nullptr};
     long long _start{0};
     long long _end{0};
+    long long _bufBuilderAllocationsAtStart{0};
+
+    // Resource usage of the executing thread, measured from ensureStarted() to done().
+    ThreadCpuTimer _cpuTimer;
+    long long _blockInputBytesAtStart{-1};
+    long long _allocatedBytesAtStart{0};
 
     // _networkOp represents the network-level op code: OP_QUERY, OP_GET_MORE, OP_COMMAND, etc.
     NetworkOp _networkOp{opInvalid};  // only set this through setNetworkOp_inlock() to keep synced
@@ -457,4 +474,24 @@ private:
 
     std::string _planSummary;
 };
+
+/**
+ * Adds the time spent in its scope to the given write phase of the OpDebug belonging to the
+ * operation's current CurOp.
+ */
+class WritePhaseTimer {
+    MONGO_DISALLOW_COPYING(WritePhaseTimer);
+
+public:
+    WritePhaseTimer(OperationContext* txn, WritePhase phase) : _txn(txn), _phase(phase) {}
+
+    ~WritePhaseTimer() {
+        CurOp::get(_txn)->debug().writePhases.add(_phase, _timer.micros());
+    }
+
+private:
+    OperationContext* const _txn;
+    const WritePhase _phase;
+    const Timer _timer;
+};
 }  // namespace mongo
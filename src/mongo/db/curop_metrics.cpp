@@ -32,6 +32,7 @@
 #include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/query/query_shape_stats.h"
 
 namespace mongo {
 namespace {
@@ -79,6 +80,19 @@ void recordCurOpMetrics(OperationContext* opCtx) {
         scanAndOrderCounter.increment();
     if (debug.writeConflicts)
         writeConflictsCounter.increment(debug.writeConflicts);
+
+    if (!debug.queryShapeKey.empty()) {
+        const CurOp& curOp = *CurOp::get(opCtx);
+        QueryShapeStats::OperationMetrics metrics;
+        metrics.latencyMicros = debug.executionTimeMicros;
+        metrics.cpuMicros = debug.cpuMicros;
+        metrics.keysExamined = std::max(debug.keysExamined, 0LL);
+        metrics.docsExamined = std::max(debug.docsExamined, 0LL);
+        metrics.nreturned = std::max(debug.nreturned, 0LL);
+        metrics.planSummary = curOp.getPlanSummary().toString();
+        QueryShapeStats::get(opCtx->getServiceContext())
+            .record(curOp.getNS(), debug.queryShapeKey, debug.queryShape, metrics);
+    }
 }
 
 }  // namespace mongo
@@ -216,6 +216,7 @@ PlanStage::StageState DeleteStage::doWork(WorkingSetID* out) {
         try {
             WriteUnitOfWork wunit(getOpCtx());
             _collection->deleteDocument(getOpCtx(), recordId, _params.opDebug, _params.fromMigrate);
+            WritePhaseTimer commitTimer(getOpCtx(), WritePhase::kCommit);
             wunit.commit();
         } catch (const WriteConflictException& wce) {
             memberFreer.Dismiss();  // Keep this member around so we can retry deleting it.
@@ -669,7 +669,7 @@ struct TextMatchStats : public SpecificStats {
 };
 
 struct TextOrStats : public SpecificStats {
-    TextOrStats() : fetches(0) {}
+    TextOrStats() : fetches(0), topK(0), stoppedEarly(false) {}
 
     SpecificStats* clone() const final {
         TextOrStats* specific = new TextOrStats(*this);
@@ -677,6 +677,12 @@ struct TextOrStats : public SpecificStats {
     }
 
     size_t fetches;
+
+    // The number of results the stage was asked for, or zero if it had to read every term.
+    size_t topK;
+
+    // Whether the stage stopped reading the index before exhausting every term.
+    bool stoppedEarly;
 };
 
 }  // namespace mongo
@@ -39,6 +39,7 @@
 #include "mongo/db/fts/fts_index_format.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/query/internal_plans.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/stdx/memory.h"
 
 namespace mongo {
@@ -95,10 +96,25 @@ const SpecificStats* TextStage::getSpecificStats() const {
 unique_ptr<PlanStage> TextStage::buildTextTree(OperationContext* txn,
                                                WorkingSet* ws,
                                                const MatchExpression* filter) const {
-    auto textScorer = make_unique<TextOrStage>(txn, _params.spec, ws, filter, _params.index);
+    // Reading only as much of the index as the top results need relies on every document that
+    // TEXT_OR returns passing the TEXT_MATCH stage, which is only known to hold for queries
+    // without negations or phrases that match terms the same way the index does.
+    const FTSQueryImpl& query = _params.query;
+    const bool canStopEarly = internalQueryExecEnableTextTopK.load() &&
+        query.getNegatedTerms().empty() && query.getPositivePhr().empty() &&
+        query.getNegatedPhr().empty() && !query.getCaseSensitive() &&
+        !query.getDiacriticSensitive();
+
+    auto textScorer = make_unique<TextOrStage>(txn,
+                                               _params.spec,
+                                               ws,
+                                               filter,
+                                               _params.index,
+                                               canStopEarly ? _params.topK : 0,
+                                               query.getTermsForBounds());
 
     // Get all the index scans for each term in our query.
-    for (const auto& term : _params.query.getTermsForBounds()) {
+    for (const auto& term : query.getTermsForBounds()) {
         IndexScanParams ixparams;
 
         ixparams.bounds.startKey = FTSIndexFormat::getIndexKey(
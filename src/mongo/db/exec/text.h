@@ -62,6 +62,10 @@ struct TextStageParams {
 
     // The text query.
     FTSQueryImpl query;
+
+    // If non-zero, only the 'topK' highest scoring documents need to be returned. See
+    // TextOrStage.
+    size_t topK = 0;
 };
 
 /**
@@ -51,6 +51,8 @@ using std::string;
 using stdx::make_unique;
 
 using fts::FTSSpec;
+using fts::MAX_WEIGHT;
+using fts::TermFrequencyMap;
 
 const char* TextOrStage::kStageType = "TEXT_OR";
 
@@ -58,19 +60,28 @@ TextOrStage::TextOrStage(OperationContext* txn,
                          const FTSSpec& ftsSpec,
                          WorkingSet* ws,
                          const MatchExpression* filter,
-                         IndexDescriptor* index)
+                         IndexDescriptor* index,
+                         size_t topK,
+                         std::set<std::string> terms)
     : PlanStage(kStageType, txn),
       _ftsSpec(ftsSpec),
       _ws(ws),
+      _topK(topK),
+      _scoreWholeDocuments(topK > 0),
+      _terms(std::move(terms)),
       _scoreIterator(_scores.end()),
       _filter(filter),
       _idRetrying(WorkingSet::INVALID_ID),
-      _index(index) {}
+      _index(index) {
+    _specificStats.topK = topK;
+}
 
 TextOrStage::~TextOrStage() {}
 
 void TextOrStage::addChild(unique_ptr<PlanStage> child) {
     _children.push_back(std::move(child));
+    _termScoreBounds.push_back(MAX_WEIGHT);
+    _childDone.push_back(false);
 }
 
 bool TextOrStage::isEOF() {
@@ -103,6 +114,11 @@ void TextOrStage::doInvalidate(OperationContext* txn, const RecordId& dl, Invali
     // Remove the RecordID from the ScoreMap.
     ScoreMap::iterator scoreIt = _scores.find(dl);
     if (scoreIt != _scores.end()) {
+        if (scoreIt->second.wsid != WorkingSet::INVALID_ID) {
+            // The document's score may be among '_topScores' but it will not be returned, so
+            // the remaining documents have to be read to find the top results.
+            _topK = 0;
+        }
         if (scoreIt == _scoreIterator) {
             _scoreIterator++;
         }
@@ -192,14 +208,36 @@ PlanStage::StageState TextOrStage::readFromChildren(WorkingSetID* out) {
     }
 
     if (PlanStage::ADVANCED == childState) {
-        return addTerm(id, out);
+        StageState addTermState = addTerm(id, out);
+        if (_scoreWholeDocuments && PlanStage::NEED_TIME == addTermState) {
+            if (haveTopK()) {
+                // No document we have not scored yet can make it into the top results.
+                _specificStats.stoppedEarly = true;
+                _scoreIterator = _scores.begin();
+                _internalState = State::kReturningResults;
+            } else {
+                advanceToNextChild();
+            }
+        }
+        return addTermState;
     } else if (PlanStage::IS_EOF == childState) {
         // Done with this child.
-        ++_currentChild;
+        if (_scoreWholeDocuments) {
+            _childDone[_currentChild] = true;
+            _termScoreBounds[_currentChild] = 0;
+            ++_numChildrenDone;
+
+            if (_numChildrenDone < _children.size()) {
+                advanceToNextChild();
+                return PlanStage::NEED_TIME;
+            }
+        } else {
+            ++_currentChild;
 
-        if (_currentChild < _children.size()) {
-            // We have another child to read from.
-            return PlanStage::NEED_TIME;
+            if (_currentChild < _children.size()) {
+                // We have another child to read from.
+                return PlanStage::NEED_TIME;
+            }
         }
 
         // If we're here we are done reading results.  Move to the next state.
@@ -243,6 +281,12 @@ PlanStage::StageState TextOrStage::returnResults(WorkingSetID* out) {
         return PlanStage::NEED_TIME;
     }
 
+    // In top-k mode, skip documents which score below the lowest of the top results.
+    if (_topK && _topScores.size() >= _topK && textRecordData.score < _topScores.top()) {
+        _ws->free(textRecordData.wsid);
+        return PlanStage::NEED_TIME;
+    }
+
     WorkingSetMember* wsm = _ws->get(textRecordData.wsid);
 
     // Populate the working set member with the text score and return it.
@@ -251,6 +295,39 @@ PlanStage::StageState TextOrStage::returnResults(WorkingSetID* out) {
     return PlanStage::ADVANCED;
 }
 
+double TextOrStage::scoreDocument(const BSONObj& obj) const {
+    TermFrequencyMap termFreqs;
+    _ftsSpec.scoreDocument(obj, &termFreqs);
+
+    double score = 0;
+    for (const auto& term : _terms) {
+        auto it = termFreqs.find(term);
+        if (it != termFreqs.end()) {
+            score += it->second;
+        }
+    }
+    return score;
+}
+
+bool TextOrStage::haveTopK() const {
+    if (!_topK || _topScores.size() < _topK) {
+        return false;
+    }
+
+    double unseenScoreBound = 0;
+    for (double termScoreBound : _termScoreBounds) {
+        unseenScoreBound += termScoreBound;
+    }
+    return _topScores.top() >= unseenScoreBound;
+}
+
+void TextOrStage::advanceToNextChild() {
+    invariant(_numChildrenDone < _children.size());
+    do {
+        _currentChild = (_currentChild + 1) % _children.size();
+    } while (_childDone[_currentChild]);
+}
+
 /**
  * Provides support for covered matching on non-text fields of a compound text index.
  */
@@ -331,6 +408,24 @@ PlanStage::StageState TextOrStage::addTerm(WorkingSetID wsid, WorkingSetID* out)
     invariant(wsm->getState() == WorkingSetMember::RID_AND_IDX);
     invariant(1 == wsm->keyData.size());
     const IndexKeyDatum newKeyData = wsm->keyData.back();  // copy to keep it around.
+
+    // Locate score within possibly compound key: {prefix,term,score,suffix}.
+    BSONObjIterator keyIt(newKeyData.keyData);
+    for (unsigned i = 0; i < _ftsSpec.numExtraBefore(); i++) {
+        keyIt.next();
+    }
+
+    keyIt.next();  // Skip past 'term'.
+
+    BSONElement scoreElement = keyIt.next();
+    double documentTermScore = scoreElement.number();
+
+    if (_scoreWholeDocuments) {
+        // Keys are read in descending order of score, so no document not yet seen by this child
+        // has a higher score for its term.
+        _termScoreBounds[_currentChild] = documentTermScore;
+    }
+
     TextRecordData* textRecordData = &_scores[wsm->recordId];
 
     if (textRecordData->score < 0) {
@@ -398,6 +493,15 @@ PlanStage::StageState TextOrStage::addTerm(WorkingSetID wsid, WorkingSetID* out)
 
         // Ensure that the BSONObj underlying the WorkingSetMember is owned in case we yield.
         wsm->makeObjOwnedIfNeeded();
+
+        if (_scoreWholeDocuments) {
+            textRecordData->score = scoreDocument(wsm->obj.value());
+            _topScores.push(textRecordData->score);
+            if (_topScores.size() > _topK) {
+                _topScores.pop();
+            }
+            return NEED_TIME;
+        }
     } else {
         // We already have a working set member for this RecordId. Free the new WSM and retrieve the
         // old one. Note that since we don't keep all index keys, we could get a score that doesn't
@@ -405,20 +509,13 @@ PlanStage::StageState TextOrStage::addTerm(WorkingSetID wsid, WorkingSetID* out)
         // TODO something to improve the situation.
         invariant(wsid != textRecordData->wsid);
         _ws->free(wsid);
-        wsm = _ws->get(textRecordData->wsid);
-    }
 
-    // Locate score within possibly compound key: {prefix,term,score,suffix}.
-    BSONObjIterator keyIt(newKeyData.keyData);
-    for (unsigned i = 0; i < _ftsSpec.numExtraBefore(); i++) {
-        keyIt.next();
+        if (_scoreWholeDocuments) {
+            // The document was scored in full when we first saw it.
+            return NEED_TIME;
+        }
     }
 
-    keyIt.next();  // Skip past 'term'.
-
-    BSONElement scoreElement = keyIt.next();
-    double documentTermScore = scoreElement.number();
-
     // Aggregate relevance score, term keys.
     textRecordData->score += documentTermScore;
     return NEED_TIME;
@@ -28,7 +28,11 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
+#include <queue>
+#include <set>
+#include <string>
 #include <vector>
 
 #include "mongo/db/catalog/collection.h"
@@ -52,6 +56,13 @@ class OperationContext;
  * the positive terms in the search query, as well as their scores.
  *
  * The WorkingSetMembers returned are fetched and in the LOC_AND_OBJ state.
+ *
+ * If constructed with a non-zero 'topK', the caller only needs the 'topK' highest scoring
+ * documents. Each child scans the keys for one term in descending order of score, so the score of
+ * the last key read from a child bounds what that term can add to any document not yet seen. In
+ * this mode the children are read in turn, every new document is scored in full against all of
+ * 'terms', and reading stops as soon as 'topK' documents score at least the sum of those bounds.
+ * Only documents which can still be among the top results are returned.
  */
 class TextOrStage final : public PlanStage {
 public:
@@ -76,7 +87,9 @@ public:
                 const FTSSpec& ftsSpec,
                 WorkingSet* ws,
                 const MatchExpression* filter,
-                IndexDescriptor* index);
+                IndexDescriptor* index,
+                size_t topK,
+                std::set<std::string> terms);
     ~TextOrStage();
 
     void addChild(unique_ptr<PlanStage> child);
@@ -125,6 +138,23 @@ private:
      */
     StageState returnResults(WorkingSetID* out);
 
+    /**
+     * Returns the score of 'obj' for all of the query terms, computed the same way as the scores
+     * stored in the index keys.
+     */
+    double scoreDocument(const BSONObj& obj) const;
+
+    /**
+     * Returns true in top-k mode if no document which has not been scored yet can score higher
+     * than the lowest of the 'topK' best scores found so far.
+     */
+    bool haveTopK() const;
+
+    /**
+     * Moves '_currentChild' to the next child, in turn, which still has keys to read.
+     */
+    void advanceToNextChild();
+
     // The index spec used to determine where to find the score.
     FTSSpec _ftsSpec;
 
@@ -137,6 +167,25 @@ private:
     // Which of _children are we calling work(...) on now?
     size_t _currentChild = 0;
 
+    // The number of results wanted in top-k mode, or zero to read every child to the end. Reset
+    // to zero if a scored document is invalidated, as '_topScores' is then no longer accurate.
+    size_t _topK;
+
+    // Whether documents are scored in full when first seen, rather than by summing the scores in
+    // their index keys. Set for the lifetime of a stage constructed in top-k mode.
+    const bool _scoreWholeDocuments;
+
+    // The query terms, one per child, used to score whole documents.
+    const std::set<std::string> _terms;
+
+    // For each child, the score of the last key read, or zero once the child is exhausted.
+    std::vector<double> _termScoreBounds;
+    std::vector<bool> _childDone;
+    size_t _numChildrenDone = 0;
+
+    // The 'topK' best scores found so far, lowest on top.
+    std::priority_queue<double, std::vector<double>, std::greater<double>> _topScores;
+
     /**
      *  Temporary score data filled out by children.
      *  Maps from RecordID -> (aggregate score for doc, wsid).
@@ -35,12 +35,14 @@
 #include "mongo/bson/mutable/algorithm.h"
 #include "mongo/db/bson/dotted_path_support.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/curop.h"
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/exec/write_stage_common.h"
 #include "mongo/db/op_observer.h"
 #include "mongo/db/ops/update_lifecycle.h"
 #include "mongo/db/query/explain.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/db/s/collection_metadata.h"
 #include "mongo/db/s/collection_sharding_state.h"
@@ -625,7 +627,6 @@ BSONObj UpdateStage::transformAndUpdate(const Snapshotted<BSONObj>& oldObj, Reco
         }
 
         invariant(oldObj.snapshotId() == getOpCtx()->recoveryUnit()->getSnapshotId());
-        wunit.commit();
 
         // If the document moved, we might see it again in a collection scan (maybe it's
         // a document after our current document).
@@ -634,10 +635,16 @@ BSONObj UpdateStage::transformAndUpdate(const Snapshotted<BSONObj>& oldObj, Reco
         // it again.  For an example, see the comment above near declaration of
         // updatedRecordIds.
         //
-        // This must be done after the wunit commits so we are sure we won't be rolling back.
+        // This must only happen once the write commits so we are sure we won't be rolling back.
+        // When updates are batched the commit is that of the enclosing batch.
         if (_updatedRecordIds && (newRecordId != recordId || driver->modsAffectIndices())) {
-            _updatedRecordIds->insert(newRecordId);
+            RecordIdSet* updatedRecordIds = _updatedRecordIds.get();
+            getOpCtx()->recoveryUnit()->onCommit(
+                [updatedRecordIds, newRecordId] { updatedRecordIds->insert(newRecordId); });
         }
+
+        WritePhaseTimer commitTimer(getOpCtx(), WritePhase::kCommit);
+        wunit.commit();
     }
 
     // Only record doc modifications if they wrote (exclude no-ops). Explains get
@@ -763,6 +770,7 @@ void UpdateStage::doInsert() {
 
         // Technically, we should save/restore state here, but since we are going to return
         // immediately after, it would just be wasted work.
+        WritePhaseTimer commitTimer(getOpCtx(), WritePhase::kCommit);
         wunit.commit();
     }
     MONGO_WRITE_CONFLICT_RETRY_LOOP_END(getOpCtx(), "upsert", _collection->ns().ns());
@@ -772,6 +780,7 @@ bool UpdateStage::doneUpdating() {
     // We're done updating if either the child has no more results to give us, or we've
     // already gotten a result back and we're not a multi-update.
     return _idRetrying == WorkingSet::INVALID_ID && _idReturning == WorkingSet::INVALID_ID &&
+        _batch.empty() && !_deferredChildState &&
         (child()->isEOF() || (_specificStats.nMatched > 0 && !_params.request->isMulti()));
 }
 
@@ -826,6 +835,10 @@ PlanStage::StageState UpdateStage::doWork(WorkingSetID* out) {
     // updates to them. We should only get here if the collection exists.
     invariant(_collection);
 
+    if (canBatchUpdates()) {
+        return doBatchedWork(out);
+    }
+
     // It is possible that after an update was applied, a WriteConflictException
     // occurred and prevented us from returning ADVANCED with the requested version
     // of the document.
@@ -975,7 +988,17 @@ PlanStage::StageState UpdateStage::doWork(WorkingSetID* out) {
         }
 
         return PlanStage::NEED_TIME;
-    } else if (PlanStage::IS_EOF == status) {
+    }
+
+    return handleChildState(status, id, out);
+}
+
+PlanStage::StageState UpdateStage::handleChildState(StageState status,
+                                                    WorkingSetID id,
+                                                    WorkingSetID* out) {
+    invariant(PlanStage::ADVANCED != status);
+
+    if (PlanStage::IS_EOF == status) {
         // The child is out of results, but we might not be done yet because we still might
         // have to do an insert.
         return PlanStage::NEED_TIME;
@@ -997,6 +1020,161 @@ PlanStage::StageState UpdateStage::doWork(WorkingSetID* out) {
     return status;
 }
 
+bool UpdateStage::canBatchUpdates() const {
+    return _params.request->isMulti() && !_params.request->shouldReturnAnyDocs() &&
+        internalUpdateMaxBatchSize.load() > 1 && supportsDocLocking();
+}
+
+PlanStage::StageState UpdateStage::doBatchedWork(WorkingSetID* out) {
+    if (_batch.empty()) {
+        if (_deferredChildState) {
+            const StageState status = *_deferredChildState;
+            _deferredChildState = boost::none;
+            return handleChildState(status, _deferredChildId, out);
+        }
+
+        // Ask the child for at most one batch worth of results so that the executor still gets
+        // to yield regularly when few documents match.
+        const size_t maxBatchSize = internalUpdateMaxBatchSize.load();
+        for (size_t i = 0; i < maxBatchSize; ++i) {
+            WorkingSetID id;
+            const StageState status = child()->work(&id);
+            if (PlanStage::ADVANCED == status) {
+                // The child's cursor may be advanced or yielded before the batch is applied, so
+                // the member has to own its document from here on.
+                _ws->get(id)->makeObjOwnedIfNeeded();
+                _batch.push_back(id);
+            } else if (PlanStage::NEED_TIME == status) {
+                continue;
+            } else if (_batch.empty()) {
+                return handleChildState(status, id, out);
+            } else {
+                // Apply the members collected so far before passing the child's state on, so
+                // that no member of the batch is held across a yield requested by the child.
+                if (PlanStage::IS_EOF != status) {
+                    _deferredChildState = status;
+                    _deferredChildId = id;
+                }
+                break;
+            }
+        }
+
+        if (_batch.empty()) {
+            return PlanStage::NEED_TIME;
+        }
+    }
+
+    // Drop the members which can no longer be updated.
+    std::vector<WorkingSetID> toUpdate;
+    toUpdate.reserve(_batch.size());
+    for (size_t i = 0; i < _batch.size(); ++i) {
+        const WorkingSetID id = _batch[i];
+        WorkingSetMember* member = _ws->get(id);
+
+        if (!member->hasRecordId()) {
+            // We expect to be here because of an invalidation causing a force-fetch.
+            ++_specificStats.nInvalidateSkips;
+            _ws->free(id);
+            continue;
+        }
+
+        // Updates can't have projections. This means that covering analysis will always add
+        // a fetch. We should always get fetched data, and never just key data.
+        invariant(member->hasObj());
+
+        if (_updatedRecordIds->count(member->recordId) > 0) {
+            _ws->free(id);
+            continue;
+        }
+
+        bool docStillMatches;
+        try {
+            docStillMatches = write_stage_common::ensureStillMatches(
+                _collection, getOpCtx(), _ws, id, _params.canonicalQuery);
+        } catch (const WriteConflictException& wce) {
+            // Retry this member and the rest of the batch after yielding.
+            toUpdate.insert(toUpdate.end(), _batch.begin() + i, _batch.end());
+            _batch.swap(toUpdate);
+            *out = WorkingSet::INVALID_ID;
+            return NEED_YIELD;
+        }
+
+        if (!docStillMatches) {
+            if (shouldRestartUpdateIfNoLongerMatches(_params)) {
+                throw WriteConflictException();
+            }
+            _ws->free(id);
+            continue;
+        }
+
+        toUpdate.push_back(id);
+    }
+    _batch.swap(toUpdate);
+
+    if (_batch.empty()) {
+        return PlanStage::NEED_TIME;
+    }
+
+    // Save state before making changes
+    WorkingSetCommon::prepareForSnapshotChange(_ws);
+    try {
+        child()->saveState();
+    } catch (const WriteConflictException& wce) {
+        std::terminate();
+    }
+
+    // Each document is updated in its own nested WriteUnitOfWork, so the whole batch shares one
+    // storage transaction and is logged to the oplog when it commits.
+    const UpdateStats statsBeforeBatch = _specificStats;
+    const long long nmovedBeforeBatch = _params.opDebug ? _params.opDebug->nmoved : 0;
+    const long long keysInsertedBeforeBatch = _params.opDebug ? _params.opDebug->keysInserted : 0;
+    const long long keysDeletedBeforeBatch = _params.opDebug ? _params.opDebug->keysDeleted : 0;
+    try {
+        WriteUnitOfWork wunit(getOpCtx());
+        for (const WorkingSetID id : _batch) {
+            WorkingSetMember* member = _ws->get(id);
+            RecordId recordId = member->recordId;
+            transformAndUpdate(member->obj, recordId);
+            ++_specificStats.nMatched;
+        }
+        WritePhaseTimer commitTimer(getOpCtx(), WritePhase::kCommit);
+        wunit.commit();
+    } catch (const WriteConflictException& wce) {
+        // Nothing in the batch was written, so retry all of it.
+        _specificStats = statsBeforeBatch;
+        if (_params.opDebug) {
+            _params.opDebug->nmoved = nmovedBeforeBatch;
+            _params.opDebug->keysInserted = keysInsertedBeforeBatch;
+            _params.opDebug->keysDeleted = keysDeletedBeforeBatch;
+        }
+        *out = WorkingSet::INVALID_ID;
+        return NEED_YIELD;
+    }
+
+    for (const WorkingSetID id : _batch) {
+        _ws->free(id);
+    }
+    _batch.clear();
+
+    // As restoreState may restore (recreate) cursors, make sure to restore the
+    // state outside of the WritUnitOfWork.
+    try {
+        child()->restoreState();
+    } catch (const WriteConflictException& wce) {
+        // The batch has already been committed, so there is nothing to retry.
+        *out = WorkingSet::INVALID_ID;
+        return NEED_YIELD;
+    }
+
+    // A yield requested by the child is not held back any longer than the batch itself.
+    if (_deferredChildState && PlanStage::NEED_YIELD == *_deferredChildState) {
+        _deferredChildState = boost::none;
+        return handleChildState(PlanStage::NEED_YIELD, _deferredChildId, out);
+    }
+
+    return PlanStage::NEED_TIME;
+}
+
 Status UpdateStage::restoreUpdateState() {
     const UpdateRequest& request = *_params.request;
     const NamespaceString& nsString(request.getNamespaceString());
@@ -28,6 +28,8 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
+#include <vector>
 
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/exec/plan_stage.h"
@@ -181,6 +183,27 @@ private:
      */
     StageState prepareToRetryWSM(WorkingSetID idToRetry, WorkingSetID* out);
 
+    /**
+     * Returns true if matching documents are updated in batches, which is the case for
+     * multi-updates that do not return documents on storage engines with document-level locking.
+     * Only there is a member kept across a write conflict re-fetched by ensureStillMatches() once
+     * the snapshot changes, without relying on invalidations.
+     */
+    bool canBatchUpdates() const;
+
+    /**
+     * Batched counterpart of the per-document path in doWork(). Collects up to
+     * internalUpdateMaxBatchSize results from the child, then saves the child's state once and
+     * updates all of the documents that still match in a single WriteUnitOfWork. On a write
+     * conflict the whole batch is rolled back and retried after yielding.
+     */
+    StageState doBatchedWork(WorkingSetID* out);
+
+    /**
+     * Translates a non-ADVANCED state returned by the child into the state this stage returns.
+     */
+    StageState handleChildState(StageState status, WorkingSetID id, WorkingSetID* out);
+
     UpdateStageParams _params;
 
     // Not owned by us.
@@ -195,6 +218,15 @@ private:
     // If not WorkingSet::INVALID_ID, we return this member to our caller.
     WorkingSetID _idReturning;
 
+    // Members collected from the child for a batched update which have not been applied yet,
+    // either because the batch is still being filled or because it hit a write conflict.
+    std::vector<WorkingSetID> _batch;
+
+    // A NEED_YIELD, FAILURE or DEAD state returned by the child while a batch was being filled.
+    // It is returned to our caller once the batch has been applied.
+    boost::optional<StageState> _deferredChildState;
+    WorkingSetID _deferredChildId = WorkingSet::INVALID_ID;
+
     // Stats
     UpdateStats _specificStats;
 
@@ -130,9 +130,13 @@ Status IndexAccessMethod::insert(OperationContext* txn,
     *numInserted = 0;
     BSONObjSet keys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
     MultikeyPaths multikeyPaths;
-    // Delegate to the subclass.
-    getKeys(obj, options.getKeysMode, &keys, &multikeyPaths);
+    {
+        WritePhaseTimer keyGenerationTimer(txn, WritePhase::kKeyGeneration);
+        // Delegate to the subclass.
+        getKeys(obj, options.getKeysMode, &keys, &multikeyPaths);
+    }
 
+    WritePhaseTimer indexWriteTimer(txn, WritePhase::kIndexWrite);
     Status ret = Status::OK();
     for (BSONObjSet::const_iterator i = keys.begin(); i != keys.end(); ++i) {
         Status status = _newInterface->insert(txn, *i, loc, options.dupsAllowed);
@@ -211,8 +215,12 @@ Status IndexAccessMethod::remove(OperationContext* txn,
     // multikey when removing a document since the index metadata isn't updated when keys are
     // deleted.
     MultikeyPaths* multikeyPaths = nullptr;
-    getKeys(obj, options.getKeysMode, &keys, multikeyPaths);
+    {
+        WritePhaseTimer keyGenerationTimer(txn, WritePhase::kKeyGeneration);
+        getKeys(obj, options.getKeysMode, &keys, multikeyPaths);
+    }
 
+    WritePhaseTimer indexWriteTimer(txn, WritePhase::kIndexWrite);
     for (BSONObjSet::const_iterator i = keys.begin(); i != keys.end(); ++i) {
         removeOneKey(txn, *i, loc, options.dupsAllowed);
         ++*numDeleted;
@@ -336,6 +344,7 @@ Status IndexAccessMethod::validateUpdate(OperationContext* txn,
                                          const InsertDeleteOptions& options,
                                          UpdateTicket* ticket,
                                          const MatchExpression* indexFilter) {
+    WritePhaseTimer keyGenerationTimer(txn, WritePhase::kKeyGeneration);
     if (!indexFilter || indexFilter->matchesBSON(from)) {
         // There's no need to compute the prefixes of the indexed fields that possibly caused the
         // index to be multikey when the old version of the document was written since the index
@@ -372,6 +381,7 @@ Status IndexAccessMethod::update(OperationContext* txn,
         return Status(ErrorCodes::InternalError, "Invalid UpdateTicket in update");
     }
 
+    WritePhaseTimer indexWriteTimer(txn, WritePhase::kIndexWrite);
     if (ticket.oldKeys.size() + ticket.added.size() - ticket.removed.size() > 1 ||
         isMultikeyFromPaths(ticket.newMultikeyPaths)) {
         _btreeState->setMultikey(txn, ticket.newMultikeyPaths);
@@ -40,6 +40,7 @@
 #include "mongo/db/catalog/document_validation.h"
 #include "mongo/db/commands.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/curop.h"
 #include "mongo/db/curop_metrics.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/exec/delete.h"
@@ -98,6 +99,8 @@ void finishCurOp(OperationContext* txn, CurOp* curOp) {
                     curOp->totalTimeMicros(),
                     curOp->isCommand(),
                     curOp->getReadWriteType());
+        Top::get(txn->getServiceContext())
+            .recordWritePhases(txn, curOp->getNS(), curOp->debug().writePhases);
 
         if (!curOp->debug().exceptionInfo.empty()) {
             LOG(3) << "Caught Assertion in " << redact(logicalOpToString(curOp->getLogicalOp()))
@@ -311,6 +314,7 @@ static void insertDocuments(OperationContext* txn,
     WriteUnitOfWork wuow(txn);
     uassertStatusOK(collection->insertDocuments(
         txn, begin, end, &CurOp::get(txn)->debug(), /*enforceQuota*/ true));
+    WritePhaseTimer commitTimer(txn, WritePhase::kCommit);
     wuow.commit();
 }
 
@@ -415,7 +419,8 @@ WriteResult performInserts(OperationContext* txn, const InsertOp& wholeOp) {
                     curOp.totalTimeMicros(),
                     curOp.isCommand(),
                     curOp.getReadWriteType());
-
+        Top::get(txn->getServiceContext())
+            .recordWritePhases(txn, wholeOp.ns.ns(), curOp.debug().writePhases);
     });
 
     {
@@ -79,9 +79,12 @@ StatusWith<AggregationRequest> AggregationRequest::parseFromBSON(NamespaceString
 
     AggregationRequest request(std::move(nss), std::move(pipeline));
 
+    // The shard version is attached by mongos to the aggregations it sends to each shard and is
+    // handled by the command processor.
     const std::initializer_list<StringData> optionsParsedElseWhere = {
         QueryRequest::cmdOptionMaxTimeMS,
         "writeConcern"_sd,
+        "shardVersion"_sd,
         kPipelineName,
         kCommandName,
         repl::ReadConcernArgs::kReadConcernFieldName};
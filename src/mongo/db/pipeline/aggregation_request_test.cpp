@@ -260,5 +260,12 @@ TEST(AggregationRequestTest, ShouldIgnoreReadConcernOption) {
     ASSERT_OK(AggregationRequest::parseFromBSON(nss, inputBson).getStatus());
 }
 
+TEST(AggregationRequestTest, ShouldIgnoreShardVersionOption) {
+    NamespaceString nss("a.collection");
+    const BSONObj inputBson =
+        fromjson("{pipeline: [{$match: {a: 'abc'}}], cursor: {}, shardVersion: 'invalid'}");
+    ASSERT_OK(AggregationRequest::parseFromBSON(nss, inputBson).getStatus());
+}
+
 }  // namespace
 }  // namespace mongo
@@ -535,6 +535,12 @@ public:
         virtual CollectionIndexUsageMap getIndexStats(OperationContext* opCtx,
                                                       const NamespaceString& ns) = 0;
 
+        /**
+         * Returns the statistics of each query shape recorded for collection "nss".
+         */
+        virtual std::vector<BSONObj> getQueryShapeStats(const NamespaceString& nss,
+                                                        bool includeHistograms) const = 0;
+
         /**
          * Appends operation latency statistics for collection "nss" to "builder"
          */
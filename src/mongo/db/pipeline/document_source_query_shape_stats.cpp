@@ -0,0 +1,104 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/document_source_query_shape_stats.h"
+
+#include "mongo/db/pipeline/lite_parsed_document_source.h"
+#include "mongo/db/server_options.h"
+#include "mongo/util/net/sock.h"
+
+namespace mongo {
+
+using boost::intrusive_ptr;
+
+REGISTER_DOCUMENT_SOURCE(queryShapeStats,
+                         LiteParsedDocumentSourceDefault::parse,
+                         DocumentSourceQueryShapeStats::createFromBson);
+
+const char* DocumentSourceQueryShapeStats::getSourceName() const {
+    return "$queryShapeStats";
+}
+
+DocumentSource::GetNextResult DocumentSourceQueryShapeStats::getNext() {
+    pExpCtx->checkForInterrupt();
+
+    if (!_fetched) {
+        _stats = _mongod->getQueryShapeStats(pExpCtx->ns, _includeHistograms);
+        _statsIter = _stats.begin();
+        _fetched = true;
+    }
+
+    if (_statsIter != _stats.end()) {
+        MutableDocument doc;
+        doc["ns"] = Value(pExpCtx->ns.ns());
+        doc["host"] = Value(_processName);
+        for (auto&& elem : *_statsIter) {
+            doc[elem.fieldNameStringData()] = Value(elem);
+        }
+        ++_statsIter;
+        return doc.freeze();
+    }
+
+    return GetNextResult::makeEOF();
+}
+
+DocumentSourceQueryShapeStats::DocumentSourceQueryShapeStats(
+    const intrusive_ptr<ExpressionContext>& pExpCtx, bool includeHistograms)
+    : DocumentSourceNeedsMongod(pExpCtx),
+      _includeHistograms(includeHistograms),
+      _processName(str::stream() << getHostNameCached() << ":" << serverGlobalParams.port) {}
+
+intrusive_ptr<DocumentSource> DocumentSourceQueryShapeStats::createFromBson(
+    BSONElement elem, const intrusive_ptr<ExpressionContext>& pExpCtx) {
+    uassert(40383,
+            str::stream() << "$queryShapeStats must take an object, but got " << elem,
+            elem.type() == BSONType::Object);
+
+    bool includeHistograms = false;
+    for (auto&& option : elem.embeddedObject()) {
+        uassert(40384,
+                str::stream() << "unrecognized option to $queryShapeStats: "
+                              << option.fieldNameStringData(),
+                option.fieldNameStringData() == "histograms");
+        uassert(40385,
+                str::stream() << "histograms option to $queryShapeStats must be bool, got "
+                              << option,
+                option.isBoolean());
+        includeHistograms = option.boolean();
+    }
+
+    return new DocumentSourceQueryShapeStats(pExpCtx, includeHistograms);
+}
+
+Value DocumentSourceQueryShapeStats::serialize(bool explain) const {
+    return Value(DOC(getSourceName() << DOC("histograms" << _includeHistograms)));
+}
+
+}  // namespace mongo
@@ -58,6 +58,7 @@
 #include "mongo/db/pipeline/document_source_sort.h"
 #include "mongo/db/pipeline/pipeline.h"
 #include "mongo/db/query/collation/collator_interface.h"
+#include "mongo/db/query/query_shape_stats.h"
 #include "mongo/db/query/get_executor.h"
 #include "mongo/db/query/plan_summary_stats.h"
 #include "mongo/db/query/query_planner.h"
@@ -125,6 +126,12 @@ public:
         return collection->infoCache()->getIndexUsageStats();
     }
 
+    std::vector<BSONObj> getQueryShapeStats(const NamespaceString& nss,
+                                            bool includeHistograms) const final {
+        return QueryShapeStats::get(_ctx->opCtx->getServiceContext())
+            .getStats(nss.ns(), includeHistograms);
+    }
+
     void appendLatencyStats(const NamespaceString& nss,
                             bool includeHistograms,
                             BSONObjBuilder* builder) const final {
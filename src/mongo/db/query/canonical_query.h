@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
 
 #include "mongo/base/status.h"
 #include "mongo/db/dbmessage.h"
@@ -177,6 +178,19 @@ public:
         return _isIsolated;
     }
 
+    /**
+     * The plan cache key only depends on the query, so PlanCache::computeKey remembers it here.
+     * This way it is encoded once per query, no matter how many times the planner, the plan cache
+     * and the query shape statistics need it, including across getMores.
+     */
+    const boost::optional<std::string>& getPlanCacheKey() const {
+        return _planCacheKey;
+    }
+
+    void setPlanCacheKey(std::string planCacheKey) const {
+        _planCacheKey = std::move(planCacheKey);
+    }
+
 private:
     // You must go through canonicalize to create a CanonicalQuery.
     CanonicalQuery() {}
@@ -198,6 +212,8 @@ private:
     bool _hasNoopExtensions = false;
 
     bool _isIsolated;
+
+    mutable boost::optional<std::string> _planCacheKey;
 };
 
 }  // namespace mongo
@@ -374,6 +374,10 @@ Message getMore(OperationContext* txn,
         exec->reattachToOperationContext(txn);
         exec->restoreState();
 
+        if (ctx && ctx->getCollection() && exec->getCanonicalQuery()) {
+            setCurOpQueryShape(txn, ctx->getCollection(), *exec->getCanonicalQuery());
+        }
+
         auto planSummary = Explain::getPlanSummary(exec);
         {
             stdx::lock_guard<Client> lk(*txn->getClient());
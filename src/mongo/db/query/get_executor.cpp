@@ -39,6 +39,7 @@
 #include "mongo/base/error_codes.h"
 #include "mongo/base/parse_number.h"
 #include "mongo/client/dbclientinterface.h"
+#include "mongo/db/curop.h"
 #include "mongo/db/exec/cached_plan.h"
 #include "mongo/db/exec/count.h"
 #include "mongo/db/exec/delete.h"
@@ -612,11 +613,36 @@ StatusWith<unique_ptr<PlanExecutor>> getOplogStartHack(OperationContext* txn,
 
 }  // namespace
 
+void setCurOpQueryShape(OperationContext* txn,
+                        const Collection* collection,
+                        const CanonicalQuery& canonicalQuery) {
+    OpDebug& opDebug = CurOp::get(txn)->debug();
+    if (!opDebug.queryShapeKey.empty() || internalQueryShapeStatsSize.load() <= 0) {
+        return;
+    }
+
+    const QueryRequest& qr = canonicalQuery.getQueryRequest();
+    BSONObjBuilder shapeBuilder;
+    shapeBuilder.append("filter", qr.getFilter());
+    shapeBuilder.append("sort", qr.getSort());
+    shapeBuilder.append("projection", qr.getProj());
+    if (!qr.getCollation().isEmpty()) {
+        shapeBuilder.append("collation", qr.getCollation());
+    }
+
+    opDebug.queryShapeKey = collection->infoCache()->getPlanCache()->computeKey(canonicalQuery);
+    opDebug.queryShape = shapeBuilder.obj();
+}
+
 StatusWith<unique_ptr<PlanExecutor>> getExecutorFind(OperationContext* txn,
                                                      Collection* collection,
                                                      const NamespaceString& nss,
                                                      unique_ptr<CanonicalQuery> canonicalQuery,
                                                      PlanExecutor::YieldPolicy yieldPolicy) {
+    if (NULL != collection) {
+        setCurOpQueryShape(txn, collection, *canonicalQuery);
+    }
+
     if (NULL != collection && canonicalQuery->getQueryRequest().isOplogReplay()) {
         return getOplogStartHack(txn, collection, std::move(canonicalQuery));
     }
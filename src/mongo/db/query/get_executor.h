@@ -63,6 +63,16 @@ void fillOutPlannerParams(OperationContext* txn,
                           CanonicalQuery* canonicalQuery,
                           QueryPlannerParams* plannerParams);
 
+/**
+ * Remembers the shape of 'canonicalQuery' on the current CurOp so that the operation's statistics
+ * are added to that shape's entry in QueryShapeStats once it completes. Only the first shape set
+ * on an operation is kept. The shape key is the plan cache key, which is shared with the plan cache
+ * lookups of the same query instead of being encoded again.
+ */
+void setCurOpQueryShape(OperationContext* txn,
+                        const Collection* collection,
+                        const CanonicalQuery& canonicalQuery);
+
 /**
  * Get a plan executor for a query.
  *
@@ -723,11 +723,18 @@ void PlanCache::clear() {
 }
 
 PlanCacheKey PlanCache::computeKey(const CanonicalQuery& cq) const {
+    if (cq.getPlanCacheKey()) {
+        return *cq.getPlanCacheKey();
+    }
+
     StringBuilder keyBuilder;
     encodeKeyForMatch(cq.root(), &keyBuilder);
     encodeKeyForSort(cq.getQueryRequest().getSort(), &keyBuilder);
     encodeKeyForProj(cq.getQueryRequest().getProj(), &keyBuilder);
-    return keyBuilder.str();
+
+    PlanCacheKey key = keyBuilder.str();
+    cq.setPlanCacheKey(key);
+    return key;
 }
 
 Status PlanCache::getEntry(const CanonicalQuery& query, PlanCacheEntry** entryOut) const {
@@ -352,6 +352,9 @@ public:
      * This is provided in the public API simply as a convenience for consumers who need some
      * description of query shape (e.g. index filters).
      *
+     * The key is only encoded the first time it is requested for a query and remembered on the
+     * CanonicalQuery afterwards.
+     *
      * Callers must hold the collection lock when calling this method.
      */
     PlanCacheKey computeKey(const CanonicalQuery&) const;
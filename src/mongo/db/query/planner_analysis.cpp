@@ -599,6 +599,14 @@ QuerySolutionNode* QueryPlannerAnalysis::analyzeSort(const CanonicalQuery& query
         sort->limit = 0;
     }
 
+    // A limited sort on the text score only needs the highest scoring documents from a TEXT stage
+    // directly beneath it, which allows the TEXT stage to stop reading the index early.
+    QuerySolutionNode* sortInput = keyGenNode->children[0];
+    if (sort->limit && solnRoot == sort && STAGE_TEXT == sortInput->getType() &&
+        sortObj.nFields() == 1 && QueryRequest::isTextScoreMeta(sortObj.firstElement())) {
+        static_cast<TextNode*>(sortInput)->topK = sort->limit;
+    }
+
     *blockingSortOut = true;
 
     return solnRoot;
@@ -64,6 +64,11 @@ extern AtomicBool internalQueryPlannerEnableHashIntersection;
 // How many entries in the cache?
 extern AtomicInt32 internalQueryCacheSize;
 
+// How many query shapes to keep statistics for? Changes take effect with the next recorded
+// operation and shrinking keeps the most recently used shapes. Setting this to zero stops
+// recording.
+extern AtomicInt32 internalQueryShapeStatsSize;
+
 // How many feedback entries do we collect before possibly evicting from the cache based on bad
 // performance?
 extern AtomicInt32 internalQueryCacheFeedbacksStored;
@@ -104,6 +109,10 @@ extern AtomicInt32 internalQueryExecYieldIterations;
 // Yield if it's been at least this many milliseconds since we last yielded.
 extern AtomicInt32 internalQueryExecYieldPeriodMS;
 
+// Do text searches sorted by text score with a limit stop reading the text index once the top
+// results are known?
+extern AtomicBool internalQueryExecEnableTextTopK;
+
 // Limit the size that we write without yielding to 16MB / 64 (max expected number of indexes)
 const int64_t insertVectorMaxBytes = 256 * 1024;
 
@@ -112,6 +121,10 @@ extern AtomicInt32 internalQueryFacetBufferSizeBytes;
 
 extern AtomicInt32 internalInsertMaxBatchSize;
 
+// The maximum number of documents a multi-update applies in one storage transaction. A value of
+// 1 updates each document in its own transaction.
+extern AtomicInt32 internalUpdateMaxBatchSize;
+
 extern AtomicInt32 internalDocumentSourceCursorBatchSizeBytes;
 
 }  // namespace mongo
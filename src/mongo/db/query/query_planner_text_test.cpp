@@ -461,4 +461,52 @@ TEST_F(QueryPlannerTest, SortKeyMetaProjectionWithTextScoreMetaSort) {
         "{sortKeyGen: {node: {text: {search: 'foo'}}}}}}}}");
 }
 
+TEST_F(QueryPlannerTest, TextScoreSortWithLimitSetsTopKOnTextNode) {
+    addIndex(BSON("_fts"
+                  << "text"
+                  << "_ftsx"
+                  << 1));
+    runQueryAsCommand(
+        fromjson("{find: 'testns', filter: {$text: {$search: 'foo bar'}}, "
+                 "sort: {score: {$meta: 'textScore'}}, "
+                 "projection: {score: {$meta: 'textScore'}}, skip: 5, limit: 10}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{skip: {n: 5, node: {proj: {spec: {score: {$meta: 'textScore'}}, node: "
+        "{sort: {limit: 15, pattern: {score: {$meta: 'textScore'}}, node: "
+        "{sortKeyGen: {node: {text: {search: 'foo bar', topK: 15}}}}}}}}}}");
+}
+
+TEST_F(QueryPlannerTest, TextScoreSortWithoutLimitDoesNotSetTopK) {
+    addIndex(BSON("_fts"
+                  << "text"
+                  << "_ftsx"
+                  << 1));
+    runQueryAsCommand(
+        fromjson("{find: 'testns', filter: {$text: {$search: 'foo'}}, "
+                 "sort: {score: {$meta: 'textScore'}}, "
+                 "projection: {score: {$meta: 'textScore'}}}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{proj: {spec: {score: {$meta: 'textScore'}}, node: "
+        "{sort: {limit: 0, pattern: {score: {$meta: 'textScore'}}, node: "
+        "{sortKeyGen: {node: {text: {search: 'foo', topK: 0}}}}}}}}");
+}
+
+TEST_F(QueryPlannerTest, SortOnOtherFieldWithLimitDoesNotSetTopK) {
+    addIndex(BSON("_fts"
+                  << "text"
+                  << "_ftsx"
+                  << 1));
+    runQueryAsCommand(fromjson(
+        "{find: 'testns', filter: {$text: {$search: 'foo'}}, sort: {a: 1}, limit: 10}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{sort: {limit: 10, pattern: {a: 1}, node: "
+        "{sortKeyGen: {node: {text: {search: 'foo', topK: 0}}}}}}");
+}
+
 }  // namespace
@@ -0,0 +1,194 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/query_shape_stats.h"
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/db/service_context.h"
+#include "mongo/stdx/memory.h"
+
+namespace mongo {
+
+namespace {
+
+const auto getQueryShapeStats = ServiceContext::declareDecoration<QueryShapeStats>();
+
+// Namespaces cannot contain NUL bytes, so this separates the namespace from the plan cache key.
+std::string makeStoreKey(StringData ns, const std::string& shapeKey) {
+    std::string key;
+    key.reserve(ns.size() + 1 + shapeKey.size());
+    key.append(ns.rawData(), ns.size());
+    key.push_back('\0');
+    key.append(shapeKey);
+    return key;
+}
+
+}  // namespace
+
+// static
+QueryShapeStats& QueryShapeStats::get(ServiceContext* service) {
+    return getQueryShapeStats(service);
+}
+
+QueryShapeStats::QueryShapeStats(size_t numPartitions) {
+    invariant(numPartitions > 0);
+    for (size_t i = 0; i < numPartitions; ++i) {
+        _partitions.push_back(stdx::make_unique<Partition>());
+    }
+}
+
+void QueryShapeStats::record(StringData ns,
+                             const std::string& shapeKey,
+                             const BSONObj& shape,
+                             const OperationMetrics& metrics) {
+    const int size = internalQueryShapeStatsSize.load();
+    if (size <= 0) {
+        return;
+    }
+
+    const std::string key = makeStoreKey(ns, shapeKey);
+    const Date_t now = Date_t::now();
+
+    Partition& partition = *_partitions[std::hash<std::string>()(key) % _partitions.size()];
+    const size_t capacity = (size + _partitions.size() - 1) / _partitions.size();
+
+    stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+    if (partition.capacity != capacity) {
+        _resize(&partition, capacity);
+    }
+
+    Entry* entry;
+    if (!partition.entries->get(key, &entry).isOK()) {
+        entry = new Entry();
+        entry->ns = ns.toString();
+        entry->shape = shape.getOwned();
+        entry->firstSeen = now;
+        if (partition.entries->add(key, entry)) {
+            ++partition.shapesEvicted;
+        }
+        ++partition.shapesRecorded;
+    }
+
+    entry->lastSeen = now;
+    entry->planSummary = metrics.planSummary;
+    entry->count++;
+    entry->cpuMicros += metrics.cpuMicros;
+    entry->keysExamined += metrics.keysExamined;
+    entry->docsExamined += metrics.docsExamined;
+    entry->nreturned += metrics.nreturned;
+    entry->latency.increment(metrics.latencyMicros);
+}
+
+// static
+void QueryShapeStats::_resize(Partition* partition, size_t capacity) {
+    auto entries = stdx::make_unique<LRUKeyValue<std::string, Entry>>(capacity);
+
+    if (partition->entries) {
+        // Re-add the shapes which still fit from the least to the most recently used, so that
+        // they keep their order
+        const size_t numKept = std::min(capacity, partition->entries->size());
+        auto it = std::next(partition->entries->begin(), numKept);
+        while (it != partition->entries->begin()) {
+            --it;
+            entries->add(it->first, new Entry(*it->second));
+        }
+
+        partition->shapesEvicted += partition->entries->size() - numKept;
+    }
+
+    partition->entries = std::move(entries);
+    partition->capacity = capacity;
+}
+
+std::vector<BSONObj> QueryShapeStats::getStats(StringData ns, bool includeHistograms) const {
+    std::vector<std::pair<Date_t, BSONObj>> stats;
+
+    for (const auto& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lk(partition->mutex);
+        if (!partition->entries) {
+            continue;
+        }
+
+        for (auto it = partition->entries->begin(); it != partition->entries->end(); ++it) {
+            const Entry& entry = *it->second;
+            if (entry.ns != ns) {
+                continue;
+            }
+
+            BSONObjBuilder builder;
+            builder.append("shape", entry.shape);
+            builder.append("planSummary", entry.planSummary);
+            builder.appendNumber("count", entry.count);
+            entry.latency.append("latencyStats", includeHistograms, &builder);
+            builder.appendNumber("cpuMicros", entry.cpuMicros);
+            builder.appendNumber("keysExamined", entry.keysExamined);
+            builder.appendNumber("docsExamined", entry.docsExamined);
+            builder.appendNumber("nreturned", entry.nreturned);
+            builder.appendDate("firstSeen", entry.firstSeen);
+            builder.appendDate("lastSeen", entry.lastSeen);
+            stats.emplace_back(entry.lastSeen, builder.obj());
+        }
+    }
+
+    // Each partition is in most recently used order already, so a stable sort keeps that order
+    // among the shapes which were last seen at the same time
+    std::stable_sort(stats.begin(), stats.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.first > rhs.first;
+    });
+
+    std::vector<BSONObj> result;
+    result.reserve(stats.size());
+    for (auto& stat : stats) {
+        result.push_back(std::move(stat.second));
+    }
+    return result;
+}
+
+void QueryShapeStats::appendSummary(BSONObjBuilder* builder) const {
+    long long shapes = 0;
+    long long shapesRecorded = 0;
+    long long shapesEvicted = 0;
+    for (const auto& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lk(partition->mutex);
+        shapes += partition->entries ? partition->entries->size() : 0;
+        shapesRecorded += partition->shapesRecorded;
+        shapesEvicted += partition->shapesEvicted;
+    }
+
+    builder->appendNumber("shapes", shapes);
+    builder->appendNumber("recorded", shapesRecorded);
+    builder->appendNumber("evicted", shapesEvicted);
+}
+
+}  // namespace mongo
@@ -0,0 +1,134 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/query/lru_key_value.h"
+#include "mongo/db/stats/operation_latency_histogram.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class ServiceContext;
+
+/**
+ * A bounded, in-memory store of execution statistics aggregated by query shape. A shape is
+ * identified by its namespace and its plan cache key, so queries which differ only in the values
+ * they compare against share an entry.
+ *
+ * The shapes are spread by the hash of their key over independently locked partitions, so that
+ * concurrent operations on different shapes rarely contend on the same mutex. Each partition holds
+ * an equal share of internalQueryShapeStatsSize shapes and evicts its least recently used shape
+ * when it is full.
+ *
+ * This class is thread-safe.
+ */
+class QueryShapeStats {
+    MONGO_DISALLOW_COPYING(QueryShapeStats);
+
+public:
+    /**
+     * The contribution of a single operation to the statistics of its shape.
+     */
+    struct OperationMetrics {
+        long long latencyMicros = 0;
+        long long cpuMicros = 0;
+        long long keysExamined = 0;
+        long long docsExamined = 0;
+        long long nreturned = 0;
+        std::string planSummary;
+    };
+
+    static const size_t kDefaultNumPartitions = 16;
+
+    static QueryShapeStats& get(ServiceContext* service);
+
+    explicit QueryShapeStats(size_t numPartitions = kDefaultNumPartitions);
+
+    /**
+     * Adds 'metrics' to the statistics of the shape identified by 'ns' and 'shapeKey'. 'shape' is
+     * only kept if this is the first operation recorded for the shape.
+     */
+    void record(StringData ns,
+                const std::string& shapeKey,
+                const BSONObj& shape,
+                const OperationMetrics& metrics);
+
+    /**
+     * Returns one document per shape recorded for 'ns', most recently seen first.
+     */
+    std::vector<BSONObj> getStats(StringData ns, bool includeHistograms) const;
+
+    /**
+     * Appends the number of shapes tracked and the number of shapes recorded and evicted so far.
+     */
+    void appendSummary(BSONObjBuilder* builder) const;
+
+private:
+    struct Entry {
+        std::string ns;
+        BSONObj shape;
+        std::string planSummary;  // Plan summary of the most recent operation.
+        Date_t firstSeen;
+        Date_t lastSeen;
+        long long count = 0;
+        long long cpuMicros = 0;
+        long long keysExamined = 0;
+        long long docsExamined = 0;
+        long long nreturned = 0;
+        OperationLatencyHistogram::HistogramData latency;
+    };
+
+    struct Partition {
+        mutable stdx::mutex mutex;
+
+        // Created on first use and rebuilt whenever internalQueryShapeStatsSize changes.
+        std::unique_ptr<LRUKeyValue<std::string, Entry>> entries;
+        size_t capacity = 0;
+
+        long long shapesRecorded = 0;
+        long long shapesEvicted = 0;
+    };
+
+    /**
+     * Makes 'partition' hold up to 'capacity' shapes, keeping its most recently used ones.
+     */
+    static void _resize(Partition* partition, size_t capacity);
+
+    std::vector<std::unique_ptr<Partition>> _partitions;
+};
+
+}  // namespace mongo
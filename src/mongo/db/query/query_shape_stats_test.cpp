@@ -0,0 +1,163 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/query_shape_stats.h"
+
+#include "mongo/db/json.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace {
+
+QueryShapeStats::OperationMetrics makeMetrics(long long latencyMicros, long long docsExamined) {
+    QueryShapeStats::OperationMetrics metrics;
+    metrics.latencyMicros = latencyMicros;
+    metrics.docsExamined = docsExamined;
+    metrics.keysExamined = docsExamined;
+    metrics.nreturned = 1;
+    metrics.planSummary = "IXSCAN { a: 1 }";
+    return metrics;
+}
+
+TEST(QueryShapeStats, AggregatesOperationsWithTheSameShape) {
+    QueryShapeStats stats;
+    const BSONObj shape = fromjson("{filter: {a: 1}, sort: {}, projection: {}}");
+    stats.record("test.coll", "eqa", shape, makeMetrics(100, 3));
+    stats.record("test.coll", "eqa", fromjson("{filter: {a: 2}}"), makeMetrics(300, 5));
+    stats.record("test.other", "eqa", shape, makeMetrics(50, 1));
+
+    std::vector<BSONObj> coll = stats.getStats("test.coll", false);
+    ASSERT_EQUALS(coll.size(), 1U);
+    // The shape of the first operation is kept.
+    ASSERT_BSONOBJ_EQ(coll[0]["shape"].Obj(), shape);
+    ASSERT_EQUALS(coll[0]["count"].numberLong(), 2);
+    ASSERT_EQUALS(coll[0]["docsExamined"].numberLong(), 8);
+    ASSERT_EQUALS(coll[0]["nreturned"].numberLong(), 2);
+    ASSERT_EQUALS(coll[0]["latencyStats"]["latency"].numberLong(), 400);
+    ASSERT_EQUALS(coll[0]["latencyStats"]["ops"].numberLong(), 2);
+    ASSERT_EQUALS(coll[0]["planSummary"].String(), "IXSCAN { a: 1 }");
+    ASSERT_FALSE(coll[0]["latencyStats"].Obj().hasField("histogram"));
+
+    std::vector<BSONObj> other = stats.getStats("test.other", true);
+    ASSERT_EQUALS(other.size(), 1U);
+    ASSERT_EQUALS(other[0]["count"].numberLong(), 1);
+    ASSERT_TRUE(other[0]["latencyStats"].Obj().hasField("histogram"));
+
+    ASSERT_TRUE(stats.getStats("test.none", false).empty());
+}
+
+TEST(QueryShapeStats, EvictsLeastRecentlyUsedShape) {
+    const int oldSize = internalQueryShapeStatsSize.load();
+    internalQueryShapeStatsSize.store(2);
+    ON_BLOCK_EXIT([&] { internalQueryShapeStatsSize.store(oldSize); });
+
+    // A single partition evicts in exact least recently used order.
+    QueryShapeStats stats(1);
+    stats.record("test.coll", "eqa", BSON("filter" << BSON("a" << 1)), makeMetrics(1, 1));
+    stats.record("test.coll", "eqb", BSON("filter" << BSON("b" << 1)), makeMetrics(1, 1));
+    stats.record("test.coll", "eqa", BSON("filter" << BSON("a" << 1)), makeMetrics(1, 1));
+    stats.record("test.coll", "eqc", BSON("filter" << BSON("c" << 1)), makeMetrics(1, 1));
+
+    std::vector<BSONObj> coll = stats.getStats("test.coll", false);
+    ASSERT_EQUALS(coll.size(), 2U);
+    ASSERT_BSONOBJ_EQ(coll[0]["shape"].Obj(), BSON("filter" << BSON("c" << 1)));
+    ASSERT_BSONOBJ_EQ(coll[1]["shape"].Obj(), BSON("filter" << BSON("a" << 1)));
+
+    BSONObjBuilder summary;
+    stats.appendSummary(&summary);
+    ASSERT_BSONOBJ_EQ(summary.obj(), BSON("shapes" << 2 << "recorded" << 3 << "evicted" << 1));
+}
+
+TEST(QueryShapeStats, HonorsSizeChanges) {
+    const int oldSize = internalQueryShapeStatsSize.load();
+    internalQueryShapeStatsSize.store(3);
+    ON_BLOCK_EXIT([&] { internalQueryShapeStatsSize.store(oldSize); });
+
+    QueryShapeStats stats(1);
+    stats.record("test.coll", "eqa", BSON("filter" << BSON("a" << 1)), makeMetrics(1, 1));
+    stats.record("test.coll", "eqb", BSON("filter" << BSON("b" << 1)), makeMetrics(1, 1));
+    stats.record("test.coll", "eqc", BSON("filter" << BSON("c" << 1)), makeMetrics(1, 1));
+
+    // Shrinking keeps the most recently used shapes and their statistics.
+    internalQueryShapeStatsSize.store(2);
+    stats.record("test.coll", "eqc", BSON("filter" << BSON("c" << 1)), makeMetrics(1, 1));
+
+    std::vector<BSONObj> coll = stats.getStats("test.coll", false);
+    ASSERT_EQUALS(coll.size(), 2U);
+    ASSERT_BSONOBJ_EQ(coll[0]["shape"].Obj(), BSON("filter" << BSON("c" << 1)));
+    ASSERT_EQUALS(coll[0]["count"].numberLong(), 2);
+    ASSERT_BSONOBJ_EQ(coll[1]["shape"].Obj(), BSON("filter" << BSON("b" << 1)));
+
+    // Growing makes room for more shapes.
+    internalQueryShapeStatsSize.store(4);
+    stats.record("test.coll", "eqd", BSON("filter" << BSON("d" << 1)), makeMetrics(1, 1));
+    stats.record("test.coll", "eqe", BSON("filter" << BSON("e" << 1)), makeMetrics(1, 1));
+    ASSERT_EQUALS(stats.getStats("test.coll", false).size(), 4U);
+
+    BSONObjBuilder summary;
+    stats.appendSummary(&summary);
+    ASSERT_BSONOBJ_EQ(summary.obj(), BSON("shapes" << 4 << "recorded" << 5 << "evicted" << 1));
+}
+
+TEST(QueryShapeStats, SpreadsShapesOverPartitions) {
+    const int oldSize = internalQueryShapeStatsSize.load();
+    internalQueryShapeStatsSize.store(1000);
+    ON_BLOCK_EXIT([&] { internalQueryShapeStatsSize.store(oldSize); });
+
+    QueryShapeStats stats;
+    for (int i = 0; i < 100; ++i) {
+        const std::string shapeKey = str::stream() << "eq" << i;
+        const BSONObj shape = BSON("filter" << BSON(shapeKey << 1));
+        stats.record("test.coll", shapeKey, shape, makeMetrics(1, 1));
+        stats.record("test.coll", shapeKey, shape, makeMetrics(1, 1));
+    }
+
+    std::vector<BSONObj> coll = stats.getStats("test.coll", false);
+    ASSERT_EQUALS(coll.size(), 100U);
+    for (const auto& shapeStats : coll) {
+        ASSERT_EQUALS(shapeStats["count"].numberLong(), 2);
+    }
+}
+
+TEST(QueryShapeStats, DisabledWhenSizeIsZero) {
+    const int oldSize = internalQueryShapeStatsSize.load();
+    internalQueryShapeStatsSize.store(0);
+    ON_BLOCK_EXIT([&] { internalQueryShapeStatsSize.store(oldSize); });
+
+    QueryShapeStats stats;
+    stats.record("test.coll", "eqa", BSON("filter" << BSON("a" << 1)), makeMetrics(1, 1));
+    ASSERT_TRUE(stats.getStats("test.coll", false).empty());
+}
+
+}  // namespace
+}  // namespace mongo
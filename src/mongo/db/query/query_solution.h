@@ -254,6 +254,10 @@ struct TextNode : public QuerySolutionNode {
     // text node while creating the text leaf node and convert them into a BSONObj index prefix
     // when we finish the text leaf node.
     BSONObj indexPrefix;
+
+    // If non-zero, only the 'topK' highest scoring documents are needed, because the text node
+    // feeds a sort on the text score with this limit.
+    size_t topK = 0;
 };
 
 struct CollectionScanNode : public QuerySolutionNode {
@@ -59,6 +59,7 @@
 #include "mongo/db/commands.h"
 #include "mongo/db/commands/dbhash.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/curop.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/dbdirectclient.h"
 #include "mongo/db/dbhelpers.h"
@@ -261,29 +262,44 @@ bool oplogDisabled(OperationContext* txn,
     return false;
 }
 
-OplogDocWriter _logOpWriter(OperationContext* txn,
+/**
+ * Appends every field of an oplog entry except for "o", which OplogDocWriter adds when the entry
+ * is written to the oplog.
+ */
+void _appendOplogEntryFrame(BSONObjBuilder* b,
                             const char* opstr,
                             const NamespaceString& nss,
-                            const BSONObj& obj,
                             const BSONObj* o2,
                             bool fromMigrate,
                             OpTime optime,
                             long long hashNew) {
-    BSONObjBuilder b(256);
-
-    b.append("ts", optime.getTimestamp());
+    b->append("ts", optime.getTimestamp());
     if (optime.getTerm() != -1)
-        b.append("t", optime.getTerm());
-    b.append("h", hashNew);
-    b.append("v", OplogEntry::kOplogVersion);
-    b.append("op", opstr);
-    b.append("ns", nss.ns());
+        b->append("t", optime.getTerm());
+    b->append("h", hashNew);
+    b->append("v", OplogEntry::kOplogVersion);
+    b->append("op", opstr);
+    b->append("ns", nss.ns());
     if (fromMigrate)
-        b.appendBool("fromMigrate", true);
+        b->appendBool("fromMigrate", true);
     if (o2)
-        b.append("o2", *o2);
+        b->append("o2", *o2);
+}
 
-    return OplogDocWriter(OplogDocWriter(b.obj(), obj));
+/**
+ * Builds the frame of the oplog entry in 'frameBuf', which must outlive the returned writer.
+ */
+OplogDocWriter _logOpWriter(BufBuilder* frameBuf,
+                            const char* opstr,
+                            const NamespaceString& nss,
+                            const BSONObj& obj,
+                            const BSONObj* o2,
+                            bool fromMigrate,
+                            OpTime optime,
+                            long long hashNew) {
+    BSONObjBuilder b(*frameBuf);
+    _appendOplogEntryFrame(&b, opstr, nss, o2, fromMigrate, optime, hashNew);
+    return OplogDocWriter(b.done(), obj);
 }
 }  // end anon namespace
 
@@ -392,13 +408,16 @@ void logOp(OperationContext* txn,
     if (oplogDisabled(txn, replMode, nss))
         return;
 
+    WritePhaseTimer oplogWriteTimer(txn, WritePhase::kOplogWrite);
     ReplicationCoordinator* replCoord = getGlobalReplicationCoordinator();
     Collection* oplog = getLocalOplogCollection(txn, _oplogCollectionName);
     Lock::DBLock lk(txn->lockState(), "local", MODE_IX);
     Lock::CollectionLock lock(txn->lockState(), _oplogCollectionName, MODE_IX);
     OplogSlot slot;
     getNextOpTime(txn, oplog, replCoord, replMode, 1, &slot);
-    auto writer = _logOpWriter(txn, opstr, nss, obj, o2, fromMigrate, slot.opTime, slot.hash);
+    ScratchBufBuilder frameBuf;
+    auto writer =
+        _logOpWriter(&frameBuf.get(), opstr, nss, obj, o2, fromMigrate, slot.opTime, slot.hash);
     const DocWriter* basePtr = &writer;
     _logOpsInner(txn, nss, &basePtr, 1, oplog, replMode, slot.opTime);
 }
@@ -416,6 +435,7 @@ void logOps(OperationContext* txn,
     if (oplogDisabled(txn, replMode, nss))
         return;
 
+    WritePhaseTimer oplogWriteTimer(txn, WritePhase::kOplogWrite);
     const size_t count = end - begin;
     std::vector<OplogDocWriter> writers;
     writers.reserve(count);
@@ -424,9 +444,21 @@ void logOps(OperationContext* txn,
     Lock::CollectionLock lock(txn->lockState(), _oplogCollectionName, MODE_IX);
     std::unique_ptr<OplogSlot[]> slots(new OplogSlot[count]);
     getNextOpTime(txn, oplog, replCoord, replMode, count, slots.get());
+
+    // Build the frames of all the entries back to back in a single buffer instead of allocating
+    // one per entry. The writers refer to the frames without owning them, so the buffer must stay
+    // alive until the entries have been written to the oplog below.
+    BufBuilder frames(static_cast<int>(std::min<size_t>(count * 128, BSONObjMaxUserSize)));
+    std::vector<int> frameOffsets;
+    frameOffsets.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        frameOffsets.push_back(frames.len());
+        BSONObjBuilder b(frames);
+        _appendOplogEntryFrame(&b, opstr, nss, NULL, fromMigrate, slots[i].opTime, slots[i].hash);
+        b.done();
+    }
     for (size_t i = 0; i < count; i++) {
-        writers.emplace_back(_logOpWriter(
-            txn, opstr, nss, begin[i], NULL, fromMigrate, slots[i].opTime, slots[i].hash));
+        writers.emplace_back(BSONObj(frames.buf() + frameOffsets[i]), begin[i]);
     }
 
     std::unique_ptr<DocWriter const* []> basePtrs(new DocWriter const*[count]);
@@ -293,10 +293,21 @@ void Balancer::report(OperationContext* txn, BSONObjBuilder* builder) {
 
     const auto mode = balancerConfig->getBalancerMode();
 
-    stdx::lock_guard<stdx::mutex> scopedLock(_mutex);
-    builder->append("mode", BalancerSettingsType::kBalancerModes[mode]);
-    builder->append("inBalancerRound", _inBalancerRound);
-    builder->append("numBalancerRounds", _numBalancerRounds);
+    {
+        stdx::lock_guard<stdx::mutex> scopedLock(_mutex);
+        builder->append("mode", BalancerSettingsType::kBalancerModes[mode]);
+        builder->append("inBalancerRound", _inBalancerRound);
+        builder->append("numBalancerRounds", _numBalancerRounds);
+
+        BSONObjBuilder lastRoundBuilder(builder->subobjStart("lastMigrationRound"));
+        lastRoundBuilder.append("scheduled", _lastMigrationRoundNumScheduled);
+        lastRoundBuilder.append("completed", _lastMigrationRoundNumCompleted);
+        lastRoundBuilder.append("durationMillis",
+                                durationCount<Milliseconds>(_lastMigrationRoundDuration));
+        lastRoundBuilder.doneFast();
+    }
+
+    _migrationManager.report(builder);
 }
 
 void Balancer::_mainThread() {
@@ -382,8 +393,16 @@ void Balancer::_mainThread() {
                     LOG(1) << "no need to move any chunk";
                     _balancedLastTime = false;
                 } else {
+                    Timer migrationRoundTimer;
                     _balancedLastTime = _moveChunks(txn.get(), candidateChunks);
 
+                    {
+                        stdx::lock_guard<stdx::mutex> scopedLock(_mutex);
+                        _lastMigrationRoundNumScheduled = static_cast<int>(candidateChunks.size());
+                        _lastMigrationRoundNumCompleted = _balancedLastTime;
+                        _lastMigrationRoundDuration = Milliseconds(migrationRoundTimer.millis());
+                    }
+
                     roundDetails.setSucceeded(static_cast<int>(candidateChunks.size()),
                                               _balancedLastTime);
 
@@ -638,7 +657,7 @@ void Balancer::_splitOrMarkJumbo(OperationContext* txn,
                                                   ChunkRange(chunk->getMin(), chunk->getMax()),
                                                   splitPoints));
     } catch (const DBException& ex) {
-        chunk->markAsJumbo(txn);
+        chunk->markAsJumbo(txn, nss);
     }
 }
 
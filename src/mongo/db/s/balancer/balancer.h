@@ -229,6 +229,12 @@ private:
     // Counts the number of balancing rounds performed since the balancer thread was first activated
     int64_t _numBalancerRounds{0};
 
+    // Number of migrations scheduled and completed by the last balancer round, which moved chunks,
+    // and how long it took them to complete
+    int _lastMigrationRoundNumScheduled{0};
+    int _lastMigrationRoundNumCompleted{0};
+    Milliseconds _lastMigrationRoundDuration{0};
+
     // Condition variable, which is signalled every time the above runtime state of the balancer
     // changes (in particular, state/balancer round and number of balancer rounds).
     stdx::condition_variable _condVar;
@@ -184,6 +184,21 @@ public:
                                             const DistributionStatus& distribution,
                                             bool shouldAggressivelyBalance);
 
+    /**
+     * Same as above, but skips the shards contained in 'usedShards' and adds to it the donor and
+     * recipient shards of each returned migration. Used to select migrations for multiple
+     * collections in the same balancer round, without scheduling more than one migration per
+     * shard, which the shards would reject.
+     *
+     * The limit of one migration per shard is not configurable. A shard's ActiveMigrationsRegistry
+     * admits a single donation or receipt at a time, and its MigrationDestinationManager runs a
+     * single session.
+     */
+    static std::vector<MigrateInfo> balance(const ShardStatisticsVector& shardStats,
+                                            const DistributionStatus& distribution,
+                                            bool shouldAggressivelyBalance,
+                                            std::set<ShardId>* usedShards);
+
     /**
      * Using the specified distribution information, returns a suggested better location for the
      * specified chunk if one is available.
@@ -40,6 +40,7 @@
 #include "mongo/db/client.h"
 #include "mongo/db/s/balancer/scoped_migration_request.h"
 #include "mongo/db/s/balancer/type_migration.h"
+#include "mongo/db/service_context.h"
 #include "mongo/executor/task_executor_pool.h"
 #include "mongo/rpc/get_status_from_command_result.h"
 #include "mongo/s/catalog/sharding_catalog_client.h"
@@ -47,6 +48,7 @@
 #include "mongo/s/grid.h"
 #include "mongo/s/move_chunk_request.h"
 #include "mongo/s/sharding_raii.h"
+#include "mongo/util/clock_source.h"
 #include "mongo/util/log.h"
 #include "mongo/util/net/hostandport.h"
 #include "mongo/util/scopeguard.h"
@@ -501,6 +503,8 @@ void MigrationManager::_schedule_inlock(OperationContext* txn,
 
     auto migrations = &it->second;
 
+    migration.scheduledAt = txn->getServiceContext()->getFastClockSource()->now();
+
     // Add ourselves to the list of migrations on this collection
     migrations->push_front(std::move(migration));
     auto itMigration = migrations->begin();
@@ -538,6 +542,16 @@ void MigrationManager::_complete_inlock(OperationContext* txn,
     // still acquired.
     auto notificationToSignal = itMigration->completionNotification;
 
+    _totalMigrationsTime +=
+        txn->getServiceContext()->getFastClockSource()->now() - itMigration->scheduledAt;
+
+    if (remoteCommandResponse.isOK() &&
+        getStatusFromCommandResult(remoteCommandResponse.data).isOK()) {
+        _numMigrationsSucceeded++;
+    } else {
+        _numMigrationsFailed++;
+    }
+
     auto it = _activeMigrations.find(nss);
     invariant(it != _activeMigrations.end());
 
@@ -554,6 +568,22 @@ void MigrationManager::_complete_inlock(OperationContext* txn,
     notificationToSignal->set(remoteCommandResponse);
 }
 
+void MigrationManager::report(BSONObjBuilder* builder) {
+    stdx::lock_guard<stdx::mutex> lock(_mutex);
+
+    long long numMigrationsInProgress = 0;
+    for (const auto& entry : _activeMigrations) {
+        numMigrationsInProgress += entry.second.size();
+    }
+
+    BSONObjBuilder migrationsBuilder(builder->subobjStart("migrations"));
+    migrationsBuilder.append("inProgress", numMigrationsInProgress);
+    migrationsBuilder.append("succeeded", _numMigrationsSucceeded);
+    migrationsBuilder.append("failed", _numMigrationsFailed);
+    migrationsBuilder.append("totalTimeMillis", durationCount<Milliseconds>(_totalMigrationsTime));
+    migrationsBuilder.doneFast();
+}
+
 void MigrationManager::_checkDrained_inlock() {
     if (_state == State::kEnabled || _state == State::kRecovering) {
         return;
@@ -47,6 +47,7 @@
 
 namespace mongo {
 
+class BSONObjBuilder;
 class OperationContext;
 class ScopedMigrationRequest;
 class ServiceContext;
@@ -137,6 +138,12 @@ public:
      */
     void drainActiveMigrations();
 
+    /**
+     * Appends the number of currently scheduled migrations and the outcome statistics of the
+     * migrations completed since this process started to the specified builder.
+     */
+    void report(BSONObjBuilder* builder);
+
 private:
     // The current state of the migration manager
     enum class State {  // Allowed transitions:
@@ -159,6 +166,9 @@ private:
         // Command object representing the migration
         BSONObj moveChunkCmdObj;
 
+        // When was the migration scheduled
+        Date_t scheduledAt;
+
         // Callback handle for the migration network request. If the migration has not yet been sent
         // on the network, this value is not set.
         boost::optional<executor::TaskExecutor::CallbackHandle> callbackHandle;
@@ -267,6 +277,12 @@ private:
 
     // Maps collection namespaces to that collection's active migrations.
     CollectionMigrationsStateMap _activeMigrations;
+
+    // Outcome of the migrations completed since this process started and their cumulative running
+    // time, as reported by balancerStatus.
+    long long _numMigrationsSucceeded{0};
+    long long _numMigrationsFailed{0};
+    Milliseconds _totalMigrationsTime{0};
 };
 
 }  // namespace mongo
@@ -37,6 +37,7 @@
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/client.h"
 #include "mongo/db/db_raii.h"
+#include "mongo/db/exec/delete.h"
 #include "mongo/db/dbhelpers.h"
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/index/index_descriptor.h"
@@ -48,11 +49,13 @@
 #include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/s/sharding_state.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/write_concern.h"
 #include "mongo/executor/task_executor.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -68,17 +71,29 @@ const WriteConcernOptions kMajorityWriteConcern(WriteConcernOptions::kMajority,
                                                 WriteConcernOptions::SyncMode::UNSET,
                                                 Seconds(60));
 
+// Bounds for the number of documents the range deleter removes between waits for replication. Each
+// batch runs under a single collection lock without yielding, so it is also cut short once it has
+// held the lock for as long as a query would before yielding (internalQueryExecYieldPeriodMS).
+const int kMinDeleteBatchSize = 1;
+const int kMaxDeleteBatchSize = 1024;
+
+// If replicating a batch of deletes to a majority of nodes takes longer than this many
+// milliseconds, the range deleter reduces the size of its next batch. If it takes less than half
+// of it, the batch size is increased.
+MONGO_EXPORT_SERVER_PARAMETER(rangeDeleterTargetBatchReplicationMillis, int, 200);
+
 }  // unnamed namespace
 
-CollectionRangeDeleter::CollectionRangeDeleter(NamespaceString nss) : _nss(std::move(nss)) {}
+CollectionRangeDeleter::CollectionRangeDeleter(NamespaceString nss)
+    : _nss(std::move(nss)),
+      _batchSize(std::max(int(internalQueryExecYieldIterations.load()), kMinDeleteBatchSize)) {}
 
 void CollectionRangeDeleter::run() {
     Client::initThread(getThreadName().c_str());
     ON_BLOCK_EXIT([&] { Client::destroy(); });
     auto txn = cc().makeOperationContext().get();
 
-    const int maxToDelete = std::max(int(internalQueryExecYieldIterations.load()), 1);
-    bool hasNextRangeToClean = cleanupNextRange(txn, maxToDelete);
+    bool hasNextRangeToClean = cleanupNextRange(txn, _batchSize);
 
     // If there are more ranges to run, we add <this> back onto the task executor to run again.
     if (hasNextRangeToClean) {
@@ -90,6 +105,7 @@ void CollectionRangeDeleter::run() {
 }
 
 bool CollectionRangeDeleter::cleanupNextRange(OperationContext* txn, int maxToDelete) {
+    bool batchWasFull = false;
 
     {
         AutoGetCollection autoColl(txn, _nss, MODE_IX);
@@ -123,9 +139,13 @@ bool CollectionRangeDeleter::cleanupNextRange(OperationContext* txn, int maxToDe
             _rangeInProgress = boost::none;
             return metadataManager.hasRangesToClean();
         }
+
+        metadataManager.noteDocumentsDeleted(numDocumentsDeleted);
+        batchWasFull = numDocumentsDeleted >= maxToDelete;
     }
 
     // wait for replication
+    Timer replicationTimer;
     WriteConcernResult wcResult;
     auto currentClientOpTime = repl::ReplClientInfo::forClient(txn->getClient()).getLastOp();
     Status status = waitForWriteConcern(txn, currentClientOpTime, kMajorityWriteConcern, &wcResult);
@@ -134,6 +154,8 @@ bool CollectionRangeDeleter::cleanupNextRange(OperationContext* txn, int maxToDe
                   << " : " << status.reason();
     }
 
+    _adjustBatchSize(Milliseconds(replicationTimer.millis()), batchWasFull);
+
     return true;
 }
 
@@ -172,43 +194,74 @@ int CollectionRangeDeleter::_doDeletion(OperationContext* txn,
         return -1;
     }
 
+    // The collection lock is held for the entire batch, so it is sufficient to check that this
+    // node is still primary once, before starting
+    if (!repl::getGlobalReplicationCoordinator()->canAcceptWritesFor(_nss)) {
+        warning() << "stepped down from primary while deleting chunk; orphaning data in " << _nss
+                  << " in range [" << min << ", " << max << ")";
+        return 0;
+    }
+
+    DeleteStageParams deleteStageParams;
+    deleteStageParams.isMulti = true;
+    deleteStageParams.fromMigrate = true;
+    deleteStageParams.returnDeleted = true;
+
+    // Use a single index scan for the whole batch instead of seeking to the beginning of the range
+    // for each deleted document
+    auto exec = InternalPlanner::deleteWithIndexScan(txn,
+                                                     collection,
+                                                     deleteStageParams,
+                                                     desc,
+                                                     min,
+                                                     max,
+                                                     BoundInclusion::kIncludeStartKeyOnly,
+                                                     PlanExecutor::YIELD_MANUAL,
+                                                     InternalPlanner::FORWARD);
+
+    const Milliseconds maxLockTime(internalQueryExecYieldPeriodMS.load());
+    Timer lockTimer;
+
     int numDeleted = 0;
-    do {
-        auto exec = InternalPlanner::indexScan(txn,
-                                               collection,
-                                               desc,
-                                               min,
-                                               max,
-                                               BoundInclusion::kIncludeStartKeyOnly,
-                                               PlanExecutor::YIELD_MANUAL,
-                                               InternalPlanner::FORWARD,
-                                               InternalPlanner::IXSCAN_FETCH);
-        RecordId rloc;
-        BSONObj obj;
-        PlanExecutor::ExecState state = exec->getNext(&obj, &rloc);
+    while (numDeleted < maxToDelete) {
+        BSONObj deletedObj;
+        PlanExecutor::ExecState state = exec->getNext(&deletedObj, nullptr);
         if (state == PlanExecutor::IS_EOF) {
             break;
         }
         if (state == PlanExecutor::FAILURE || state == PlanExecutor::DEAD) {
             warning(LogComponent::kSharding)
                 << PlanExecutor::statestr(state) << " - cursor error while trying to delete " << min
-                << " to " << max << " in " << _nss << ": " << WorkingSetCommon::toStatusString(obj)
+                << " to " << max << " in " << _nss << ": "
+                << WorkingSetCommon::toStatusString(deletedObj)
                 << ", stats: " << Explain::getWinningPlanStats(exec.get());
             break;
         }
 
         invariant(PlanExecutor::ADVANCED == state);
-        WriteUnitOfWork wuow(txn);
-        if (!repl::getGlobalReplicationCoordinator()->canAcceptWritesFor(_nss)) {
-            warning() << "stepped down from primary while deleting chunk; orphaning data in "
-                      << _nss << " in range [" << min << ", " << max << ")";
+        numDeleted++;
+
+        if (Milliseconds(lockTimer.millis()) >= maxLockTime) {
             break;
         }
-        OpDebug* const nullOpDebug = nullptr;
-        collection->deleteDocument(txn, rloc, nullOpDebug, true);
-        wuow.commit();
-    } while (++numDeleted < maxToDelete);
+    }
+
     return numDeleted;
 }
 
+void CollectionRangeDeleter::_adjustBatchSize(Milliseconds replicationWait, bool batchWasFull) {
+    const Milliseconds target(rangeDeleterTargetBatchReplicationMillis.load());
+
+    if (replicationWait > target) {
+        _batchSize = std::max(_batchSize / 2, kMinDeleteBatchSize);
+    } else if (replicationWait < target / 2 && batchWasFull) {
+        // Batches which were cut short by the lock time limit do not show that a larger one would
+        // replicate quickly enough
+        _batchSize = std::min(_batchSize * 2, kMaxDeleteBatchSize);
+    }
+
+    LOG(2) << "Range deleter batch for " << _nss << " took " << replicationWait
+           << " to replicate, next batch size is " << _batchSize;
+}
+
 }  // namespace mongo
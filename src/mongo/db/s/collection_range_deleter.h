@@ -30,6 +30,7 @@
 #include "mongo/base/disallow_copying.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/s/catalog/type_chunk.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
@@ -60,7 +61,8 @@ public:
 
 private:
     /**
-     * Performs the deletion of up to maxToDelete entries within the range in progress.
+     * Performs the deletion of up to maxToDelete entries within the range in progress, stopping
+     * early once the collection lock has been held for internalQueryExecYieldPeriodMS.
      * This function will invariant if called while _rangeInProgress is not set.
      *
      * Returns the number of documents deleted (0 if deletion is finished), or -1 for error.
@@ -70,8 +72,18 @@ private:
                     const BSONObj& keyPattern,
                     int maxToDelete);
 
+    /**
+     * Adapts the number of documents to delete in the next batch to how long it took for the last
+     * batch to replicate to a majority of the nodes. The batch size only grows after batches which
+     * deleted as many documents as they were allowed to.
+     */
+    void _adjustBatchSize(Milliseconds replicationWait, bool batchWasFull);
+
     NamespaceString _nss;
 
+    // Number of documents to delete per batch when running in the background
+    int _batchSize;
+
     // Holds a range for which deletion has begun. If empty, then a new range
     // must be requested from rangesToClean
     boost::optional<ChunkRange> _rangeInProgress;
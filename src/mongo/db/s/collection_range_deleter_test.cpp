@@ -35,12 +35,14 @@
 #include "mongo/db/db_raii.h"
 #include "mongo/db/dbdirectclient.h"
 #include "mongo/db/keypattern.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/db/repl/replication_coordinator_mock.h"
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/s/sharding_state.h"
 #include "mongo/db/service_context_d_test_fixture.h"
 #include "mongo/s/chunk_version.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -188,6 +190,56 @@ TEST_F(CollectionRangeDeleterTest, MultipleCleanupNextRangeCallsToCleanOneRange)
     ASSERT_FALSE(rangeDeleter.cleanupNextRange(operationContext(), 1));
 }
 
+// Tests that a batch stops once it has held the collection lock for the yield period, even if it is
+// allowed to delete more documents.
+TEST_F(CollectionRangeDeleterTest, BatchIsLimitedByLockTime) {
+    const int originalYieldPeriodMS = internalQueryExecYieldPeriodMS.load();
+    internalQueryExecYieldPeriodMS.store(0);
+    ON_BLOCK_EXIT([&] { internalQueryExecYieldPeriodMS.store(originalYieldPeriodMS); });
+
+    CollectionRangeDeleter rangeDeleter(kNamespaceString);
+    _dbDirectClient->insert(kNamespaceString.toString(), BSON(kPattern << 1));
+    _dbDirectClient->insert(kNamespaceString.toString(), BSON(kPattern << 2));
+
+    _metadataManager->addRangeToClean(ChunkRange(BSON(kPattern << 0), BSON(kPattern << 10)));
+
+    ASSERT_TRUE(rangeDeleter.cleanupNextRange(operationContext(), 100));
+    ASSERT_EQUALS(1ULL,
+                  _dbDirectClient->count(kNamespaceString.toString(), BSON(kPattern << LT << 5)));
+
+    ASSERT_TRUE(rangeDeleter.cleanupNextRange(operationContext(), 100));
+    ASSERT_EQUALS(0ULL,
+                  _dbDirectClient->count(kNamespaceString.toString(), BSON(kPattern << LT << 5)));
+
+    ASSERT_FALSE(rangeDeleter.cleanupNextRange(operationContext(), 100));
+}
+
+// Tests that the number of pending ranges and deleted documents are reported.
+TEST_F(CollectionRangeDeleterTest, RangeDeletionStatsAreReported) {
+    CollectionRangeDeleter rangeDeleter(kNamespaceString);
+    _dbDirectClient->insert(kNamespaceString.toString(), BSON(kPattern << 1));
+    _dbDirectClient->insert(kNamespaceString.toString(), BSON(kPattern << 2));
+    _dbDirectClient->insert(kNamespaceString.toString(), BSON(kPattern << 3));
+
+    _metadataManager->addRangeToClean(ChunkRange(BSON(kPattern << 0), BSON(kPattern << 10)));
+
+    ASSERT_TRUE(rangeDeleter.cleanupNextRange(operationContext(), 2));
+
+    {
+        BSONObjBuilder builder;
+        _metadataManager->appendRangeDeletionStats(&builder);
+        ASSERT_BSONOBJ_EQ(BSON("rangesToClean" << 1 << "documentsDeleted" << 2), builder.obj());
+    }
+
+    ASSERT_TRUE(rangeDeleter.cleanupNextRange(operationContext(), 2));
+    ASSERT_FALSE(rangeDeleter.cleanupNextRange(operationContext(), 2));
+
+    {
+        BSONObjBuilder builder;
+        _metadataManager->appendRangeDeletionStats(&builder);
+        ASSERT_BSONOBJ_EQ(BSON("rangesToClean" << 0 << "documentsDeleted" << 3), builder.obj());
+    }
+}
 
 // Tests the case that there are two ranges to clean, each containing multiple documents.
 TEST_F(CollectionRangeDeleterTest, MultipleDocumentsInMultipleRangesToClean) {
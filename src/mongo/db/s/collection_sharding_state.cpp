@@ -147,6 +147,21 @@ void CollectionShardingState::clearMigrationSourceManager(OperationContext* txn)
     _sourceMgr = nullptr;
 }
 
+void CollectionShardingState::enterCriticalSection(OperationContext* txn) {
+    invariant(txn->lockState()->isCollectionLockedForMode(_nss.ns(), MODE_X));
+    invariant(!_critSecSignal);
+
+    _critSecSignal = std::make_shared<Notification<void>>();
+}
+
+void CollectionShardingState::exitCriticalSection(OperationContext* txn) {
+    invariant(txn->lockState()->isCollectionLockedForMode(_nss.ns(), MODE_X));
+    invariant(_critSecSignal);
+
+    _critSecSignal->set();
+    _critSecSignal.reset();
+}
+
 void CollectionShardingState::checkShardVersionOrThrow(OperationContext* txn) {
     string errmsg;
     ChunkVersion received;
@@ -338,6 +353,13 @@ bool CollectionShardingState::_checkShardVersionOk(OperationContext* txn,
         return false;
     }
 
+    if (_critSecSignal) {
+        *errmsg = str::stream() << "metadata commit in progress for " << _nss.ns();
+
+        OperationShardingState::get(txn).setMigrationCriticalSectionSignal(_critSecSignal);
+        return false;
+    }
+
     if (expectedShardVersion->isWriteCompatibleWith(*actualShardVersion)) {
         return true;
     }
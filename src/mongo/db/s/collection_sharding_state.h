@@ -35,6 +35,7 @@
 #include "mongo/base/string_data.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/s/metadata_manager.h"
+#include "mongo/util/concurrency/notification.h"
 
 namespace mongo {
 
@@ -137,6 +138,21 @@ public:
      */
     void clearMigrationSourceManager(OperationContext* txn);
 
+    /**
+     * Makes versioned operations on this collection fail with a stale shard version and wait for
+     * the critical section to be left before returning, the same way they do during the commit of
+     * a migration. Used by the database primary shard while it creates the initial chunks of a
+     * collection which is being sharded. Must be called with collection X lock and must be
+     * followed by a call to exitCriticalSection.
+     */
+    void enterCriticalSection(OperationContext* txn);
+
+    /**
+     * Leaves the critical section entered through enterCriticalSection and wakes up the operations
+     * which are waiting for it. Must be called with collection X lock.
+     */
+    void exitCriticalSection(OperationContext* txn);
+
     /**
      * Checks whether the shard version in the context is compatible with the shard version of the
      * collection locally and if not throws SendStaleConfigException populated with the expected and
@@ -154,6 +170,13 @@ public:
      */
     bool collectionIsSharded();
 
+    /**
+     * Appends the progress of the background deletion of orphaned ranges for this collection.
+     */
+    void appendRangeDeletionStats(BSONObjBuilder* builder) {
+        _metadataManager.appendRangeDeletionStats(builder);
+    }
+
     // Replication subsystem hooks. If this collection is serving as a source for migration, these
     // methods inform it of any changes to its contents.
 
@@ -204,6 +227,10 @@ private:
     // NOTE: The value is not owned by this class.
     MigrationSourceManager* _sourceMgr{nullptr};
 
+    // Set while the collection is in a critical section which is not part of a migration. Follows
+    // the same locking rules as '_sourceMgr'.
+    std::shared_ptr<Notification<void>> _critSecSignal;
+
     friend class CollectionRangeDeleter;
 };
 
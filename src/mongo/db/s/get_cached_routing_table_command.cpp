@@ -0,0 +1,142 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kSharding
+
+#include "mongo/platform/basic.h"
+
+#include <string>
+
+#include "mongo/db/auth/action_type.h"
+#include "mongo/db/auth/authorization_session.h"
+#include "mongo/db/auth/privilege.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/s/routing_metadata_cache.h"
+#include "mongo/db/s/sharding_state.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+namespace {
+
+// Space left in the reply for the fields other than the chunks
+const int kReplyOverhead = 1024;
+
+/**
+ * Internal sharding command run by mongos against the primary shard of a database in order to
+ * retrieve the routing table of a collection, which that shard persisted in its routing metadata
+ * cache. This allows a router without any routing information for the collection to only read the
+ * chunks which changed since from the config servers.
+ *
+ * Format:
+ * {
+ *   _getCachedRoutingTable: <string namespace>
+ * }
+ *
+ * Reply:
+ * {
+ *   epoch: <OID>,
+ *   collectionVersion: <Timestamp>,
+ *   chunks: [<chunk in the shard chunk format of type_chunk.h>, ...]
+ * }
+ *
+ * Returns NamespaceNotFound if there is no complete routing table in the cache and
+ * ExceededMemoryLimit if it does not fit in a single reply.
+ */
+class GetCachedRoutingTableCommand : public Command {
+public:
+    GetCachedRoutingTableCommand() : Command("_getCachedRoutingTable") {}
+
+    void help(std::stringstream& help) const override {
+        help << "Internal command, which is sent by mongos to the primary shard of a database. Do "
+                "not call directly. Returns the cached routing table of a collection.";
+    }
+
+    bool slaveOk() const override {
+        return false;
+    }
+
+    bool adminOnly() const override {
+        return true;
+    }
+
+    bool supportsWriteConcern(const BSONObj& cmd) const override {
+        return false;
+    }
+
+    Status checkAuthForCommand(Client* client,
+                               const std::string& dbname,
+                               const BSONObj& cmdObj) override {
+        if (!AuthorizationSession::get(client)->isAuthorizedForActionsOnResource(
+                ResourcePattern::forClusterResource(), ActionType::internal)) {
+            return Status(ErrorCodes::Unauthorized, "Unauthorized");
+        }
+        return Status::OK();
+    }
+
+    std::string parseNs(const std::string& dbname, const BSONObj& cmdObj) const override {
+        return parseNsFullyQualified(dbname, cmdObj);
+    }
+
+    bool run(OperationContext* txn,
+             const std::string& dbname,
+             BSONObj& cmdObj,
+             int options,
+             std::string& errmsg,
+             BSONObjBuilder& result) override {
+        uassertStatusOK(ShardingState::get(txn)->canAcceptShardedCommands());
+
+        const NamespaceString nss(parseNs(dbname, cmdObj));
+        uassert(ErrorCodes::InvalidNamespace,
+                str::stream() << "invalid namespace '" << nss.ns() << "' specified for command",
+                nss.isValid());
+
+        const auto routingTable =
+            uassertStatusOK(RoutingMetadataCache::readRoutingTable(txn, nss));
+
+        result.append("epoch", routingTable.collectionVersion.epoch());
+        result.append("collectionVersion", Timestamp(routingTable.collectionVersion.toLong()));
+
+        BSONArrayBuilder chunksBuilder(result.subarrayStart("chunks"));
+        for (const auto& chunk : routingTable.chunks) {
+            const BSONObj chunkObj = chunk.toShardBSON();
+            uassert(ErrorCodes::ExceededMemoryLimit,
+                    str::stream() << "cached routing table for " << nss.ns()
+                                  << " is too large to be returned",
+                    result.len() + chunkObj.objsize() + kReplyOverhead < BSONObjMaxUserSize);
+
+            chunksBuilder.append(chunkObj);
+        }
+        chunksBuilder.doneFast();
+
+        return true;
+    }
+
+} getCachedRoutingTableCmd;
+
+}  // namespace
+}  // namespace mongo
@@ -95,13 +95,16 @@ Status MetadataLoader::makeCollectionMetadata(OperationContext* txn,
                                               const string& ns,
                                               const string& shard,
                                               const CollectionMetadata* oldMetadata,
-                                              CollectionMetadata* metadata) {
+                                              CollectionMetadata* metadata,
+                                              const std::vector<ChunkType>* persistedChunks,
+                                              std::vector<ChunkType>* loadedChunks) {
     Status initCollectionStatus = _initCollection(txn, catalogClient, ns, shard, metadata);
     if (!initCollectionStatus.isOK()) {
         return initCollectionStatus;
     }
 
-    return _initChunks(txn, catalogClient, ns, shard, oldMetadata, metadata);
+    return _initChunks(
+        txn, catalogClient, ns, shard, oldMetadata, metadata, persistedChunks, loadedChunks);
 }
 
 Status MetadataLoader::_initCollection(OperationContext* txn,
@@ -134,7 +137,9 @@ Status MetadataLoader::_initChunks(OperationContext* txn,
                                    const string& ns,
                                    const string& shard,
                                    const CollectionMetadata* oldMetadata,
-                                   CollectionMetadata* metadata) {
+                                   CollectionMetadata* metadata,
+                                   const std::vector<ChunkType>* persistedChunks,
+                                   std::vector<ChunkType>* loadedChunks) {
     const OID epoch = metadata->getCollVersion().epoch();
 
     SCMConfigDiffTracker::MaxChunkVersionMap versionMap;
@@ -173,6 +178,28 @@ Status MetadataLoader::_initChunks(OperationContext* txn,
     SCMConfigDiffTracker differ(
         ns, &metadata->_chunksMap, &metadata->_collVersion, &versionMap, shard);
 
+    // Without usable old metadata, the locally persisted routing table (if any) can serve as the
+    // base for the diff instead, so that only the chunks changed since it was written need to be
+    // read from the config server
+    if (fullReload && persistedChunks && !persistedChunks->empty()) {
+        const int persistedApplied = differ.calculateConfigDiff(txn, *persistedChunks);
+        if (persistedApplied > 0) {
+            fullReload = false;
+
+            LOG(2) << "loading new chunks for collection " << ns
+                   << " using persisted routing table w/ version " << metadata->_collVersion
+                   << " and " << metadata->_chunksMap.size() << " chunks";
+        } else {
+            LOG(1) << "ignoring persisted routing table for collection " << ns
+                   << ", because it is not compatible with epoch " << epoch;
+
+            metadata->_chunksMap.clear();
+            metadata->_collVersion = ChunkVersion(0, 0, epoch);
+            versionMap.clear();
+            versionMap[shard] = metadata->_shardVersion;
+        }
+    }
+
     try {
         std::vector<ChunkType> chunks;
         const auto diffQuery = differ.configDiffQuery();
@@ -210,6 +237,11 @@ Status MetadataLoader::_initChunks(OperationContext* txn,
             metadata->fillRanges();
 
             invariant(metadata->isValid());
+
+            if (loadedChunks) {
+                *loadedChunks = std::move(chunks);
+            }
+
             return Status::OK();
         } else if (diffsApplied == 0) {
             // No chunks found, the collection is dropping or we're confused
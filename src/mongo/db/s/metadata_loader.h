@@ -29,12 +29,14 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include "mongo/base/status.h"
 
 namespace mongo {
 
 class ShardingCatalogClient;
+class ChunkType;
 class CollectionMetadata;
 class CollectionType;
 class OperationContext;
@@ -68,6 +70,13 @@ public:
      * Optionally, uses an 'oldMetadata' for the same 'ns'/'shard'; the contents of
      * 'oldMetadata' can help reducing the amount of data read from the config servers.
      *
+     * If 'oldMetadata' is not available, the complete routing table of the collection persisted
+     * locally by a previous refresh can be passed as 'persistedChunks' (in increasing version
+     * order) and serves the same purpose. It is ignored if it belongs to a different epoch.
+     *
+     * If 'loadedChunks' is not null, it receives the chunks which were read from the config server
+     * to build 'metadata', so that they can be persisted by the caller.
+     *
      * Locking note:
      *    + Must not be called in a DBLock, since this loads over the network
      *
@@ -86,7 +95,9 @@ public:
                                          const std::string& ns,
                                          const std::string& shard,
                                          const CollectionMetadata* oldMetadata,
-                                         CollectionMetadata* metadata);
+                                         CollectionMetadata* metadata,
+                                         const std::vector<ChunkType>* persistedChunks = nullptr,
+                                         std::vector<ChunkType>* loadedChunks = nullptr);
 
 private:
     /**
@@ -109,7 +120,7 @@ private:
     /**
      * Returns OK and fills in the chunk state of 'metadata' to portray the chunks of the
      * collection 'ns' that sit in 'shard'. If provided, uses the contents of 'oldMetadata'
-     * as a base (see description in initCollection above).
+     * or 'persistedChunks' as a base (see description in makeCollectionMetadata above).
      *
      * If information about the chunks can be accessed or is invalid, returns:
      * @return HostUnreachable if there was an error contacting the config servers
@@ -124,7 +135,9 @@ private:
                               const std::string& ns,
                               const std::string& shard,
                               const CollectionMetadata* oldMetadata,
-                              CollectionMetadata* metadata);
+                              CollectionMetadata* metadata,
+                              const std::vector<ChunkType>* persistedChunks,
+                              std::vector<ChunkType>* loadedChunks);
 };
 
 }  // namespace mongo
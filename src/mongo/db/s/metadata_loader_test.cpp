@@ -409,5 +409,83 @@ TEST_F(MetadataLoaderFixture, NoChunks) {
     future.timed_get(kFutureTimeout);
 }
 
+TEST_F(MetadataLoaderFixture, PersistedChunksUsedAsBase) {
+    const OID epoch = getMaxCollVersion().epoch();
+
+    ChunkType chunk1;
+    chunk1.setNS("test.foo");
+    chunk1.setMin(BSON("a" << MINKEY));
+    chunk1.setMax(BSON("a" << 0));
+    chunk1.setShard(ShardId("shard0000"));
+    chunk1.setVersion(ChunkVersion(1, 0, epoch));
+
+    ChunkType chunk2;
+    chunk2.setNS("test.foo");
+    chunk2.setMin(BSON("a" << 0));
+    chunk2.setMax(BSON("a" << MAXKEY));
+    chunk2.setShard(ShardId("shard0001"));
+    chunk2.setVersion(ChunkVersion(1, 1, epoch));
+
+    const std::vector<ChunkType> persistedChunks{chunk1, chunk2};
+
+    // The second chunk was moved to shard0000 since the routing table was persisted
+    ChunkType movedChunk(chunk2);
+    movedChunk.setShard(ShardId("shard0000"));
+    movedChunk.setVersion(ChunkVersion(2, 0, epoch));
+
+    auto future = launchAsync([&] {
+        CollectionMetadata metadata;
+        std::vector<ChunkType> loadedChunks;
+        auto status = MetadataLoader::makeCollectionMetadata(operationContext(),
+                                                             catalogClient(),
+                                                             "test.foo",
+                                                             "shard0000",
+                                                             NULL, /* no old metadata */
+                                                             &metadata,
+                                                             &persistedChunks,
+                                                             &loadedChunks);
+        ASSERT_OK(status);
+        ASSERT_EQUALS(2U, metadata.getNumChunks());
+        ASSERT_EQUALS(ChunkVersion(2, 0, epoch).toString(), metadata.getCollVersion().toString());
+        ASSERT_EQUALS(ChunkVersion(2, 0, epoch).toString(), metadata.getShardVersion().toString());
+        ASSERT_EQUALS(1U, loadedChunks.size());
+    });
+
+    expectFindOnConfigSendCollectionDefault();
+    expectFindOnConfigSendBSONObjVector(std::vector<BSONObj>{movedChunk.toConfigBSON()});
+
+    future.timed_get(kFutureTimeout);
+}
+
+TEST_F(MetadataLoaderFixture, PersistedChunksWithDifferentEpochIgnored) {
+    ChunkType chunk;
+    chunk.setNS("test.foo");
+    chunk.setMin(BSON("a" << MINKEY));
+    chunk.setMax(BSON("a" << MAXKEY));
+    chunk.setShard(ShardId("shard0000"));
+    chunk.setVersion(ChunkVersion(5, 0, OID::gen()));
+
+    const std::vector<ChunkType> persistedChunks{chunk};
+
+    auto future = launchAsync([&] {
+        CollectionMetadata metadata;
+        auto status = MetadataLoader::makeCollectionMetadata(operationContext(),
+                                                             catalogClient(),
+                                                             "test.foo",
+                                                             "shard0000",
+                                                             NULL, /* no old metadata */
+                                                             &metadata,
+                                                             &persistedChunks);
+        ASSERT_OK(status);
+        ASSERT_EQUALS(1U, metadata.getNumChunks());
+        ASSERT_TRUE(getMaxCollVersion().equals(metadata.getCollVersion()));
+    });
+
+    expectFindOnConfigSendCollectionDefault();
+    expectFindOnConfigSendChunksDefault();
+
+    future.timed_get(kFutureTimeout);
+}
+
 }  // namespace
 }  // namespace mongo
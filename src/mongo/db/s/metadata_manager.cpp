@@ -448,6 +448,17 @@ void MetadataManager::append(BSONObjBuilder* builder) {
     amrArr.done();
 }
 
+void MetadataManager::appendRangeDeletionStats(BSONObjBuilder* builder) {
+    stdx::lock_guard<stdx::mutex> scopedLock(_managerLock);
+    builder->appendNumber("rangesToClean", static_cast<long long>(_rangesToClean.size()));
+    builder->appendNumber("documentsDeleted", _numDocumentsDeleted);
+}
+
+void MetadataManager::noteDocumentsDeleted(long long numDeleted) {
+    stdx::lock_guard<stdx::mutex> scopedLock(_managerLock);
+    _numDocumentsDeleted += numDeleted;
+}
+
 bool MetadataManager::hasRangesToClean() {
     stdx::lock_guard<stdx::mutex> scopedLock(_managerLock);
     return !_rangesToClean.empty();
@@ -115,6 +115,17 @@ public:
      */
     void append(BSONObjBuilder* builder);
 
+    /**
+     * Appends the number of ranges pending deletion and the number of documents deleted by the
+     * collection range deleter so far to builder.
+     */
+    void appendRangeDeletionStats(BSONObjBuilder* builder);
+
+    /**
+     * Adds to the number of documents removed by the collection range deleter for this collection.
+     */
+    void noteDocumentsDeleted(long long numDeleted);
+
     /**
      * Returns true if _rangesToClean is not empty.
      */
@@ -223,6 +234,9 @@ private:
     // Set of ranges to be deleted. Indexed by the min key of the range.
     typedef BSONObjIndexedMap<RangeToCleanDescriptor> RangeToCleanMap;
     RangeToCleanMap _rangesToClean;
+
+    // Number of documents deleted from the ranges to clean since this object was created
+    long long _numDocumentsDeleted{0};
 };
 
 class ScopedCollectionMetadata {
@@ -43,6 +43,7 @@
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/s/start_chunk_clone_request.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/storage/record_fetcher.h"
 #include "mongo/executor/remote_command_request.h"
 #include "mongo/executor/remote_command_response.h"
 #include "mongo/executor/task_executor.h"
@@ -403,7 +404,8 @@ uint64_t MigrationChunkClonerSourceLegacy::getCloneBatchBufferAllocationSize() {
 
 Status MigrationChunkClonerSourceLegacy::nextCloneBatch(OperationContext* txn,
                                                         Collection* collection,
-                                                        BSONArrayBuilder* arrBuilder) {
+                                                        BSONArrayBuilder* arrBuilder,
+                                                        std::unique_ptr<RecordFetcher>* fetcher) {
     dassert(txn->lockState()->isCollectionLockedForMode(_args.getNss().ns(), MODE_IS));
 
     ElapsedTracker tracker(txn->getServiceContext()->getFastClockSource(),
@@ -412,6 +414,12 @@ Status MigrationChunkClonerSourceLegacy::nextCloneBatch(OperationContext* txn,
 
     stdx::lock_guard<stdx::mutex> sl(_mutex);
 
+    // The record ids are visited in storage order, so reuse a single cursor for the whole batch
+    // instead of positioning a new one for each document
+    auto cursor = collection->getCursor(txn);
+
+    const int arrSizeAtStart = arrBuilder->arrSize();
+
     std::set<RecordId>::iterator it;
 
     for (it = _cloneLocs.begin(); it != _cloneLocs.end(); ++it) {
@@ -421,16 +429,28 @@ Status MigrationChunkClonerSourceLegacy::nextCloneBatch(OperationContext* txn,
             break;
         }
 
-        Snapshotted<BSONObj> doc;
-        if (collection->findDoc(txn, *it, &doc)) {
+        // If the next document is not in memory, give the caller a chance to page it in without
+        // holding the collection lock, as long as this call has already made progress
+        if (fetcher && arrBuilder->arrSize() > arrSizeAtStart) {
+            if (auto recordFetcher = cursor->fetcherForId(*it)) {
+                recordFetcher->setup();
+                *fetcher = std::move(recordFetcher);
+                break;
+            }
+        }
+
+        auto record = cursor->seekExact(*it);
+        if (record) {
+            BSONObj doc = record->data.releaseToBson();
+
             // Use the builder size instead of accumulating the document sizes directly so that we
             // take into consideration the overhead of BSONArray indices.
             if (arrBuilder->arrSize() &&
-                (arrBuilder->len() + doc.value().objsize() + 1024) > BSONObjMaxUserSize) {
+                (arrBuilder->len() + doc.objsize() + 1024) > BSONObjMaxUserSize) {
                 break;
             }
 
-            arrBuilder->append(doc.value());
+            arrBuilder->append(doc);
         }
     }
 
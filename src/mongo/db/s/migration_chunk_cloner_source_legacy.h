@@ -49,6 +49,7 @@ class BSONObjBuilder;
 class Collection;
 class Database;
 class PlanExecutor;
+class RecordFetcher;
 class RecordId;
 
 class MigrationChunkClonerSourceLegacy final : public MigrationChunkClonerSource {
@@ -106,11 +107,16 @@ public:
      * give a chance to the caller to perform some form of yielding. It does not free or acquire any
      * locks on its own.
      *
+     * If 'fetcher' is specified and the next document to be cloned is not in memory, the method
+     * will also return early and set 'fetcher' to the RecordFetcher, which the caller should invoke
+     * after releasing the collection lock in order to page the document in.
+     *
      * NOTE: Must be called with the collection lock held in at least IS mode.
      */
     Status nextCloneBatch(OperationContext* txn,
                           Collection* collection,
-                          BSONArrayBuilder* arrBuilder);
+                          BSONArrayBuilder* arrBuilder,
+                          std::unique_ptr<RecordFetcher>* fetcher = nullptr);
 
     /**
      * Called by the recipient shard. Transfers the accummulated local mods from source to
@@ -41,6 +41,7 @@
 #include "mongo/db/s/migration_chunk_cloner_source_legacy.h"
 #include "mongo/db/s/migration_source_manager.h"
 #include "mongo/db/s/sharding_state.h"
+#include "mongo/db/storage/record_fetcher.h"
 
 /**
  * This file contains commands, which are specific to the legacy chunk cloner source.
@@ -159,16 +160,26 @@ public:
         int arrSizeAtPrevIteration = -1;
 
         while (!arrBuilder || arrBuilder->arrSize() > arrSizeAtPrevIteration) {
-            AutoGetActiveCloner autoCloner(txn, migrationSessionId);
+            std::unique_ptr<RecordFetcher> fetcher;
 
-            if (!arrBuilder) {
-                arrBuilder.emplace(autoCloner.getCloner()->getCloneBatchBufferAllocationSize());
-            }
+            {
+                AutoGetActiveCloner autoCloner(txn, migrationSessionId);
+
+                if (!arrBuilder) {
+                    arrBuilder.emplace(
+                        autoCloner.getCloner()->getCloneBatchBufferAllocationSize());
+                }
 
-            arrSizeAtPrevIteration = arrBuilder->arrSize();
+                arrSizeAtPrevIteration = arrBuilder->arrSize();
 
-            uassertStatusOK(autoCloner.getCloner()->nextCloneBatch(
-                txn, autoCloner.getColl(), arrBuilder.get_ptr()));
+                uassertStatusOK(autoCloner.getCloner()->nextCloneBatch(
+                    txn, autoCloner.getColl(), arrBuilder.get_ptr(), &fetcher));
+            }
+
+            // Page in the next document outside of the collection lock
+            if (fetcher) {
+                fetcher->fetch();
+            }
         }
 
         invariant(arrBuilder);
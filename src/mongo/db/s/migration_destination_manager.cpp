@@ -59,12 +59,14 @@
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage/mmap_v1/dur.h"
 #include "mongo/logger/ramlog.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/s/catalog/type_chunk.h"
 #include "mongo/s/shard_key_pattern.h"
 #include "mongo/stdx/chrono.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/queue.h"
 
 namespace mongo {
 
@@ -73,6 +75,13 @@ using str::stream;
 
 namespace {
 
+// Number of _migrateClone responses, which may be buffered on the recipient while the previous
+// batch is being applied
+const size_t kMaxCloneBatchesInFlight = 2;
+
+// Maximum number of cloned documents to insert under a single acquisition of the collection lock
+const int kCloneInsertGroupSize = 128;
+
 /**
  * Returns a human-readabale name of the migration manager's state.
  */
@@ -183,6 +192,86 @@ BSONObj createTransferModsRequest(const NamespaceString& nss, const MigrationSes
     return builder.obj();
 }
 
+/**
+ * Issues _migrateClone requests against the donor shard from a separate thread, so that the
+ * donor is already producing the next batches while the current one is being inserted locally.
+ * At most kMaxCloneBatchesInFlight responses are buffered. The sequence of responses ends with
+ * either an empty batch or a failed response.
+ *
+ * The connection must not be used by anyone else for as long as this object is alive.
+ */
+class CloneBatchPrefetcher {
+    MONGO_DISALLOW_COPYING(CloneBatchPrefetcher);
+
+public:
+    CloneBatchPrefetcher(DBClientBase* conn, BSONObj migrateCloneRequest)
+        : _conn(conn),
+          _migrateCloneRequest(std::move(migrateCloneRequest)),
+          _batches(kMaxCloneBatchesInFlight) {
+        _thread = stdx::thread([this] { _run(); });
+    }
+
+    ~CloneBatchPrefetcher() {
+        _inShutdown.store(true);
+
+        // Unblocks the fetching thread if it is waiting for space in the queue
+        _batches.clear();
+        _thread.join();
+    }
+
+    /**
+     * Blocks until the next response from the donor is available and returns it.
+     */
+    BSONObj next() {
+        return _batches.blockingPop();
+    }
+
+private:
+    void _run() {
+        while (!_inShutdown.load()) {
+            BSONObj res;
+            bool ok;
+
+            try {
+                ok = _conn->runCommand("admin", _migrateCloneRequest, res);
+            } catch (const DBException& ex) {
+                ok = false;
+                res = BSON("ok" << 0 << "errmsg" << ex.toString());
+            }
+
+            if (ok && !res["objects"].isABSONObj()) {
+                ok = false;
+                res = BSON("ok" << 0 << "errmsg"
+                                << "_migrateClone response is missing the objects array");
+            }
+
+            if (_inShutdown.load()) {
+                return;
+            }
+
+            _batches.push(res.getOwned());
+
+            if (!ok || res["objects"].Obj().isEmpty()) {
+                return;
+            }
+        }
+    }
+
+    // Connection to the donor shard, used exclusively by the fetching thread
+    DBClientBase* const _conn;
+
+    // The request to issue for each batch
+    const BSONObj _migrateCloneRequest;
+
+    // Set when the consumer no longer needs any more batches
+    AtomicBool _inShutdown{false};
+
+    // Responses received from the donor, which have not yet been consumed
+    BlockingQueue<BSONObj> _batches;
+
+    stdx::thread _thread;
+};
+
 // Enabling / disabling these fail points pauses / resumes MigrateStatus::_go(), the thread which
 // receives a chunk migration from the donor.
 MONGO_FP_DECLARE(migrateThreadHangAtStep1);
@@ -626,13 +715,16 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* txn,
         // 3. Initial bulk clone
         setState(CLONE);
 
-        const BSONObj migrateCloneRequest = createMigrateCloneRequest(_nss, *_sessionId);
+        // Keep the next batches in flight while the current one is being applied locally. The
+        // prefetcher owns the donor connection until it goes out of scope.
+        boost::optional<CloneBatchPrefetcher> prefetcher;
+        prefetcher.emplace(conn.get(), createMigrateCloneRequest(_nss, *_sessionId));
 
         while (true) {
-            BSONObj res;
-            if (!conn->runCommand("admin",
-                                  migrateCloneRequest,
-                                  res)) {  // gets array of objects to copy, in disk order
+            // Gets array of objects to copy, in disk order
+            BSONObj res = prefetcher->next();
+            if (!res["ok"].trueValue()) {
+                prefetcher.reset();
                 setState(FAIL);
                 _errmsg = "_migrateClone failed: ";
                 _errmsg += redact(res.toString());
@@ -642,8 +734,11 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* txn,
             }
 
             BSONObj arr = res["objects"].Obj();
-            int thisTime = 0;
+            if (arr.isEmpty())
+                break;
 
+            // Apply the documents in groups under a single write context and wait for the
+            // secondaries once per group, rather than once per document
             BSONObjIterator i(arr);
             while (i.more()) {
                 txn->checkForInterrupt();
@@ -653,38 +748,47 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* txn,
                     return;
                 }
 
-                BSONObj docToClone = i.next().Obj();
+                int numInGroup = 0;
+                long long bytesInGroup = 0;
+
                 {
                     OldClientWriteContext cx(txn, _nss.ns());
 
-                    BSONObj localDoc;
-                    if (willOverrideLocalId(txn,
-                                            _nss.ns(),
-                                            min,
-                                            max,
-                                            shardKeyPattern,
-                                            cx.db(),
-                                            docToClone,
-                                            &localDoc)) {
-                        string errMsg = str::stream() << "cannot migrate chunk, local document "
-                                                      << redact(localDoc)
-                                                      << " has same _id as cloned "
-                                                      << "remote document " << redact(docToClone);
-
-                        warning() << errMsg;
-
-                        // Exception will abort migration cleanly
-                        uasserted(16976, errMsg);
+                    while (i.more() && numInGroup < kCloneInsertGroupSize) {
+                        BSONObj docToClone = i.next().Obj();
+
+                        BSONObj localDoc;
+                        if (willOverrideLocalId(txn,
+                                                _nss.ns(),
+                                                min,
+                                                max,
+                                                shardKeyPattern,
+                                                cx.db(),
+                                                docToClone,
+                                                &localDoc)) {
+                            string errMsg = str::stream() << "cannot migrate chunk, local document "
+                                                          << redact(localDoc)
+                                                          << " has same _id as cloned "
+                                                          << "remote document "
+                                                          << redact(docToClone);
+
+                            warning() << errMsg;
+
+                            // Exception will abort migration cleanly
+                            uasserted(16976, errMsg);
+                        }
+
+                        Helpers::upsert(txn, _nss.ns(), docToClone, true);
+
+                        numInGroup++;
+                        bytesInGroup += docToClone.objsize();
                     }
-
-                    Helpers::upsert(txn, _nss.ns(), docToClone, true);
                 }
-                thisTime++;
 
                 {
                     stdx::lock_guard<stdx::mutex> statsLock(_mutex);
-                    _numCloned++;
-                    _clonedBytes += docToClone.objsize();
+                    _numCloned += numInGroup;
+                    _clonedBytes += bytesInGroup;
                 }
 
                 if (writeConcern.shouldWaitForOtherNodes()) {
@@ -701,11 +805,10 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* txn,
                     }
                 }
             }
-
-            if (thisTime == 0)
-                break;
         }
 
+        prefetcher.reset();
+
         timing.done(3);
         MONGO_FAIL_POINT_PAUSE_WHILE_SET(migrateThreadHangAtStep3);
     }
@@ -0,0 +1,399 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kSharding
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/s/routing_metadata_cache.h"
+
+#include <algorithm>
+#include <set>
+
+#include "mongo/bson/simple_bsonobj_comparator.h"
+#include "mongo/bson/util/bson_extract.h"
+#include "mongo/client/dbclientcursor.h"
+#include "mongo/db/dbdirectclient.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/repl/replication_coordinator.h"
+#include "mongo/rpc/get_status_from_command_result.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/log.h"
+
+namespace mongo {
+namespace {
+
+const char kId[] = "_id";
+const char kEpoch[] = "epoch";
+const char kLastRefreshedCollectionVersion[] = "lastRefreshedCollectionVersion";
+const char kRefreshing[] = "refreshing";
+
+// Maximum number of chunk documents to write with a single insert or delete command
+const size_t kMaxWriteBatchSize = 1000;
+
+// Namespaces whose cached routing table is currently being read or written, so that concurrent
+// refreshes of the same collection do not interleave their writes and readers never see a partially
+// applied update
+stdx::mutex namespacesInUseMutex;
+stdx::condition_variable namespacesInUseCondVar;
+std::set<std::string> namespacesInUse;
+
+/**
+ * Serializes all the accesses to the cached routing table of a collection for as long as it is in
+ * scope.
+ */
+class ScopedNamespaceLock {
+    MONGO_DISALLOW_COPYING(ScopedNamespaceLock);
+
+public:
+    ScopedNamespaceLock(OperationContext* txn, const NamespaceString& nss) : _ns(nss.ns()) {
+        stdx::unique_lock<stdx::mutex> lk(namespacesInUseMutex);
+        txn->waitForConditionOrInterrupt(
+            namespacesInUseCondVar, lk, [&] { return !namespacesInUse.count(_ns); });
+        namespacesInUse.insert(_ns);
+    }
+
+    ~ScopedNamespaceLock() {
+        stdx::lock_guard<stdx::mutex> lk(namespacesInUseMutex);
+        namespacesInUse.erase(_ns);
+        namespacesInUseCondVar.notify_all();
+    }
+
+private:
+    const std::string _ns;
+};
+
+Status getLastErrorStatus(DBDirectClient* client) {
+    const std::string error = client->getLastError();
+    if (!error.empty()) {
+        return {ErrorCodes::OperationFailed, error};
+    }
+
+    return Status::OK();
+}
+
+/**
+ * Returns the first error reported by a write command, if any.
+ */
+Status getWriteCommandStatus(const BSONObj& result) {
+    Status status = getStatusFromCommandResult(result);
+    if (!status.isOK()) {
+        return status;
+    }
+
+    const BSONElement writeErrors = result["writeErrors"];
+    if (writeErrors.type() == Array && !writeErrors.Obj().isEmpty()) {
+        const BSONObj writeError = writeErrors.Obj().firstElement().Obj();
+        return {ErrorCodes::fromInt(writeError["code"].numberInt()), writeError["errmsg"].str()};
+    }
+
+    return Status::OK();
+}
+
+Status insertChunks(DBDirectClient* client,
+                    const NamespaceString& chunksNss,
+                    std::vector<ChunkType>::const_iterator begin,
+                    std::vector<ChunkType>::const_iterator end) {
+    std::vector<BSONObj> batch;
+    batch.reserve(end - begin);
+    for (auto it = begin; it != end; ++it) {
+        batch.push_back(it->toShardBSON());
+    }
+
+    client->insert(chunksNss.ns(), batch);
+    return getLastErrorStatus(client);
+}
+
+/**
+ * Removes all the cached chunks which overlap any of the chunks in [begin, end) with a single
+ * delete command.
+ */
+Status removeOverlappingChunks(DBDirectClient* client,
+                               const NamespaceString& chunksNss,
+                               std::vector<ChunkType>::const_iterator begin,
+                               std::vector<ChunkType>::const_iterator end) {
+    BSONArrayBuilder deletes;
+    for (auto it = begin; it != end; ++it) {
+        deletes.append(BSON("q" << BSON(ChunkType::minShardID() << BSON("$lt" << it->getMax())
+                                                                 << ChunkType::max()
+                                                                 << BSON("$gt" << it->getMin()))
+                                << "limit"
+                                << 0));
+    }
+
+    BSONObj result;
+    client->runCommand(
+        chunksNss.db().toString(),
+        BSON("delete" << chunksNss.coll() << "deletes" << deletes.arr() << "ordered" << true),
+        result);
+    return getWriteCommandStatus(result);
+}
+
+Status dropRoutingTableInLock(DBDirectClient* client, const NamespaceString& nss) {
+    // Remove the entry first, so that the chunks are never read without it
+    client->remove(RoutingMetadataCache::kCollectionsNss.ns(), BSON(kId << nss.ns()));
+    Status status = getLastErrorStatus(client);
+    if (!status.isOK()) {
+        return status;
+    }
+
+    client->dropCollection(RoutingMetadataCache::getChunksNss(nss).ns());
+
+    return Status::OK();
+}
+
+bool allOfType(BSONType type, const BSONObj& o) {
+    for (const auto& elem : o) {
+        if (elem.type() != type) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+}  // namespace
+
+const NamespaceString RoutingMetadataCache::kCollectionsNss("config.cache.collections");
+
+NamespaceString RoutingMetadataCache::getChunksNss(const NamespaceString& nss) {
+    return NamespaceString(str::stream() << "config.cache.chunks." << nss.ns());
+}
+
+StatusWith<RoutingMetadataCache::RoutingTable> RoutingMetadataCache::readRoutingTable(
+    OperationContext* txn, const NamespaceString& nss) {
+    try {
+        ScopedNamespaceLock nsLock(txn, nss);
+        DBDirectClient client(txn);
+
+        const BSONObj entry = client.findOne(kCollectionsNss.ns(), BSON(kId << nss.ns()));
+        if (entry.isEmpty()) {
+            return {ErrorCodes::NamespaceNotFound,
+                    str::stream() << "no cached routing table for " << nss.ns()};
+        }
+
+        if (entry[kRefreshing].trueValue()) {
+            return {ErrorCodes::ConflictingOperationInProgress,
+                    str::stream() << "cached routing table for " << nss.ns()
+                                  << " was not completely written"};
+        }
+
+        OID epoch;
+        Status status = bsonExtractOIDField(entry, kEpoch, &epoch);
+        if (!status.isOK()) {
+            return status;
+        }
+
+        Timestamp lastRefreshedCollectionVersion;
+        status = bsonExtractTimestampField(
+            entry, kLastRefreshedCollectionVersion, &lastRefreshedCollectionVersion);
+        if (!status.isOK()) {
+            return status;
+        }
+
+        RoutingTable routingTable;
+        routingTable.collectionVersion = ChunkVersion(lastRefreshedCollectionVersion.getSecs(),
+                                                      lastRefreshedCollectionVersion.getInc(),
+                                                      epoch);
+
+        // Read the chunks in key order in order to check that they cover the entire key space
+        ChunkVersion maxVersion(0, 0, epoch);
+        BSONObj lastMax;
+
+        auto cursor =
+            client.query(getChunksNss(nss).ns(), Query().sort(BSON(ChunkType::minShardID() << 1)));
+        while (cursor->more()) {
+            auto statusWithChunk = ChunkType::fromShardBSON(cursor->nextSafe(), epoch);
+            if (!statusWithChunk.isOK()) {
+                return statusWithChunk.getStatus();
+            }
+
+            ChunkType chunk = std::move(statusWithChunk.getValue());
+            chunk.setNS(nss.ns());
+
+            const bool isContiguous = lastMax.isEmpty()
+                ? allOfType(MinKey, chunk.getMin())
+                : SimpleBSONObjComparator::kInstance.evaluate(lastMax == chunk.getMin());
+            if (!isContiguous) {
+                return {ErrorCodes::IncompatibleShardingMetadata,
+                        str::stream() << "cached routing table for " << nss.ns()
+                                      << " has a gap or overlap at "
+                                      << chunk.getMin()};
+            }
+
+            lastMax = chunk.getMax();
+
+            if (chunk.getVersion() > maxVersion) {
+                maxVersion = chunk.getVersion();
+            }
+
+            routingTable.chunks.push_back(std::move(chunk));
+        }
+
+        if (routingTable.chunks.empty() || !allOfType(MaxKey, lastMax) ||
+            !maxVersion.equals(routingTable.collectionVersion)) {
+            return {ErrorCodes::IncompatibleShardingMetadata,
+                    str::stream() << "cached routing table for " << nss.ns()
+                                  << " is inconsistent with its collection version "
+                                  << routingTable.collectionVersion.toString()};
+        }
+
+        // The config diff tracker expects chunks in increasing version order
+        std::sort(routingTable.chunks.begin(),
+                  routingTable.chunks.end(),
+                  [](const ChunkType& lhs, const ChunkType& rhs) {
+                      return lhs.getVersion() < rhs.getVersion();
+                  });
+
+        return std::move(routingTable);
+    } catch (const DBException& ex) {
+        return ex.toStatus();
+    }
+}
+
+Status RoutingMetadataCache::updateRoutingTable(OperationContext* txn,
+                                                const NamespaceString& nss,
+                                                const ChunkVersion& baseVersion,
+                                                const ChunkVersion& collectionVersion,
+                                                const std::vector<ChunkType>& chunks) {
+    invariant(!txn->lockState()->isLocked());
+
+    // Only the primary maintains the cache, the secondaries receive it through replication
+    if (!repl::ReplicationCoordinator::get(txn)->canAcceptWritesForDatabase(
+            kCollectionsNss.db())) {
+        return Status::OK();
+    }
+
+    const auto chunksNss = getChunksNss(nss);
+
+    try {
+        // The check of the cached version below and the writes which follow it must not interleave
+        // with another refresh of the same collection
+        ScopedNamespaceLock nsLock(txn, nss);
+        DBDirectClient client(txn);
+
+        if (baseVersion.isSet()) {
+            // A diff can only be applied on top of the exact routing table it was computed against
+            const BSONObj entry = client.findOne(kCollectionsNss.ns(), BSON(kId << nss.ns()));
+
+            const bool isAtBaseVersion = !entry.isEmpty() && !entry[kRefreshing].trueValue() &&
+                entry[kEpoch].type() == jstOID && entry[kEpoch].OID() == baseVersion.epoch() &&
+                entry[kLastRefreshedCollectionVersion].type() == bsonTimestamp &&
+                entry[kLastRefreshedCollectionVersion].timestamp() ==
+                    Timestamp(baseVersion.toLong());
+            if (!isAtBaseVersion) {
+                if (!entry.isEmpty()) {
+                    Status status = dropRoutingTableInLock(&client, nss);
+                    if (!status.isOK()) {
+                        return status;
+                    }
+                }
+
+                return {ErrorCodes::IncompatibleShardingMetadata,
+                        str::stream() << "cached routing table for " << nss.ns()
+                                      << " is not at version "
+                                      << baseVersion.toString()};
+            }
+        }
+
+        // Mark the cached routing table as incomplete for the duration of the update
+        client.update(kCollectionsNss.ns(),
+                      BSON(kId << nss.ns()),
+                      BSON("$set" << BSON(kEpoch << collectionVersion.epoch() << kRefreshing
+                                                 << true)),
+                      true /* upsert */);
+        Status status = getLastErrorStatus(&client);
+        if (!status.isOK()) {
+            return status;
+        }
+
+        if (!baseVersion.isSet()) {
+            client.dropCollection(chunksNss.ns());
+        }
+
+        // Apply the changes in batches. The chunks loaded from the config server never overlap each
+        // other, so all the cached chunks which overlap any chunk of a batch can be removed before
+        // the batch is inserted.
+        for (auto begin = chunks.begin(); begin != chunks.end();) {
+            const auto end =
+                begin + std::min(kMaxWriteBatchSize, static_cast<size_t>(chunks.end() - begin));
+
+            if (baseVersion.isSet()) {
+                status = removeOverlappingChunks(&client, chunksNss, begin, end);
+                if (!status.isOK()) {
+                    return status;
+                }
+            }
+
+            status = insertChunks(&client, chunksNss, begin, end);
+            if (!status.isOK()) {
+                return status;
+            }
+
+            begin = end;
+        }
+
+        client.update(kCollectionsNss.ns(),
+                      BSON(kId << nss.ns()),
+                      BSON("$set" << BSON(kRefreshing << false << kLastRefreshedCollectionVersion
+                                                      << Timestamp(collectionVersion.toLong()))));
+        status = getLastErrorStatus(&client);
+        if (!status.isOK()) {
+            return status;
+        }
+
+        LOG(1) << "Persisted " << chunks.size() << " chunks of " << nss.ns()
+               << " in the routing metadata cache at version " << collectionVersion;
+
+        return Status::OK();
+    } catch (const DBException& ex) {
+        return ex.toStatus();
+    }
+}
+
+Status RoutingMetadataCache::dropRoutingTable(OperationContext* txn, const NamespaceString& nss) {
+    invariant(!txn->lockState()->isLocked());
+
+    if (!repl::ReplicationCoordinator::get(txn)->canAcceptWritesForDatabase(
+            kCollectionsNss.db())) {
+        return Status::OK();
+    }
+
+    try {
+        ScopedNamespaceLock nsLock(txn, nss);
+        DBDirectClient client(txn);
+
+        return dropRoutingTableInLock(&client, nss);
+    } catch (const DBException& ex) {
+        return ex.toStatus();
+    }
+}
+
+}  // namespace mongo
@@ -0,0 +1,120 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "mongo/s/catalog/type_chunk.h"
+#include "mongo/s/chunk_version.h"
+
+namespace mongo {
+
+class NamespaceString;
+class OperationContext;
+class Status;
+template <typename T>
+class StatusWith;
+
+/**
+ * Manages the copy of the collection routing tables, which the primary of a shard persists locally
+ * every time it refreshes its metadata from the config servers. After a restart (or a stepdown) a
+ * shard can rebuild its metadata from this cache and only needs to fetch the chunks which changed
+ * since the last refresh from the config servers, instead of the complete routing table.
+ *
+ * The cache consists of one entry per collection in the config.cache.collections collection:
+ *
+ * { _id: "test.foo",
+ *   epoch: ObjectId("587fc60cef168288439ad6ed"),
+ *   lastRefreshedCollectionVersion: Timestamp(3, 12),
+ *   refreshing: false }
+ *
+ * and of the chunks of each collection (for all shards) in a config.cache.chunks.<ns> collection,
+ * using the shard chunk format described in type_chunk.h. The 'refreshing' flag is set for the
+ * duration of each update of the chunks, so that a partially applied update is never mistaken for a
+ * complete routing table. All the reads and updates of the cache for the same collection are
+ * serialized.
+ *
+ * Routers without any routing information for a collection retrieve the cached routing table from
+ * the primary shard of its database through the _getCachedRoutingTable command.
+ */
+class RoutingMetadataCache {
+public:
+    static const NamespaceString kCollectionsNss;
+
+    /**
+     * Complete routing table of a collection, as persisted in the cache.
+     */
+    struct RoutingTable {
+        // Highest version across all the chunks
+        ChunkVersion collectionVersion;
+
+        // All the chunks of the collection, in increasing version order
+        std::vector<ChunkType> chunks;
+    };
+
+    /**
+     * Returns the namespace of the collection holding the cached chunks for 'nss'.
+     */
+    static NamespaceString getChunksNss(const NamespaceString& nss);
+
+    /**
+     * Reads the persisted routing table for 'nss'. Returns NamespaceNotFound if there is no
+     * complete routing table for the collection in the cache, or any other error if the cache
+     * could not be read or is inconsistent.
+     */
+    static StatusWith<RoutingTable> readRoutingTable(OperationContext* txn,
+                                                     const NamespaceString& nss);
+
+    /**
+     * Applies to the persisted routing table of 'nss' the chunks, which were loaded from the config
+     * server on top of 'baseVersion' and brought the collection to 'collectionVersion'. If
+     * 'baseVersion' is not set, 'chunks' must contain the full routing table, which replaces the
+     * currently cached one.
+     *
+     * Incremental updates are only applied if the cache is currently at exactly 'baseVersion',
+     * otherwise the cached entry (if any) is invalidated and IncompatibleShardingMetadata is
+     * returned. The cache will be written again by the next full reload.
+     *
+     * Must not be called while holding any locks and is a no-op unless this node can accept writes
+     * for the config database.
+     */
+    static Status updateRoutingTable(OperationContext* txn,
+                                     const NamespaceString& nss,
+                                     const ChunkVersion& baseVersion,
+                                     const ChunkVersion& collectionVersion,
+                                     const std::vector<ChunkType>& chunks);
+
+    /**
+     * Removes any cached routing information for 'nss'.
+     */
+    static Status dropRoutingTable(OperationContext* txn, const NamespaceString& nss);
+};
+
+}  // namespace mongo
@@ -48,9 +48,11 @@
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/s/metadata_loader.h"
 #include "mongo/db/s/operation_sharding_state.h"
+#include "mongo/db/s/routing_metadata_cache.h"
 #include "mongo/db/s/sharded_connection_info.h"
 #include "mongo/db/s/sharding_initialization_mongod.h"
 #include "mongo/db/s/type_shard_identity.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/executor/network_interface_factory.h"
 #include "mongo/executor/network_interface_thread_pool.h"
 #include "mongo/executor/task_executor_pool.h"
@@ -89,6 +91,10 @@ const int kMaxConfigServerRefreshThreads = 3;
 // Maximum number of times to try to refresh the collection metadata if conflicts are occurring
 const int kMaxNumMetadataRefreshAttempts = 3;
 
+// Whether the shard primary should persist the routing tables it loads from the config server, so
+// that they can be reused as the base for the next refresh after a restart
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(persistRoutingMetadataCache, bool, true);
+
 /**
  * Updates the config server field of the shardIdentity document with the given connection string
  * if setName is equal to the config server replica set name.
@@ -490,6 +496,23 @@ StatusWith<ChunkVersion> ShardingState::_refreshMetadata(
     int numAttempts = 0;
     std::unique_ptr<CollectionMetadata> remoteMetadata;
 
+    // Without in-memory metadata to diff against, start from the locally persisted routing table so
+    // that only the chunks which changed since it was written need to be read from the config
+    // server
+    RoutingMetadataCache::RoutingTable persistedRoutingTable;
+    if (!metadataForDiff && persistRoutingMetadataCache) {
+        auto statusWithRoutingTable = RoutingMetadataCache::readRoutingTable(txn, nss);
+        if (statusWithRoutingTable.isOK()) {
+            persistedRoutingTable = std::move(statusWithRoutingTable.getValue());
+        } else if (statusWithRoutingTable != ErrorCodes::NamespaceNotFound) {
+            warning() << "Unable to use the persisted routing table for " << nss.ns()
+                      << causedBy(redact(statusWithRoutingTable.getStatus()));
+        }
+    }
+
+    ChunkVersion baseVersion;
+    std::vector<ChunkType> loadedChunks;
+
     do {
         // The _configServerTickets serializes this process such that only a small number of threads
         // can try to refresh at the same time in order to avoid overloading the config server.
@@ -498,22 +521,60 @@ StatusWith<ChunkVersion> ShardingState::_refreshMetadata(
 
         if (status == ErrorCodes::RemoteChangeDetected) {
             metadataForDiff = nullptr;
+            persistedRoutingTable = RoutingMetadataCache::RoutingTable();
             log() << "Refresh failed and will be retried as full reload " << status;
         }
 
+        if (metadataForDiff) {
+            baseVersion = metadataForDiff->getCollVersion();
+        } else if (!persistedRoutingTable.chunks.empty()) {
+            baseVersion = persistedRoutingTable.collectionVersion;
+        } else {
+            baseVersion = ChunkVersion();
+        }
+
         log() << "MetadataLoader loading chunks for " << nss.ns() << " based on: "
-              << (metadataForDiff ? metadataForDiff->getCollVersion().toString() : "(empty)");
+              << (metadataForDiff ? metadataForDiff->getCollVersion().toString()
+                                  : (baseVersion.isSet()
+                                         ? "persisted routing table " + baseVersion.toString()
+                                         : std::string("(empty)")));
 
         remoteMetadata = stdx::make_unique<CollectionMetadata>();
+        loadedChunks.clear();
         status = MetadataLoader::makeCollectionMetadata(txn,
                                                         grid.catalogClient(txn),
                                                         nss.ns(),
                                                         getShardName(),
                                                         metadataForDiff,
-                                                        remoteMetadata.get());
+                                                        remoteMetadata.get(),
+                                                        &persistedRoutingTable.chunks,
+                                                        &loadedChunks);
     } while (status == ErrorCodes::RemoteChangeDetected &&
              ++numAttempts < kMaxNumMetadataRefreshAttempts);
 
+    if (persistRoutingMetadataCache && (status.isOK() || status == ErrorCodes::NamespaceNotFound)) {
+        // The persisted routing table is only an optimization, so failing to update it must not
+        // fail the refresh. The next refresh which cannot apply its changes will rewrite it.
+        Status persistStatus = status.isOK()
+            ? RoutingMetadataCache::updateRoutingTable(txn,
+                                                       nss,
+                                                       // A different epoch means a full reload
+                                                       baseVersion.hasEqualEpoch(
+                                                           remoteMetadata->getCollVersion())
+                                                           ? baseVersion
+                                                           : ChunkVersion(),
+                                                       remoteMetadata->getCollVersion(),
+                                                       loadedChunks)
+            : RoutingMetadataCache::dropRoutingTable(txn, nss);
+        if (persistStatus == ErrorCodes::IncompatibleShardingMetadata) {
+            LOG(1) << "Not updating the persisted routing table for " << nss.ns()
+                   << causedBy(redact(persistStatus));
+        } else if (!persistStatus.isOK()) {
+            warning() << "Failed to update the persisted routing table for " << nss.ns()
+                      << causedBy(redact(persistStatus));
+        }
+    }
+
     if (!status.isOK() && status != ErrorCodes::NamespaceNotFound) {
         warning() << "MetadataLoader failed after " << t.millis() << " ms"
                   << causedBy(redact(status));
@@ -590,6 +651,15 @@ void ShardingState::appendInfo(OperationContext* txn, BSONObjBuilder& builder) {
     }
 
     versionB.done();
+
+    BSONObjBuilder rangeDeletionB(builder.subobjStart("rangeDeletion"));
+    for (const auto& entry : _collections) {
+        BSONObjBuilder collB(rangeDeletionB.subobjStart(entry.first));
+        entry.second->appendRangeDeletionStats(&collB);
+        collB.doneFast();
+    }
+
+    rangeDeletionB.done();
 }
 
 bool ShardingState::needCollectionMetadata(OperationContext* txn, const string& ns) {
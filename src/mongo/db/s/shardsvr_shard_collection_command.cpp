@@ -0,0 +1,241 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kSharding
+
+#include "mongo/platform/basic.h"
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include "mongo/bson/util/bson_extract.h"
+#include "mongo/db/auth/action_type.h"
+#include "mongo/db/auth/authorization_session.h"
+#include "mongo/db/auth/privilege.h"
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/s/collection_sharding_state.h"
+#include "mongo/db/s/sharding_state.h"
+#include "mongo/db/s/sharding_state_recovery.h"
+#include "mongo/s/catalog/sharding_catalog_client.h"
+#include "mongo/s/chunk_version.h"
+#include "mongo/s/grid.h"
+#include "mongo/s/shard_key_pattern.h"
+#include "mongo/util/fail_point_service.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+
+MONGO_FP_DECLARE(hangInShardCollectionCriticalSection);
+
+namespace {
+
+/**
+ * Internal sharding command run by mongos on the primary shard of a database to create the initial
+ * chunks of a collection of that database, which is being sharded.
+ *
+ * Format:
+ * {
+ *   _shardsvrShardCollection: <string namespace>,
+ *   key: <shard key pattern>,
+ *   unique: <bool>,
+ *   collation: <BSONObj default collation of the collection>,
+ *   initialSplitPoints: [<BSONObj key>, ...],
+ *   initShardIds: [<string shard>, ...]
+ * }
+ *
+ * The chunks are committed while the collection is in a critical section on this shard. Routers
+ * which still consider the collection unsharded cannot write to it on this shard until it has
+ * loaded the new metadata, so no document can be left in a chunk which was created on another
+ * shard. If the collection is no longer empty by the time the critical section is entered, all the
+ * chunks are created on this shard instead of being distributed over 'initShardIds'.
+ */
+class ShardsvrShardCollectionCommand : public Command {
+public:
+    ShardsvrShardCollectionCommand() : Command("_shardsvrShardCollection") {}
+
+    void help(std::stringstream& help) const override {
+        help << "Internal command, which is sent by mongos to the primary shard of a database. Do "
+                "not call directly. Creates the initial chunks of a collection being sharded.";
+    }
+
+    bool slaveOk() const override {
+        return false;
+    }
+
+    bool adminOnly() const override {
+        return true;
+    }
+
+    bool supportsWriteConcern(const BSONObj& cmd) const override {
+        return false;
+    }
+
+    Status checkAuthForCommand(Client* client,
+                               const std::string& dbname,
+                               const BSONObj& cmdObj) override {
+        if (!AuthorizationSession::get(client)->isAuthorizedForActionsOnResource(
+                ResourcePattern::forClusterResource(), ActionType::internal)) {
+            return Status(ErrorCodes::Unauthorized, "Unauthorized");
+        }
+        return Status::OK();
+    }
+
+    std::string parseNs(const std::string& dbname, const BSONObj& cmdObj) const override {
+        return parseNsFullyQualified(dbname, cmdObj);
+    }
+
+    bool run(OperationContext* txn,
+             const std::string& dbname,
+             BSONObj& cmdObj,
+             int options,
+             std::string& errmsg,
+             BSONObjBuilder& result) override {
+        auto shardingState = ShardingState::get(txn);
+        uassertStatusOK(shardingState->canAcceptShardedCommands());
+
+        const NamespaceString nss(parseNs(dbname, cmdObj));
+        uassert(ErrorCodes::InvalidNamespace,
+                str::stream() << "invalid namespace '" << nss.ns() << "' specified for command",
+                nss.isValid());
+
+        BSONElement keyElem;
+        uassertStatusOK(bsonExtractTypedField(cmdObj, "key", Object, &keyElem));
+        const ShardKeyPattern shardKeyPattern(keyElem.Obj().getOwned());
+        uassert(ErrorCodes::BadValue,
+                str::stream() << "invalid shard key pattern " << keyElem.Obj(),
+                shardKeyPattern.isValid());
+
+        bool unique;
+        uassertStatusOK(bsonExtractBooleanFieldWithDefault(cmdObj, "unique", false, &unique));
+
+        BSONObj defaultCollation;
+        {
+            BSONElement collationElem;
+            Status status = bsonExtractTypedField(cmdObj, "collation", Object, &collationElem);
+            if (status.isOK()) {
+                defaultCollation = collationElem.Obj().getOwned();
+            } else if (status != ErrorCodes::NoSuchKey) {
+                uassertStatusOK(status);
+            }
+        }
+
+        std::vector<BSONObj> splitPoints;
+        {
+            BSONElement splitPointsElem;
+            uassertStatusOK(
+                bsonExtractTypedField(cmdObj, "initialSplitPoints", Array, &splitPointsElem));
+            for (const auto& splitPointElem : splitPointsElem.Obj()) {
+                uassert(ErrorCodes::TypeMismatch,
+                        "initialSplitPoints must only contain objects",
+                        splitPointElem.type() == Object);
+                splitPoints.push_back(splitPointElem.Obj().getOwned());
+            }
+        }
+
+        std::set<ShardId> initShardIds;
+        {
+            BSONElement shardIdsElem;
+            uassertStatusOK(bsonExtractTypedField(cmdObj, "initShardIds", Array, &shardIdsElem));
+            for (const auto& shardIdElem : shardIdsElem.Obj()) {
+                uassert(ErrorCodes::TypeMismatch,
+                        "initShardIds must only contain strings",
+                        shardIdElem.type() == String);
+                initShardIds.insert(ShardId(shardIdElem.str()));
+            }
+        }
+
+        // Mark the shard as running critical operation, which requires recovery on crash
+        uassertStatusOK(ShardingStateRecovery::startMetadataOp(txn));
+        ON_BLOCK_EXIT([txn] { ShardingStateRecovery::endMetadataOp(txn); });
+
+        bool isEmpty;
+
+        {
+            // The critical section must be entered with collection X lock in order to ensure there
+            // are no writes which could have entered and passed the version check just before we
+            // entered the critical section, but managed to complete after we left it.
+            ScopedTransaction scopedXact(txn, MODE_IX);
+            AutoGetCollection autoColl(txn, nss, MODE_IX, MODE_X);
+
+            CollectionShardingState::get(txn, nss)->enterCriticalSection(txn);
+
+            Collection* const collection = autoColl.getCollection();
+            isEmpty = !collection || collection->numRecords(txn) == 0;
+        }
+
+        ON_BLOCK_EXIT([txn, &nss] {
+            ScopedTransaction scopedXact(txn, MODE_IX);
+            AutoGetCollection autoColl(txn, nss, MODE_IX, MODE_X);
+
+            CollectionShardingState::get(txn, nss)->exitCriticalSection(txn);
+        });
+
+        if (MONGO_FAIL_POINT(hangInShardCollectionCriticalSection)) {
+            // This log output is used in js tests so please leave it.
+            log() << "shardCollection - hangInShardCollectionCriticalSection fail point enabled. "
+                     "Blocking until fail point is disabled.";
+            MONGO_FAIL_POINT_PAUSE_WHILE_SET(hangInShardCollectionCriticalSection);
+        }
+
+        if (!isEmpty) {
+            warning() << "documents were inserted into " << nss.ns() << " while it was being "
+                      << "sharded, so all of its initial chunks are created on the primary shard "
+                      << shardingState->getShardName();
+            initShardIds.clear();
+        }
+
+        uassertStatusOK(Grid::get(txn)->catalogClient(txn)->shardCollection(txn,
+                                                                            nss.ns(),
+                                                                            shardKeyPattern,
+                                                                            defaultCollation,
+                                                                            unique,
+                                                                            splitPoints,
+                                                                            initShardIds));
+
+        // Load the new metadata before leaving the critical section, so that the operations which
+        // waited for it find the collection sharded once they are released.
+        ChunkVersion unusedShardVersion;
+        Status refreshStatus = shardingState->refreshMetadataNow(txn, nss, &unusedShardVersion);
+        if (!refreshStatus.isOK()) {
+            warning() << "could not load the metadata of newly sharded collection " << nss.ns()
+                      << causedBy(redact(refreshStatus));
+        }
+
+        result.appendBool("chunksDistributed", isEmpty);
+        return true;
+    }
+
+} shardsvrShardCollectionCmd;
+
+}  // namespace
+}  // namespace mongo
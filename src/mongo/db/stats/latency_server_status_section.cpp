@@ -31,6 +31,7 @@
 #include "mongo/db/commands/server_status.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/query/query_shape_stats.h"
 #include "mongo/db/stats/top.h"
 
 namespace mongo {
@@ -57,5 +58,47 @@ public:
         return latencyBuilder.obj();
     }
 } globalHistogramServerStatusSection;
+
+/**
+ * Appends the global write phase histograms to the server status.
+ */
+class WritePhaseHistogramServerStatusSection final : public ServerStatusSection {
+public:
+    WritePhaseHistogramServerStatusSection() : ServerStatusSection("writePhaseLatencies") {}
+
+    bool includeByDefault() const {
+        return true;
+    }
+
+    BSONObj generateSection(OperationContext* txn, const BSONElement& configElem) const {
+        BSONObjBuilder latencyBuilder;
+        bool includeHistograms = false;
+        if (configElem.type() == BSONType::Object) {
+            includeHistograms = configElem.Obj()["histograms"].trueValue();
+        }
+        Top::get(txn->getServiceContext())
+            .appendGlobalWritePhaseStats(includeHistograms, &latencyBuilder);
+        return latencyBuilder.obj();
+    }
+} writePhaseHistogramServerStatusSection;
+
+/**
+ * Appends counters about the query shape statistics store. The per-shape statistics are only
+ * available through the $queryShapeStats aggregation stage.
+ */
+class QueryShapeStatsServerStatusSection final : public ServerStatusSection {
+public:
+    QueryShapeStatsServerStatusSection() : ServerStatusSection("queryShapeStats") {}
+
+    bool includeByDefault() const {
+        return true;
+    }
+
+    BSONObj generateSection(OperationContext* txn, const BSONElement& configElem) const {
+        BSONObjBuilder builder;
+        QueryShapeStats::get(txn->getServiceContext()).appendSummary(&builder);
+        return builder.obj();
+    }
+} queryShapeStatsServerStatusSection;
 }  // namespace
 }  // namespace mongo
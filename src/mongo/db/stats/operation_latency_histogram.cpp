@@ -91,33 +91,32 @@ const std::array<uint64_t, OperationLatencyHistogram::kMaxBuckets>
                                                549755813888,
                                                1099511627776};
 
-void OperationLatencyHistogram::_append(const HistogramData& data,
-                                        const char* key,
-                                        bool includeHistograms,
-                                        BSONObjBuilder* builder) const {
+void OperationLatencyHistogram::HistogramData::append(StringData key,
+                                                     bool includeHistograms,
+                                                     BSONObjBuilder* builder) const {
 
     BSONObjBuilder histogramBuilder(builder->subobjStart(key));
     if (includeHistograms) {
         BSONArrayBuilder arrayBuilder(histogramBuilder.subarrayStart("histogram"));
         for (int i = 0; i < kMaxBuckets; i++) {
-            if (data.buckets[i] == 0)
+            if (buckets[i] == 0)
                 continue;
             BSONObjBuilder entryBuilder(arrayBuilder.subobjStart());
             entryBuilder.append("micros", static_cast<long long>(kLowerBounds[i]));
-            entryBuilder.append("count", static_cast<long long>(data.buckets[i]));
+            entryBuilder.append("count", static_cast<long long>(buckets[i]));
             entryBuilder.doneFast();
         }
         arrayBuilder.doneFast();
     }
-    histogramBuilder.append("latency", static_cast<long long>(data.sum));
-    histogramBuilder.append("ops", static_cast<long long>(data.entryCount));
+    histogramBuilder.append("latency", static_cast<long long>(sum));
+    histogramBuilder.append("ops", static_cast<long long>(entryCount));
     histogramBuilder.doneFast();
 }
 
 void OperationLatencyHistogram::append(bool includeHistograms, BSONObjBuilder* builder) const {
-    _append(_reads, "reads", includeHistograms, builder);
-    _append(_writes, "writes", includeHistograms, builder);
-    _append(_commands, "commands", includeHistograms, builder);
+    _reads.append("reads", includeHistograms, builder);
+    _writes.append("writes", includeHistograms, builder);
+    _commands.append("commands", includeHistograms, builder);
 }
 
 // Computes the log base 2 of value, and checks for cases of split buckets.
@@ -147,23 +146,22 @@ int OperationLatencyHistogram::_getBucket(uint64_t value) {
     }
 }
 
-void OperationLatencyHistogram::_incrementData(uint64_t latency, int bucket, HistogramData* data) {
-    data->buckets[bucket]++;
-    data->entryCount++;
-    data->sum += latency;
+void OperationLatencyHistogram::HistogramData::increment(uint64_t latency) {
+    buckets[_getBucket(latency)]++;
+    entryCount++;
+    sum += latency;
 }
 
 void OperationLatencyHistogram::increment(uint64_t latency, Command::ReadWriteType type) {
-    int bucket = _getBucket(latency);
     switch (type) {
         case Command::ReadWriteType::kRead:
-            _incrementData(latency, bucket, &_reads);
+            _reads.increment(latency);
             break;
         case Command::ReadWriteType::kWrite:
-            _incrementData(latency, bucket, &_writes);
+            _writes.increment(latency);
             break;
         case Command::ReadWriteType::kCommand:
-            _incrementData(latency, bucket, &_commands);
+            _commands.increment(latency);
             break;
         default:
             MONGO_UNREACHABLE;
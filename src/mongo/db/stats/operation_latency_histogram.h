@@ -57,23 +57,25 @@ public:
      */
     void append(bool includeHistograms, BSONObjBuilder* builder) const;
 
-private:
+    /**
+     * A single latency histogram along with its latency total and operation count.
+     */
     struct HistogramData {
         std::array<uint64_t, kMaxBuckets> buckets{};
         uint64_t entryCount = 0;
         uint64_t sum = 0;
-    };
 
-    static int _getBucket(uint64_t latency);
+        void increment(uint64_t latency);
 
-    static uint64_t _getBucketMicros(int bucket);
-
-    void _append(const HistogramData& data,
-                 const char* key,
-                 bool includeHistograms,
-                 BSONObjBuilder* builder) const;
+        /**
+         * Appends the latency total and operation count as a subobject named 'key', along with
+         * the non-empty buckets if 'includeHistograms' is true.
+         */
+        void append(StringData key, bool includeHistograms, BSONObjBuilder* builder) const;
+    };
 
-    void _incrementData(uint64_t latency, int bucket, HistogramData* data);
+private:
+    static int _getBucket(uint64_t latency);
 
     HistogramData _reads, _writes, _commands;
 };
@@ -201,7 +201,11 @@ void Top::appendLatencyStats(StringData ns, bool includeHistograms, BSONObjBuild
     auto hashedNs = UsageMap::HashedKey(ns);
     stdx::lock_guard<SimpleMutex> lk(_lock);
     BSONObjBuilder latencyStatsBuilder;
-    _usage[hashedNs].opLatencyHistogram.append(includeHistograms, &latencyStatsBuilder);
+    const CollectionData& coll = _usage[hashedNs];
+    coll.opLatencyHistogram.append(includeHistograms, &latencyStatsBuilder);
+    BSONObjBuilder writePhasesBuilder(latencyStatsBuilder.subobjStart("writePhases"));
+    coll.writePhaseHistogram.append(includeHistograms, &writePhasesBuilder);
+    writePhasesBuilder.doneFast();
     builder->append("ns", ns);
     builder->append("latencyStats", latencyStatsBuilder.obj());
 }
@@ -218,14 +222,45 @@ void Top::appendGlobalLatencyStats(bool includeHistograms, BSONObjBuilder* build
     _globalHistogramStats.append(includeHistograms, builder);
 }
 
+void Top::recordWritePhases(OperationContext* txn,
+                            StringData ns,
+                            const WritePhaseTimings& timings) {
+    if (ns[0] == '?' || timings.empty() || !_shouldIncrementHistograms(txn))
+        return;
+
+    auto hashedNs = UsageMap::HashedKey(ns);
+    stdx::lock_guard<SimpleMutex> lk(_lock);
+    _usage[hashedNs].writePhaseHistogram.increment(timings);
+    _globalWritePhaseStats.increment(timings);
+}
+
+void Top::incrementGlobalWritePhaseStats(OperationContext* txn,
+                                         WritePhase phase,
+                                         uint64_t latency) {
+    if (!_shouldIncrementHistograms(txn))
+        return;
+
+    stdx::lock_guard<SimpleMutex> guard(_lock);
+    _globalWritePhaseStats.increment(phase, latency);
+}
+
+void Top::appendGlobalWritePhaseStats(bool includeHistograms, BSONObjBuilder* builder) {
+    stdx::lock_guard<SimpleMutex> guard(_lock);
+    _globalWritePhaseStats.append(includeHistograms, builder);
+}
+
 void Top::_incrementHistogram(OperationContext* txn,
                               long long latency,
                               OperationLatencyHistogram* histogram,
                               Command::ReadWriteType readWriteType) {
-    // Only update histogram if operation came from a user.
-    Client* client = txn->getClient();
-    if (client->isFromUserConnection() && !client->isInDirectClient()) {
+    if (_shouldIncrementHistograms(txn)) {
         histogram->increment(latency, readWriteType);
     }
 }
+
+bool Top::_shouldIncrementHistograms(OperationContext* txn) const {
+    // Only update histograms if operation came from a user.
+    Client* client = txn->getClient();
+    return client->isFromUserConnection() && !client->isInDirectClient();
+}
 }  // namespace mongo
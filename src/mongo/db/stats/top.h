@@ -34,6 +34,7 @@
 #include "mongo/db/commands.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/stats/operation_latency_histogram.h"
+#include "mongo/db/stats/write_phase_latency_histogram.h"
 #include "mongo/util/concurrency/mutex.h"
 #include "mongo/util/net/message.h"
 #include "mongo/util/string_map.h"
@@ -82,6 +83,7 @@ public:
         UsageData remove;
         UsageData commands;
         OperationLatencyHistogram opLatencyHistogram;
+        WritePhaseLatencyHistogram writePhaseHistogram;
     };
 
     typedef StringMap<CollectionData> UsageMap;
@@ -118,6 +120,23 @@ public:
      */
     void appendGlobalLatencyStats(bool includeHistograms, BSONObjBuilder* builder);
 
+    /**
+     * Increments the write phase histograms of the collection and the global ones with the time
+     * a write operation on 'ns' spent in each phase.
+     */
+    void recordWritePhases(OperationContext* txn, StringData ns, const WritePhaseTimings& timings);
+
+    /**
+     * Increments the global histogram of a write phase which cannot be attributed to a single
+     * collection, such as waiting for write concern.
+     */
+    void incrementGlobalWritePhaseStats(OperationContext* txn, WritePhase phase, uint64_t latency);
+
+    /**
+     * Appends the global write phase statistics.
+     */
+    void appendGlobalWritePhaseStats(bool includeHistograms, BSONObjBuilder* builder);
+
 private:
     void _appendToUsageMap(BSONObjBuilder& b, const UsageMap& map) const;
 
@@ -135,8 +154,11 @@ private:
                              OperationLatencyHistogram* histogram,
                              Command::ReadWriteType readWriteType);
 
+    bool _shouldIncrementHistograms(OperationContext* txn) const;
+
     mutable SimpleMutex _lock;
     OperationLatencyHistogram _globalHistogramStats;
+    WritePhaseLatencyHistogram _globalWritePhaseStats;
     UsageMap _usage;
     std::string _lastDropped;
 };
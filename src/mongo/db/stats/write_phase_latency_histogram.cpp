@@ -0,0 +1,91 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/stats/write_phase_latency_histogram.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+StringData writePhaseName(WritePhase phase) {
+    switch (phase) {
+        case WritePhase::kValidation:
+            return "validation"_sd;
+        case WritePhase::kKeyGeneration:
+            return "keyGeneration"_sd;
+        case WritePhase::kIndexWrite:
+            return "indexWrite"_sd;
+        case WritePhase::kOplogWrite:
+            return "oplogWrite"_sd;
+        case WritePhase::kCommit:
+            return "commit"_sd;
+        case WritePhase::kWriteConcern:
+            return "writeConcern"_sd;
+    }
+    MONGO_UNREACHABLE;
+}
+
+bool WritePhaseTimings::empty() const {
+    for (long long micros : _micros) {
+        if (micros > 0)
+            return false;
+    }
+    return true;
+}
+
+void WritePhaseTimings::append(BSONObjBuilder* builder) const {
+    for (int i = 0; i < kNumWritePhases; i++) {
+        if (_micros[i] > 0) {
+            builder->appendNumber(writePhaseName(static_cast<WritePhase>(i)), _micros[i]);
+        }
+    }
+}
+
+void WritePhaseLatencyHistogram::increment(const WritePhaseTimings& timings) {
+    for (int i = 0; i < kNumWritePhases; i++) {
+        const WritePhase phase = static_cast<WritePhase>(i);
+        if (timings.get(phase) > 0) {
+            increment(phase, timings.get(phase));
+        }
+    }
+}
+
+void WritePhaseLatencyHistogram::increment(WritePhase phase, uint64_t latency) {
+    _phases[static_cast<int>(phase)].increment(latency);
+}
+
+void WritePhaseLatencyHistogram::append(bool includeHistograms, BSONObjBuilder* builder) const {
+    for (int i = 0; i < kNumWritePhases; i++) {
+        _phases[i].append(writePhaseName(static_cast<WritePhase>(i)), includeHistograms, builder);
+    }
+}
+
+}  // namespace mongo
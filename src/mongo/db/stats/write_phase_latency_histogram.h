@@ -0,0 +1,106 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <array>
+
+#include "mongo/base/string_data.h"
+#include "mongo/db/stats/operation_latency_histogram.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+
+/**
+ * The phases of the insert, update and delete paths whose latencies are tracked separately.
+ */
+enum class WritePhase {
+    kValidation,     // Checking the document against the collection's validator.
+    kKeyGeneration,  // Generating index keys from documents.
+    kIndexWrite,     // Inserting and removing keys through SortedDataInterface.
+    kOplogWrite,     // Writing oplog entries.
+    kCommit,         // Committing the WriteUnitOfWork.
+    kWriteConcern,   // Waiting for the write concern to be satisfied.
+};
+
+const int kNumWritePhases = static_cast<int>(WritePhase::kWriteConcern) + 1;
+
+StringData writePhaseName(WritePhase phase);
+
+/**
+ * The time in microseconds a single operation spent in each write phase.
+ */
+class WritePhaseTimings {
+public:
+    void add(WritePhase phase, long long micros) {
+        _micros[static_cast<int>(phase)] += micros;
+    }
+
+    long long get(WritePhase phase) const {
+        return _micros[static_cast<int>(phase)];
+    }
+
+    /**
+     * Returns true if no time was recorded for any phase.
+     */
+    bool empty() const;
+
+    /**
+     * Appends the time of each phase for which some time was recorded.
+     */
+    void append(BSONObjBuilder* builder) const;
+
+private:
+    std::array<long long, kNumWritePhases> _micros{};
+};
+
+/**
+ * Stores a latency histogram for each write phase.
+ *
+ * Note: This class is not thread-safe.
+ */
+class WritePhaseLatencyHistogram {
+public:
+    /**
+     * Increments the histogram of each phase the operation spent time in.
+     */
+    void increment(const WritePhaseTimings& timings);
+
+    void increment(WritePhase phase, uint64_t latency);
+
+    /**
+     * Appends one histogram per phase with latency totals and operation counts.
+     */
+    void append(bool includeHistograms, BSONObjBuilder* builder) const;
+
+private:
+    std::array<OperationLatencyHistogram::HistogramData, kNumWritePhases> _phases;
+};
+
+}  // namespace mongo
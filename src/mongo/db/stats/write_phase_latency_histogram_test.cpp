@@ -0,0 +1,86 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/stats/write_phase_latency_histogram.h"
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/json.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+TEST(WritePhaseTimings, AppendsOnlyPhasesWithTime) {
+    WritePhaseTimings timings;
+    ASSERT_TRUE(timings.empty());
+
+    timings.add(WritePhase::kIndexWrite, 10);
+    timings.add(WritePhase::kCommit, 3);
+    timings.add(WritePhase::kIndexWrite, 5);
+    ASSERT_FALSE(timings.empty());
+    ASSERT_EQUALS(timings.get(WritePhase::kIndexWrite), 15);
+    ASSERT_EQUALS(timings.get(WritePhase::kValidation), 0);
+
+    BSONObjBuilder builder;
+    timings.append(&builder);
+    ASSERT_BSONOBJ_EQ(builder.obj(), fromjson("{indexWrite: 15, commit: 3}"));
+}
+
+TEST(WritePhaseLatencyHistogram, IncrementsEachPhaseWithTime) {
+    WritePhaseTimings timings;
+    timings.add(WritePhase::kKeyGeneration, 4);
+    timings.add(WritePhase::kOplogWrite, 2048);
+
+    WritePhaseLatencyHistogram hist;
+    hist.increment(timings);
+    hist.increment(timings);
+    hist.increment(WritePhase::kWriteConcern, 100);
+
+    BSONObjBuilder builder;
+    hist.append(true, &builder);
+    BSONObj out = builder.obj();
+
+    ASSERT_EQUALS(out.nFields(), kNumWritePhases);
+    ASSERT_EQUALS(out["validation"]["ops"].Long(), 0);
+    ASSERT_EQUALS(out["keyGeneration"]["ops"].Long(), 2);
+    ASSERT_EQUALS(out["keyGeneration"]["latency"].Long(), 8);
+    ASSERT_EQUALS(out["oplogWrite"]["ops"].Long(), 2);
+    ASSERT_EQUALS(out["oplogWrite"]["latency"].Long(), 4096);
+    ASSERT_EQUALS(out["writeConcern"]["ops"].Long(), 1);
+
+    // Both oplog write latencies fall into the bucket starting at 2048 micros.
+    std::vector<BSONElement> buckets = out["oplogWrite"]["histogram"].Array();
+    ASSERT_EQUALS(buckets.size(), 1U);
+    ASSERT_EQUALS(buckets[0]["micros"].Long(), 2048);
+    ASSERT_EQUALS(buckets[0]["count"].Long(), 2);
+}
+
+}  // namespace
+}  // namespace mongo
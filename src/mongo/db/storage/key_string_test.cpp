@@ -1106,7 +1106,9 @@ unsigned newSeed() {
  * Evaluates ROUNDTRIP on all items in Numbers a sufficient number of times to take at least
  * kMinPerfMicros microseconds. Logs the elapsed time per ROUNDTRIP evaluation.
  */
-void perfTest(KeyString::Version version, const Numbers& numbers) {
+void perfTest(KeyString::Version version,
+              const Numbers& numbers,
+              Ordering ordering = ALL_ASCENDING) {
     uint64_t micros = 0;
     uint64_t iters;
     // Ensure at least 16 iterations are done and at least 50 milliseconds is timed
@@ -1118,8 +1120,8 @@ void perfTest(KeyString::Version version, const Numbers& numbers) {
             for (auto item : numbers) {
                 // Assuming there are sufficient invariants in the to/from KeyString methods
                 // that calls will not be optimized away.
-                const KeyString ks(version, item, ALL_ASCENDING);
-                const BSONObj& converted = toBson(ks, ALL_ASCENDING);
+                const KeyString ks(version, item, ordering);
+                const BSONObj& converted = toBson(ks, ordering);
                 invariant(converted.binaryEqual(item));
             }
 
@@ -1148,6 +1150,31 @@ TEST_F(KeyStringTest, CommonIntPerf) {
     perfTest(version, numbers);
 }
 
+TEST_F(KeyStringTest, CompoundIntOIDDescendingPerf) {
+    std::mt19937 gen(newSeed());
+    std::exponential_distribution<double> expReal(1e-3);
+
+    std::vector<BSONObj> keys;
+    for (uint64_t x = 0; x < kMinPerfSamples; x++)
+        keys.push_back(BSON("" << static_cast<int>(expReal(gen)) << "" << OID::gen()));
+
+    perfTest(version, keys, Ordering::make(BSON("a" << -1 << "b" << -1)));
+}
+
+TEST_F(KeyStringTest, CompoundStringDatePerf) {
+    std::mt19937 gen(newSeed());
+    std::uniform_int_distribution<int> length(0, 64);
+    std::uniform_int_distribution<long long> millis(0, 1LL << 42);
+
+    std::vector<BSONObj> keys;
+    for (uint64_t x = 0; x < kMinPerfSamples; x++)
+        keys.push_back(BSON("" << std::string(length(gen), 'k') << ""
+                               << Date_t::fromMillisSinceEpoch(millis(gen))));
+
+    perfTest(version, keys);
+    perfTest(version, keys, Ordering::make(BSON("a" << -1 << "b" << 1)));
+}
+
 TEST_F(KeyStringTest, UniformInt64Perf) {
     std::vector<BSONObj> numbers;
     std::mt19937 gen(newSeed());
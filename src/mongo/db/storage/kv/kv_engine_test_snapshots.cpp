@@ -126,6 +126,18 @@ public:
         wuow.commit();
     }
 
+    void updateWithDamagesAndCommit(RecordId id, int offset, std::string replacement) {
+        auto op = makeOperation();
+        WriteUnitOfWork wuow(op);
+        mutablebson::DamageVector damages(1);
+        damages[0].sourceOffset = 0;
+        damages[0].targetOffset = offset;
+        damages[0].size = replacement.length();
+        RecordData oldRec = rs->dataFor(op, id);
+        ASSERT_OK(rs->updateWithDamages(op, id, oldRec, replacement.c_str(), damages).getStatus());
+        wuow.commit();
+    }
+
     void deleteRecordAndCommit(RecordId id) {
         auto op = makeOperation();
         WriteUnitOfWork wuow(op);
@@ -335,8 +347,11 @@ TEST_F(SnapshotManagerTests, UpdateAndDelete) {
     updateRecordAndCommit(id, "Cat");
     auto snapCat = prepareAndCreateSnapshot();
 
-    // Untested since no engine currently supports both updateWithDamanges and snapshots.
-    ASSERT(!rs->updateWithDamagesSupported());
+    auto snapCow = snapCat;
+    if (rs->updateWithDamagesSupported()) {
+        updateWithDamagesAndCommit(id, 1, "ow");
+        snapCow = prepareAndCreateSnapshot();
+    }
 
     deleteRecordAndCommit(id);
     auto snapAfterDelete = prepareAndCreateSnapshot();
@@ -353,6 +368,12 @@ TEST_F(SnapshotManagerTests, UpdateAndDelete) {
     ASSERT_EQ(itCountCommitted(), 1);
     ASSERT_EQ(readStringCommitted(id), "Cat");
 
+    if (rs->updateWithDamagesSupported()) {
+        snapshotManager->setCommittedSnapshot(snapCow);
+        ASSERT_EQ(itCountCommitted(), 1);
+        ASSERT_EQ(readStringCommitted(id), "Cow");
+    }
+
     snapshotManager->setCommittedSnapshot(snapAfterDelete);
     ASSERT_EQ(itCountCommitted(), 0);
     ASSERT(!readRecordCommitted(id));
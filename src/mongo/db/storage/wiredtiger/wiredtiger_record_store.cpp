@@ -1440,7 +1440,7 @@ Status WiredTigerRecordStore::updateRecord(OperationContext* txn,
 }
 
 bool WiredTigerRecordStore::updateWithDamagesSupported() const {
-    return false;
+    return true;
 }
 
 StatusWith<RecordData> WiredTigerRecordStore::updateWithDamages(
@@ -1449,7 +1449,32 @@ StatusWith<RecordData> WiredTigerRecordStore::updateWithDamages(
     const RecordData& oldRec,
     const char* damageSource,
     const mutablebson::DamageVector& damages) {
-    MONGO_UNREACHABLE;
+    // This version of WiredTiger cannot update part of a value (there is no WT_CURSOR::modify),
+    // so the damages are applied to a copy of the old record which is then written in full.
+    // Callers still avoid rebuilding the document and diffing its index keys. Damage events only
+    // ever overwrite bytes of the old record, so modifiers which change the size of a document,
+    // such as $push or $unset, never reach this path and keep rewriting the whole document.
+    const int len = oldRec.size();
+    SharedBuffer data = SharedBuffer::allocate(len);
+    memcpy(data.get(), oldRec.data(), len);
+
+    for (const auto& damage : damages) {
+        invariant(damage.targetOffset + damage.size <= static_cast<size_t>(len));
+        memcpy(data.get() + damage.targetOffset, damageSource + damage.sourceOffset, damage.size);
+    }
+
+    // The size of the record does not change, so unlike updateRecord there is no need to look up
+    // the old value first, nor to adjust the data size or delete from a capped collection.
+    WiredTigerCursor curwrap(_uri, _tableId, true, txn);
+    curwrap.assertInActiveTxn();
+    WT_CURSOR* c = curwrap.get();
+    invariant(c);
+    c->set_key(c, _makeKey(id));
+    WiredTigerItem value(data.get(), len);
+    c->set_value(c, value.Get());
+    invariantWTOK(WT_OP_CHECK(c->insert(c)));
+
+    return RecordData(std::move(data), len);
 }
 
 void WiredTigerRecordStore::_oplogSetStartHack(WiredTigerRecoveryUnit* wru) const {
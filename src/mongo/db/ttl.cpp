@@ -47,6 +47,7 @@
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/exec/delete.h"
+#include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/matcher/extensions_callback_disallow_extensions.h"
 #include "mongo/db/namespace_string.h"
@@ -55,22 +56,46 @@
 #include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/db/server_parameters.h"
 #include "mongo/db/ttl_collection_cache.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/util/background.h"
 #include "mongo/util/exit.h"
 #include "mongo/util/log.h"
+#include "mongo/util/time_support.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
 Counter64 ttlPasses;
 Counter64 ttlDeletedDocuments;
+Counter64 ttlBatches;
+Counter64 ttlReplicationLagBackoffs;
 
 ServerStatusMetricField<Counter64> ttlPassesDisplay("ttl.passes", &ttlPasses);
 ServerStatusMetricField<Counter64> ttlDeletedDocumentsDisplay("ttl.deletedDocuments",
                                                               &ttlDeletedDocuments);
+ServerStatusMetricField<Counter64> ttlBatchesDisplay("ttl.batches", &ttlBatches);
+ServerStatusMetricField<Counter64> ttlReplicationLagBackoffsDisplay("ttl.replicationLagBackoffs",
+                                                                   &ttlReplicationLagBackoffs);
 
 MONGO_EXPORT_SERVER_PARAMETER(ttlMonitorEnabled, bool, true);
 MONGO_EXPORT_SERVER_PARAMETER(ttlMonitorSleepSecs, int, 60);  // used for testing
 
+// Maximum number of documents deleted from one TTL index under a single acquisition of the
+// collection lock. Zero or less deletes all expired documents at once.
+MONGO_EXPORT_SERVER_PARAMETER(ttlMonitorBatchSize, int, 1000);
+
+// Upper bound on the rate at which the TTL monitor deletes documents. The monitor sleeps between
+// batches, without holding any locks, to stay below it. Zero or less derives the rate from
+// ttlMonitorSleepSecs instead: a pass aims to spread twice as many deletes as the previous pass
+// made over one interval, and never goes below one batch per second.
+MONGO_EXPORT_SERVER_PARAMETER(ttlMonitorMaxDeletesPerSecond, int, 0);
+
+// When this node is a primary whose majority commit point trails its last applied write, the TTL
+// monitor slows down in proportion to the lag, and stops deleting until its next pass once the lag
+// reaches this many seconds. Zero or less disables the check.
+MONGO_EXPORT_SERVER_PARAMETER(ttlMonitorMaxReplicationLagSecs, int, 0);
+
 class TTLMonitor : public BackgroundJob {
 public:
     TTLMonitor() {}
@@ -87,7 +112,9 @@ public:
         AuthorizationSession::get(cc())->grantInternalAuthorization();
 
         while (!globalInShutdownDeprecated()) {
-            sleepsecs(ttlMonitorSleepSecs.load());
+            if (!sleepUnlessShutdown(Seconds(ttlMonitorSleepSecs.load()))) {
+                break;
+            }
 
             LOG(3) << "thread awake";
 
@@ -111,7 +138,31 @@ public:
         }
     }
 
+    /**
+     * Wakes the monitor up from any sleep and makes it stop.
+     */
+    void shutdown() {
+        stdx::lock_guard<stdx::mutex> lk(_shutdownMutex);
+        _inShutdown = true;
+        _shutdownCondVar.notify_all();
+    }
+
 private:
+    /**
+     * Sleeps for 'duration' or until the server starts shutting down. Returns false in the latter
+     * case.
+     */
+    bool sleepUnlessShutdown(Milliseconds duration) {
+        stdx::unique_lock<stdx::mutex> lk(_shutdownMutex);
+        return !_shutdownCondVar.wait_for(
+            lk, duration.toSystemDuration(), [this] { return _inShutdown; });
+    }
+
+    bool inShutdown() {
+        stdx::lock_guard<stdx::mutex> lk(_shutdownMutex);
+        return _inShutdown || globalInShutdownDeprecated();
+    }
+
     void doTTLPass() {
         const ServiceContext::UniqueOperationContext txnPtr = cc().makeOperationContext();
         OperationContext& txn = *txnPtr;
@@ -150,63 +201,188 @@ private:
             }
         }
 
-        for (const BSONObj& idx : ttlIndexes) {
+        // A pass may take as long as the monitor sleeps between passes
+        const Milliseconds interval = Seconds(ttlMonitorSleepSecs.load());
+        const Date_t passDeadline = Date_t::now() + interval;
+        const double deletesPerSecond = getDeletesPerSecond(interval);
+
+        long long passDeleted = 0;
+        for (size_t i = 0; i < ttlIndexes.size() && !inShutdown(); ++i) {
+            // Each index gets an equal share of the time left in the pass, so that an index with a
+            // large backlog cannot starve the ones after it. Time which an index does not use goes
+            // to the indexes which follow.
+            const Date_t now = Date_t::now();
+            const Date_t indexDeadline = now +
+                std::max(Milliseconds(0), passDeadline - now) /
+                    static_cast<long long>(ttlIndexes.size() - i);
+
             try {
-                doTTLForIndex(&txn, idx);
+                passDeleted += doTTLForIndex(&txn, ttlIndexes[i], deletesPerSecond, indexDeadline);
             } catch (const DBException& dbex) {
-                error() << "Error processing ttl index: " << idx << " -- " << dbex.toString();
+                error() << "Error processing ttl index: " << ttlIndexes[i] << " -- "
+                        << dbex.toString();
                 // Continue on to the next index.
                 continue;
             }
         }
+
+        _lastPassDeleted = passDeleted;
+    }
+
+    /**
+     * Returns the rate at which the pass starting now should delete documents.
+     */
+    double getDeletesPerSecond(Milliseconds interval) const {
+        const int maxDeletesPerSecond = ttlMonitorMaxDeletesPerSecond.load();
+        if (maxDeletesPerSecond > 0) {
+            return maxDeletesPerSecond;
+        }
+
+        // Without an explicit limit, aim to delete over one interval what expired during the
+        // previous one, with twice the headroom so that a growing backlog is caught up with
+        const double intervalSecs =
+            std::max(durationCount<Milliseconds>(interval), 1000LL) / 1000.0;
+        const double minDeletesPerSecond = std::max(ttlMonitorBatchSize.load(), 1);
+        return std::max(minDeletesPerSecond, 2 * _lastPassDeleted / intervalSecs);
     }
 
     /**
      * Remove documents from the collection using the specified TTL index after a sufficient amount
      * of time has passed according to its expiry specification.
+     *
+     * The documents are removed in batches of at most 'ttlMonitorBatchSize', each under its own
+     * acquisition of the collection lock, at no more than 'deletesPerSecond'. Only documents which
+     * had expired when the pass over the index started are removed, and no batch starts after
+     * 'deadline'. Whatever is left is removed by the next pass.
+     *
+     * Returns the number of documents removed.
      */
-    void doTTLForIndex(OperationContext* txn, BSONObj idx) {
+    long long doTTLForIndex(OperationContext* txn,
+                            BSONObj idx,
+                            double deletesPerSecond,
+                            Date_t deadline) {
         const NamespaceString collectionNSS(idx["ns"].String());
         if (!userAllowedWriteNS(collectionNSS).isOK()) {
             error() << "namespace '" << collectionNSS
                     << "' doesn't allow deletes, skipping ttl job for: " << idx;
-            return;
+            return 0;
         }
 
         const BSONObj key = idx["key"].Obj();
-        const StringData name = idx["name"].valueStringData();
         if (key.nFields() != 1) {
             error() << "key for ttl index can only have 1 field, skipping ttl job for: " << idx;
-            return;
+            return 0;
         }
 
-        LOG(1) << "ns: " << collectionNSS << " key: " << key << " name: " << name;
+        LOG(1) << "ns: " << collectionNSS << " key: " << key << " name: " << idx["name"];
+
+        const Date_t passStart = Date_t::now();
+        long long totalDeleted = 0;
+
+        while (!inShutdown()) {
+            const double lagFactor = replicationLagFactor();
+            if (lagFactor <= 0) {
+                ttlReplicationLagBackoffs.increment();
+                LOG(1) << "majority commit point is lagging, postponing ttl job for: " << idx;
+                break;
+            }
+
+            const int batchSize = ttlMonitorBatchSize.load();
+            Timer batchTimer;
+            const long long numDeleted = deleteExpiredBatch(txn, idx, passStart, batchSize);
+            if (numDeleted < 0) {
+                break;
+            }
+
+            ttlBatches.increment();
+            ttlDeletedDocuments.increment(numDeleted);
+            totalDeleted += numDeleted;
+
+            if (batchSize <= 0 || numDeleted < batchSize) {
+                break;
+            }
+
+            // Sleep, without holding any locks, for as long as this batch should have taken at the
+            // allowed rate, which shrinks further while the majority commit point is lagging
+            const Milliseconds sleepTime =
+                Milliseconds(static_cast<long long>(numDeleted * 1000 /
+                                                    (deletesPerSecond * lagFactor))) -
+                Milliseconds(batchTimer.millis());
+            if (Date_t::now() + sleepTime >= deadline) {
+                LOG(1) << "ttl pass is out of time, postponing ttl job for: " << idx;
+                break;
+            }
+
+            if (sleepTime > Milliseconds(0) && !sleepUnlessShutdown(sleepTime)) {
+                break;
+            }
+        }
+
+        LOG(1) << "deleted: " << totalDeleted;
+        return totalDeleted;
+    }
+
+    /**
+     * Returns by how much the delete rate should be scaled down because of replication lag: 1 if
+     * this node is not a replica set primary whose majority commit point trails its last applied
+     * optime, decreasing linearly down to 0 once the lag reaches 'ttlMonitorMaxReplicationLagSecs'.
+     */
+    static double replicationLagFactor() {
+        const int maxLagSecs = ttlMonitorMaxReplicationLagSecs.load();
+        if (maxLagSecs <= 0) {
+            return 1;
+        }
+
+        auto replCoord = repl::getGlobalReplicationCoordinator();
+        if (replCoord->getReplicationMode() != repl::ReplicationCoordinator::modeReplSet) {
+            return 1;
+        }
+
+        const long long lastApplied = replCoord->getMyLastAppliedOpTime().getSecs();
+        const long long lastCommitted = replCoord->getLastCommittedOpTime().getSecs();
+        const long long lagSecs = std::max(lastApplied - lastCommitted, 0LL);
+        return 1 - static_cast<double>(std::min(lagSecs, static_cast<long long>(maxLagSecs))) /
+            maxLagSecs;
+    }
+
+    /**
+     * Removes up to 'batchSize' documents which had expired at 'passStart', or all of them if
+     * 'batchSize' is not positive. Returns the number of documents removed, or -1 if the index
+     * can no longer be processed during this pass.
+     */
+    long long deleteExpiredBatch(OperationContext* txn,
+                                 BSONObj idx,
+                                 Date_t passStart,
+                                 int batchSize) {
+        const NamespaceString collectionNSS(idx["ns"].String());
+        const std::string name = idx["name"].String();
 
         AutoGetCollection autoGetCollection(txn, collectionNSS, MODE_IX);
         Collection* collection = autoGetCollection.getCollection();
         if (!collection) {
             // Collection was dropped.
-            return;
+            return -1;
         }
 
         if (!repl::getGlobalReplicationCoordinator()->canAcceptWritesFor(collectionNSS)) {
-            return;
+            return -1;
         }
 
         IndexDescriptor* desc = collection->getIndexCatalog()->findIndexByName(txn, name);
         if (!desc) {
             LOG(1) << "index not found (index build in progress? index dropped?), skipping "
                    << "ttl job for: " << idx;
-            return;
+            return -1;
         }
 
         // Re-read 'idx' from the descriptor, in case the collection or index definition changed
         // before we re-acquired the collection lock.
         idx = desc->infoObj();
+        const BSONObj key = idx["key"].Obj();
 
         if (IndexType::INDEX_BTREE != IndexNames::nameToType(desc->getAccessMethodName())) {
             error() << "special index can't be used as a ttl index, skipping ttl job for: " << idx;
-            return;
+            return -1;
         }
 
         BSONElement secondsExpireElt = idx[secondsExpireField];
@@ -214,12 +390,12 @@ private:
             error() << "ttl indexes require the " << secondsExpireField << " field to be "
                     << "numeric but received a type of " << typeName(secondsExpireElt.type())
                     << ", skipping ttl job for: " << idx;
-            return;
+            return -1;
         }
 
         const Date_t kDawnOfTime =
             Date_t::fromMillisSinceEpoch(std::numeric_limits<long long>::min());
-        const Date_t expirationTime = Date_t::now() - Seconds(secondsExpireElt.numberLong());
+        const Date_t expirationTime = passStart - Seconds(secondsExpireElt.numberLong());
         const BSONObj startKey = BSON("" << kDawnOfTime);
         const BSONObj endKey = BSON("" << expirationTime);
         // The canonical check as to whether a key pattern element is "ascending" or
@@ -243,6 +419,9 @@ private:
         DeleteStageParams params;
         params.isMulti = true;
         params.canonicalQuery = canonicalQuery.getValue().get();
+        // Returning each deleted document lets the batch stop after 'batchSize' deletes. Every
+        // batch restarts the index scan at the oldest key, which the previous batch has removed.
+        params.returnDeleted = batchSize > 0;
 
         std::unique_ptr<PlanExecutor> exec =
             InternalPlanner::deleteWithIndexScan(txn,
@@ -255,17 +434,42 @@ private:
                                                  PlanExecutor::YIELD_AUTO,
                                                  direction);
 
-        Status result = exec->executePlan();
-        if (!result.isOK()) {
-            error() << "ttl query execution for index " << idx
-                    << " failed with status: " << redact(result);
-            return;
+        if (batchSize <= 0) {
+            Status result = exec->executePlan();
+            if (!result.isOK()) {
+                error() << "ttl query execution for index " << idx
+                        << " failed with status: " << redact(result);
+                return -1;
+            }
+            return DeleteStage::getNumDeleted(*exec);
         }
 
-        const long long numDeleted = DeleteStage::getNumDeleted(*exec);
-        ttlDeletedDocuments.increment(numDeleted);
-        LOG(1) << "deleted: " << numDeleted;
+        long long numDeleted = 0;
+        while (numDeleted < batchSize) {
+            BSONObj deletedObj;
+            PlanExecutor::ExecState state = exec->getNext(&deletedObj, nullptr);
+            if (state == PlanExecutor::IS_EOF) {
+                break;
+            }
+            if (state == PlanExecutor::FAILURE || state == PlanExecutor::DEAD) {
+                error() << "ttl query execution for index " << idx << " failed with status: "
+                        << redact(WorkingSetCommon::getMemberObjectStatus(deletedObj));
+                return -1;
+            }
+
+            invariant(PlanExecutor::ADVANCED == state);
+            numDeleted++;
+        }
+
+        return numDeleted;
     }
+
+    // Number of documents deleted by the previous pass, from which the default rate is derived
+    long long _lastPassDeleted = 0;
+
+    stdx::mutex _shutdownMutex;
+    stdx::condition_variable _shutdownCondVar;
+    bool _inShutdown = false;
 };
 
 namespace {
@@ -278,6 +482,8 @@ TTLMonitor* ttlMonitor = nullptr;
 void startTTLBackgroundJob() {
     ttlMonitor = new TTLMonitor();
     ttlMonitor->go();
+
+    registerShutdownTask([] { ttlMonitor->shutdown(); });
 }
 
 std::string TTLMonitor::secondsExpireField = "expireAfterSeconds";
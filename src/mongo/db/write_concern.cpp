@@ -36,17 +36,20 @@
 #include "mongo/bson/util/bson_extract.h"
 #include "mongo/db/client.h"
 #include "mongo/db/commands/server_status_metric.h"
+#include "mongo/db/curop.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/repl/optime.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/db/server_options.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/stats/timer_stats.h"
+#include "mongo/db/stats/top.h"
 #include "mongo/db/storage/storage_engine.h"
 #include "mongo/db/write_concern_options.h"
 #include "mongo/rpc/protocol.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -183,6 +186,16 @@ Status waitForWriteConcern(OperationContext* txn,
            << ", write concern: " << writeConcern.toBSON();
     auto replCoord = repl::ReplicationCoordinator::get(txn);
 
+    // The wait happens once per command rather than per collection, so it only feeds the
+    // global write phase histogram.
+    Timer waitTimer;
+    ON_BLOCK_EXIT([&] {
+        const long long micros = waitTimer.micros();
+        CurOp::get(txn)->debug().writePhases.add(WritePhase::kWriteConcern, micros);
+        Top::get(txn->getServiceContext())
+            .incrementGlobalWritePhaseStats(txn, WritePhase::kWriteConcern, micros);
+    });
+
     MONGO_FAIL_POINT_PAUSE_WHILE_SET(hangBeforeWaitingForWriteConcern);
 
     // Next handle blocking on disk
@@ -58,8 +58,7 @@ public:
             const string shardId = str::stream() << (i - 1);
             _shardIds.insert(shardId);
 
-            std::shared_ptr<Chunk> chunk(new Chunk(this,
-                                                   mySplitPoints[i - 1],
+            std::shared_ptr<Chunk> chunk(new Chunk(mySplitPoints[i - 1],
                                                    mySplitPoints[i],
                                                    shardId,
                                                    ChunkVersion(0, 0, OID()),
@@ -68,6 +67,7 @@ public:
         }
 
         _chunkRangeMap = _constructRanges(_chunkMap);
+        _routingIndex = ChunkRoutingIndex(_chunkMap);
     }
 };
 
@@ -986,6 +986,32 @@ class InvalidControlCharacter : public Bad {
     }
 };
 
+class LongStringsWithSpecialCharacters {
+public:
+    void run() {
+        // String values are copied in 16 byte blocks up to the first escape, control character
+        // or quote, so place each of those at every offset around the block boundaries.
+        for (int length = 0; length < 48; ++length) {
+            for (int pos = 0; pos <= length; ++pos) {
+                const string prefix(pos, 'a');
+                const string suffix(length - pos, 'z');
+
+                ASSERT_BSONOBJ_EQ(BSON("a" << prefix + suffix),
+                                  fromjson("{ \"a\" : \"" + prefix + suffix + "\" }"));
+                ASSERT_BSONOBJ_EQ(BSON("a" << prefix + "\n" + suffix),
+                                  fromjson("{ \"a\" : \"" + prefix + "\\n" + suffix + "\" }"));
+                ASSERT_BSONOBJ_EQ(BSON("a" << prefix + "\"" + suffix),
+                                  fromjson("{ \"a\" : '" + prefix + "\"" + suffix + "' }"));
+                ASSERT_BSONOBJ_EQ(BSON("a" << prefix + "\xc3\xa9" + suffix),
+                                  fromjson("{ \"a\" : \"" + prefix + "\xc3\xa9" + suffix + "\" }"));
+                ASSERT_THROWS(fromjson("{ \"a\" : \"" + prefix + "\x1f" + suffix + "\" }"),
+                              MsgAssertionException);
+                ASSERT_THROWS(fromjson("{ \"a\" : \"" + prefix + suffix), MsgAssertionException);
+            }
+        }
+    }
+};
+
 class NumbersInFieldName : public Base {
     virtual BSONObj bson() const {
         BSONObjBuilder b;
@@ -2770,6 +2796,7 @@ public:
         add<FromJsonTests::NonEscapedCharacters>();
         add<FromJsonTests::AllowedControlCharacter>();
         add<FromJsonTests::InvalidControlCharacter>();
+        add<FromJsonTests::LongStringsWithSpecialCharacters>();
         add<FromJsonTests::NumbersInFieldName>();
         add<FromJsonTests::EscapeFieldName>();
         add<FromJsonTests::EscapedUnicodeToUtf8>();
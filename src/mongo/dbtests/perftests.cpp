@@ -46,17 +46,34 @@
 #include <iostream>
 #include <mutex>
 
+#include "mongo/bson/bson_validate.h"
+#include "mongo/bson/indexed_bsonobj.h"
+#include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/config.h"
 #include "mongo/db/bson/dotted_path_support.h"
+#include "mongo/db/catalog/cursor_manager.h"
 #include "mongo/db/client.h"
+#include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/db.h"
 #include "mongo/db/dbdirectclient.h"
+#include "mongo/db/json.h"
 #include "mongo/db/lasterror.h"
+#include "mongo/db/op_observer_impl.h"
+#include "mongo/db/op_observer_noop.h"
+#include "mongo/db/repl/oplog.h"
+#include "mongo/db/repl/repl_settings.h"
+#include "mongo/db/repl/replication_coordinator_global.h"
+#include "mongo/db/repl/replication_coordinator_mock.h"
 #include "mongo/db/storage/mmap_v1/dur_stats.h"
 #include "mongo/db/storage/mmap_v1/mmap.h"
 #include "mongo/db/storage/storage_options.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/dbtests/framework_options.h"
+#include "mongo/platform/random.h"
+#include "mongo/s/chunk.h"
+#include "mongo/s/chunk_manager.h"
+#include "mongo/s/chunk_routing_index.h"
+#include "mongo/s/shard_key_pattern.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/thread.h"
 #include "mongo/util/log.h"
@@ -450,6 +467,312 @@ public:
     }
 };
 
+/**
+ * Measures contention on a CursorManager. The single threaded phase pins and unpins one cursor.
+ * The second phase registers, pins and erases a cursor per iteration, and is also run from several
+ * threads at once against the same CursorManager.
+ */
+class CursorManagerPinUnpin : public B {
+public:
+    CursorManagerPinUnpin() : _cursorNs("perftest.cursormanager"), _cursorManager(_cursorNs) {}
+
+    string name() {
+        return "CursorManager::pinCursor";
+    }
+    string name2() {
+        return "CursorManager::registerCursor";
+    }
+    virtual int howLongMillis() {
+        return 500;
+    }
+    virtual bool showDurStats() {
+        return false;
+    }
+    virtual bool testThreaded() {
+        return true;
+    }
+    void prep() {
+        auto pin = _cursorManager.registerCursor({nullptr, _cursorNs, false});
+        _cursorId = pin.getCursor()->cursorid();
+    }
+    void timed() {
+        auto pin = _cursorManager.pinCursor(_cursorId);
+        invariant(pin.isOK());
+    }
+    void timed2(DBClientBase*) {
+        CursorId id;
+        {
+            auto pin = _cursorManager.registerCursor({nullptr, _cursorNs, false});
+            id = pin.getCursor()->cursorid();
+        }
+        for (int i = 0; i < 4; i++) {
+            auto pin = _cursorManager.pinCursor(id);
+            invariant(pin.isOK());
+        }
+        invariant(_cursorManager.eraseCursor(nullptr, id, false).isOK());
+    }
+
+private:
+    const string _cursorNs;
+    CursorManager _cursorManager;
+    CursorId _cursorId = 0;
+};
+
+/**
+ * Measures validateBSON on a document with many short field names, which is the common shape of
+ * documents received over the wire and where the per-field c-string scans dominate.
+ */
+class BSONValidateManyFields : public B {
+public:
+    string name() {
+        return "validateBSON-200-fields";
+    }
+    virtual int howLongMillis() {
+        return 500;
+    }
+    virtual bool showDurStats() {
+        return false;
+    }
+    void prep() {
+        BSONObjBuilder b;
+        for (int i = 0; i < 200; i++) {
+            b.append(str::stream() << "field" << i, i);
+        }
+        _obj = b.obj();
+    }
+    void timed() {
+        invariant(validateBSON(_obj.objdata(), _obj.objsize(), BSONVersion::kLatest).isOK());
+    }
+
+private:
+    BSONObj _obj;
+};
+
+/**
+ * Measures fromjson on extended JSON dominated by long string values, where the parser spends its
+ * time copying the characters of quoted strings.
+ */
+class JSONParseLongStrings : public B {
+public:
+    string name() {
+        return "fromjson-long-strings";
+    }
+    virtual int howLongMillis() {
+        return 500;
+    }
+    virtual bool showDurStats() {
+        return false;
+    }
+    void prep() {
+        const string value(1000, 'x');
+        StringBuilder sb;
+        sb << "{";
+        for (int i = 0; i < 20; i++) {
+            sb << (i ? ", " : "") << "\"field" << i << "\": \"" << value << "\\n" << value
+               << "\"";
+        }
+        sb << "}";
+        _json = sb.str();
+    }
+    void timed() {
+        invariant(fromjson(_json).nFields() == 20);
+    }
+
+private:
+    string _json;
+};
+
+/**
+ * Looks up every top-level field of a 256-field document, first with BSONObj::getField and then
+ * through an IndexedBSONObj view created for each pass.
+ */
+class WideDocumentFieldLookup : public B {
+public:
+    string name() {
+        return "BSONObj::getField-256-fields";
+    }
+    string name2() {
+        return "IndexedBSONObj::getField-256-fields";
+    }
+    virtual int howLongMillis() {
+        return 500;
+    }
+    virtual bool showDurStats() {
+        return false;
+    }
+    void prep() {
+        BSONObjBuilder b;
+        for (int i = 0; i < 256; i++) {
+            _names.push_back(str::stream() << "field" << i);
+            b.append(_names.back(), i);
+        }
+        _obj = b.obj();
+    }
+    void timed() {
+        long long sum = 0;
+        for (const auto& name : _names) {
+            sum += _obj.getField(name).numberInt();
+        }
+        invariant(sum == 255 * 256 / 2);
+    }
+    void timed2(DBClientBase*) {
+        IndexedBSONObj indexed(_obj, _names.size());
+        long long sum = 0;
+        for (const auto& name : _names) {
+            sum += indexed.getField(name).numberInt();
+        }
+        invariant(sum == 255 * 256 / 2);
+    }
+
+private:
+    vector<string> _names;
+    BSONObj _obj;
+};
+
+/**
+ * Measures logging a batch of 1000 inserts to the oplog, where the frames of all the entries are
+ * built in one buffer. The first phase calls repl::logOps directly, and the second inserts the
+ * documents as one batch through the client, as the primary of a replica set.
+ */
+class OplogBatchInsert : public B {
+public:
+    ~OplogBatchInsert() {
+        if (!_replicating) {
+            return;
+        }
+
+        // Put back the replication coordinator and op observer which dbtestsMain() and the
+        // framework install, so that the tests which follow do not write to the oplog.
+        repl::ReplSettings replSettings;
+        replSettings.setOplogSizeBytes(10 * 1024 * 1024);
+        repl::setGlobalReplicationCoordinator(
+            new repl::ReplicationCoordinatorMock(txn()->getServiceContext(), replSettings));
+        repl::getGlobalReplicationCoordinator()->setFollowerMode(repl::MemberState::RS_PRIMARY);
+        getGlobalServiceContext()->setOpObserver(stdx::make_unique<OpObserverNoop>());
+
+        // Drop the oplog, and forget the collection which the oplog code cached for it, so that
+        // tests which create an oplog of their own write to it.
+        DBDirectClient client(txn());
+        client.dropCollection(repl::rsOplogName);
+        {
+            ScopedTransaction transaction(txn(), MODE_X);
+            Lock::GlobalWrite lk(txn()->lockState());
+            repl::oplogCheckCloseDatabase(txn(), nullptr);
+        }
+        repl::setOplogCollectionName();
+    }
+
+    string name() {
+        return "repl::logOps-1000-inserts";
+    }
+    string name2() {
+        return "insert-1000-docs-replicated";
+    }
+    virtual int howLongMillis() {
+        return 500;
+    }
+    virtual bool showDurStats() {
+        return false;
+    }
+    virtual unsigned batchSize() {
+        return 1;
+    }
+    void prep() {
+        repl::ReplSettings replSettings;
+        replSettings.setOplogSizeBytes(10 * 1024 * 1024);
+        replSettings.setReplSetString("perftests");
+        repl::setGlobalReplicationCoordinator(
+            new repl::ReplicationCoordinatorMock(txn()->getServiceContext(), replSettings));
+        repl::getGlobalReplicationCoordinator()->setFollowerMode(repl::MemberState::RS_PRIMARY);
+        getGlobalServiceContext()->setOpObserver(stdx::make_unique<OpObserverImpl>());
+        _replicating = true;
+        repl::setOplogCollectionName();
+        repl::createOplog(txn());
+
+        for (int i = 0; i < 1000; i++) {
+            _docs.push_back(BSON("x" << i << "s"
+                                     << "a short string value"));
+            _docsWithIds.push_back(BSON("_id" << OID::gen() << "x" << i << "s"
+                                              << "a short string value"));
+        }
+    }
+    void timed() {
+        ScopedTransaction transaction(txn(), MODE_IX);
+        WriteUnitOfWork wuow(txn());
+        repl::logOps(
+            txn(), "i", NamespaceString(ns()), _docsWithIds.begin(), _docsWithIds.end(), false);
+        wuow.commit();
+    }
+    void timed2(DBClientBase* c) {
+        // The documents get new _ids on every insert.
+        c->insert(ns(), _docs);
+    }
+
+private:
+    bool _replicating = false;
+    vector<BSONObj> _docs;
+    vector<BSONObj> _docsWithIds;
+};
+
+/**
+ * Measures routing 1000 inserts over 10000 chunks, the way mongos targets an insert batch. The
+ * first phase looks up each shard key in the chunk map, and the second looks them all up at once
+ * in the routing index.
+ */
+class ChunkRoutingIndexLookup : public B {
+public:
+    string name() {
+        return "ChunkMap-route-1000-inserts";
+    }
+    string name2() {
+        return "ChunkRoutingIndex-route-1000-inserts";
+    }
+    virtual int howLongMillis() {
+        return 500;
+    }
+    virtual bool showDurStats() {
+        return false;
+    }
+    virtual unsigned batchSize() {
+        return 1;
+    }
+    void prep() {
+        const int kNumChunks = 10000;
+
+        ShardKeyPattern shardKeyPattern(BSON("a" << 1));
+        BSONObj min = shardKeyPattern.getKeyPattern().globalMin();
+        for (int i = 1; i <= kNumChunks; i++) {
+            BSONObj max = (i < kNumChunks) ? BSON("a" << static_cast<long long>(i) * 1000)
+                                           : shardKeyPattern.getKeyPattern().globalMax();
+            const ShardId shardId(str::stream() << "shard" << (i % 10));
+            _chunkMap.emplace(
+                max, std::make_shared<Chunk>(min, max, shardId, ChunkVersion(1, i, OID()), 0));
+            min = max;
+        }
+        _index = ChunkRoutingIndex(_chunkMap);
+
+        PseudoRandom random(1);
+        for (int i = 0; i < 1000; i++) {
+            _shardKeys.push_back(BSON("a" << random.nextInt64(1000LL * kNumChunks)));
+        }
+    }
+    void timed() {
+        for (const auto& shardKey : _shardKeys) {
+            invariant(_chunkMap.upper_bound(shardKey) != _chunkMap.end());
+        }
+    }
+    void timed2(DBClientBase*) {
+        _index.findChunks(_shardKeys, &_chunks);
+        invariant(_chunks.size() == _shardKeys.size());
+    }
+
+private:
+    ChunkMap _chunkMap =
+        SimpleBSONObjComparator::kInstance.makeBSONObjIndexedMap<std::shared_ptr<Chunk>>();
+    ChunkRoutingIndex _index;
+    vector<BSONObj> _shardKeys;
+    vector<std::shared_ptr<Chunk>> _chunks;
+};
 
 class All : public Suite {
 public:
@@ -463,6 +786,12 @@ public:
         add<boosttimed_mutexspeed>();
         add<stdmutexspeed>();
         add<stdtimed_mutexspeed>();
+        add<CursorManagerPinUnpin>();
+        add<BSONValidateManyFields>();
+        add<JSONParseLongStrings>();
+        add<WideDocumentFieldLookup>();
+        add<OplogBatchInsert>();
+        add<ChunkRoutingIndexLookup>();
     }
 } myall;
 }  // namespace PerfTests
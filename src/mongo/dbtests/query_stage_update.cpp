@@ -51,7 +51,9 @@
 #include "mongo/db/ops/update_lifecycle_impl.h"
 #include "mongo/db/ops/update_request.h"
 #include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/storage/storage_options.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/stdx/memory.h"
 
@@ -246,6 +248,16 @@ public:
  */
 class QueryStageUpdateSkipInvalidatedDoc : public QueryStageUpdateBase {
 public:
+    QueryStageUpdateSkipInvalidatedDoc()
+        : _internalUpdateMaxBatchSize(internalUpdateMaxBatchSize.load()) {
+        // The invalidation has to arrive between two single-document updates.
+        internalUpdateMaxBatchSize.store(1);
+    }
+
+    ~QueryStageUpdateSkipInvalidatedDoc() {
+        internalUpdateMaxBatchSize.store(_internalUpdateMaxBatchSize);
+    }
+
     void run() {
         // Run the update.
         {
@@ -354,6 +366,96 @@ public:
             assertHasDoc(objs, fromjson("{_id: 6, foo: 6}"));
         }
     }
+
+private:
+    const int _internalUpdateMaxBatchSize;
+};
+
+/**
+ * Test a batched multi-update on WiredTiger, whose cursors only lend the documents they return
+ * until they are advanced. Every batch holds several documents read through the same cursor.
+ */
+class QueryStageUpdateMultiBatchWiredTiger : public QueryStageUpdateBase {
+public:
+    void run() {
+        if (storageGlobalParams.engine != "wiredTiger") {
+            return;
+        }
+
+        const int batchSize = internalUpdateMaxBatchSize.load();
+        ASSERT_GT(batchSize, 1);
+
+        // Enough documents for several full batches and a partial one. The padding makes each
+        // document large enough that a stale pointer into the cursor would not go unnoticed.
+        const int nDocs = 3 * batchSize + 1;
+        const std::string padding(1024, 'x');
+        {
+            OldClientWriteContext ctx(&_txn, nss.ns());
+            for (int i = 0; i < nDocs; ++i) {
+                insert(BSON("_id" << i << "foo" << i << "padding"
+                                  << (padding + std::to_string(i))));
+            }
+        }
+
+        {
+            OldClientWriteContext ctx(&_txn, nss.ns());
+            OpDebug* opDebug = &CurOp::get(_txn)->debug();
+            UpdateDriver driver((UpdateDriver::Options()));
+            Collection* coll = ctx.getCollection();
+
+            UpdateRequest request(nss);
+            UpdateLifecycleImpl updateLifecycle(nss);
+            request.setLifecycle(&updateLifecycle);
+
+            // Update is a multi-update that copies nothing from the query, so the new version of
+            // each document can only be right if its old version was read correctly.
+            BSONObj query = BSONObj();
+            BSONObj updates = fromjson("{$inc: {foo: 1000}}");
+
+            request.setMulti();
+            request.setQuery(query);
+            request.setUpdates(updates);
+
+            ASSERT_OK(driver.parse(request.getUpdates(), request.isMulti()));
+
+            CollectionScanParams collScanParams;
+            collScanParams.collection = coll;
+            collScanParams.direction = CollectionScanParams::FORWARD;
+            collScanParams.tailable = false;
+
+            UpdateStageParams updateParams(&request, &driver, opDebug);
+            unique_ptr<CanonicalQuery> cq(canonicalize(query));
+            updateParams.canonicalQuery = cq.get();
+
+            auto ws = make_unique<WorkingSet>();
+            auto cs = make_unique<CollectionScan>(&_txn, collScanParams, ws.get(), cq->root());
+
+            auto updateStage =
+                make_unique<UpdateStage>(&_txn, updateParams, ws.get(), coll, cs.release());
+            const UpdateStats* stats =
+                static_cast<const UpdateStats*>(updateStage->getSpecificStats());
+
+            runUpdate(updateStage.get());
+
+            ASSERT_EQUALS(static_cast<size_t>(nDocs), stats->nMatched);
+            ASSERT_EQUALS(static_cast<size_t>(nDocs), stats->nModified);
+        }
+
+        {
+            AutoGetCollectionForRead ctx(&_txn, nss);
+            Collection* collection = ctx.getCollection();
+
+            vector<BSONObj> objs;
+            getCollContents(collection, &objs);
+
+            ASSERT_EQUALS(static_cast<size_t>(nDocs), objs.size());
+            for (int i = 0; i < nDocs; ++i) {
+                assertHasDoc(objs,
+                             BSON("_id" << i << "foo" << (i + 1000) << "padding"
+                                        << (padding + std::to_string(i))));
+            }
+        }
+    }
 };
 
 /**
@@ -601,6 +703,7 @@ public:
         // Stage-specific tests below.
         add<QueryStageUpdateUpsertEmptyColl>();
         add<QueryStageUpdateSkipInvalidatedDoc>();
+        add<QueryStageUpdateMultiBatchWiredTiger>();
         add<QueryStageUpdateReturnOldDoc>();
         add<QueryStageUpdateReturnNewDoc>();
         add<QueryStageUpdateSkipOwnedObjects>();
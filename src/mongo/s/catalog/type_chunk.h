@@ -89,11 +89,10 @@ private:
 
 /**
  * This class represents the layouts and contents of documents contained in the config server's
- * config.chunks and shard server's config.chunks.uuid collections. All manipulation of documents
- * coming from these collections should be done with this class. The shard's config.chunks.uuid
- * collections use the epoch field as the uuid value, and epochs match 1:1 to collection instances
- * (mmapped in config.collections). Therefore, the shard collections do not need to include epoch or
- * namespace fields, as these will be known in order to access the collections.
+ * config.chunks and shard server's config.cache.chunks.<ns> collections. All manipulation of
+ * documents coming from these collections should be done with this class. The shard collections do
+ * not need to include epoch or namespace fields, as these are known from the collection name and
+ * the collection's entry in config.cache.collections (see RoutingMetadataCache).
  *
  * Expected config server config.chunks collection format:
  *   {
@@ -111,7 +110,7 @@ private:
  *      jumbo : false              // optional field
  *   }
  *
- * Expected shard server config.chunks.<epoch> collection format:
+ * Expected shard server config.cache.chunks.<ns> collection format:
  *   {
  *      _id: {
  *             "a" : { "$minKey" : 1 }
@@ -158,15 +157,15 @@ public:
     BSONObj toConfigBSON() const;
 
     /**
-     * Constructs a new ChunkType object from BSON that has a shard server's config.chunks.<epoch>
-     * collection format.
+     * Constructs a new ChunkType object from BSON that has a shard server's
+     * config.cache.chunks.<ns> collection format.
      *
      * Also does validation of the contents.
      */
     static StatusWith<ChunkType> fromShardBSON(const BSONObj& source, const OID& epoch);
 
     /**
-     * Returns the BSON representation of the entry for a shard server's config.chunks.<epoch>
+     * Returns the BSON representation of the entry for a shard server's config.cache.chunks.<ns>
      * collection.
      */
     BSONObj toShardBSON() const;
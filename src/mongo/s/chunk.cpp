@@ -32,11 +32,11 @@
 
 #include "mongo/s/chunk.h"
 
+#include "mongo/db/namespace_string.h"
 #include "mongo/platform/random.h"
 #include "mongo/s/balancer_configuration.h"
 #include "mongo/s/catalog/sharding_catalog_client.h"
 #include "mongo/s/catalog/type_chunk.h"
-#include "mongo/s/chunk_manager.h"
 #include "mongo/s/grid.h"
 #include "mongo/util/log.h"
 
@@ -57,9 +57,8 @@ int64_t mkDataWritten() {
 
 }  // namespace
 
-Chunk::Chunk(ChunkManager* manager, const ChunkType& from)
-    : _manager(manager),
-      _min(from.getMin().getOwned()),
+Chunk::Chunk(const ChunkType& from)
+    : _min(from.getMin().getOwned()),
       _max(from.getMax().getOwned()),
       _shardId(from.getShard()),
       _lastmod(from.getVersion()),
@@ -68,14 +67,12 @@ Chunk::Chunk(ChunkManager* manager, const ChunkType& from)
     invariantOK(from.validate());
 }
 
-Chunk::Chunk(ChunkManager* manager,
-             const BSONObj& min,
+Chunk::Chunk(const BSONObj& min,
              const BSONObj& max,
              const ShardId& shardId,
              ChunkVersion lastmod,
              uint64_t initialDataWritten)
-    : _manager(manager),
-      _min(min),
+    : _min(min),
       _max(max),
       _shardId(shardId),
       _lastmod(lastmod),
@@ -110,7 +107,7 @@ std::string Chunk::toString() const {
                          << _max;
 }
 
-void Chunk::markAsJumbo(OperationContext* txn) const {
+void Chunk::markAsJumbo(OperationContext* txn, const NamespaceString& nss) const {
     log() << "Marking chunk " << toString() << " as jumbo.";
 
     // set this first
@@ -118,7 +115,7 @@ void Chunk::markAsJumbo(OperationContext* txn) const {
     // at least this mongos won't try and keep moving
     _jumbo = true;
 
-    const std::string chunkName = ChunkType::genID(_manager->getns(), _min);
+    const std::string chunkName = ChunkType::genID(nss.ns(), _min);
 
     auto status = Grid::get(txn)->catalogClient(txn)->updateConfigDocument(
         txn,
@@ -34,21 +34,22 @@
 
 namespace mongo {
 
-class ChunkManager;
 class ChunkType;
+class NamespaceString;
 class OperationContext;
 
 /**
- * Represents a cache entry for a single Chunk. Owned by a ChunkManager.
+ * Represents a cache entry for a single Chunk. Chunks are immutable apart from their statistics and
+ * do not reference the ChunkManager which contains them, so that successive versions of the routing
+ * table for a collection can share the entries for chunks which did not change between refreshes.
  */
 class Chunk {
     MONGO_DISALLOW_COPYING(Chunk);
 
 public:
-    Chunk(ChunkManager* manager, const ChunkType& from);
+    explicit Chunk(const ChunkType& from);
 
-    Chunk(ChunkManager* manager,
-          const BSONObj& min,
+    Chunk(const BSONObj& min,
           const BSONObj& max,
           const ShardId& shardId,
           ChunkVersion lastmod,
@@ -97,12 +98,9 @@ public:
      * marks this chunk as a jumbo chunk
      * that means the chunk will be inelligble for migrates
      */
-    void markAsJumbo(OperationContext* txn) const;
+    void markAsJumbo(OperationContext* txn, const NamespaceString& nss) const;
 
 private:
-    // The chunk manager, which owns this chunk. Not owned by the chunk.
-    const ChunkManager* _manager;
-
     const BSONObj _min;
 
     const BSONObj _max;
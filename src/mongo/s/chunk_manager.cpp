@@ -36,10 +36,12 @@
 #include <map>
 #include <set>
 
+#include "mongo/base/counter.h"
 #include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/bson/util/bson_extract.h"
 #include "mongo/client/read_preference.h"
 #include "mongo/client/remote_command_targeter.h"
+#include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/matcher/extensions_callback_noop.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/operation_context.h"
@@ -48,10 +50,13 @@
 #include "mongo/db/query/index_bounds_builder.h"
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/query/query_planner_common.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/stats/timer_stats.h"
 #include "mongo/rpc/get_status_from_command_result.h"
 #include "mongo/s/balancer_configuration.h"
 #include "mongo/s/catalog/catalog_cache.h"
 #include "mongo/s/catalog/sharding_catalog_client.h"
+#include "mongo/s/catalog/type_chunk.h"
 #include "mongo/s/catalog/type_collection.h"
 #include "mongo/s/chunk_diff.h"
 #include "mongo/s/client/shard_registry.h"
@@ -76,6 +81,31 @@ namespace {
 // Used to generate sequence numbers to assign to each newly created ChunkManager
 AtomicUInt32 nextCMSequenceNumber(0);
 
+// Chunk manager refresh statistics
+TimerStats refreshStats;
+ServerStatusMetricField<TimerStats> displayRefreshes("sharding.chunkManager.refreshes",
+                                                     &refreshStats);
+
+Counter64 incrementalRefreshes;
+ServerStatusMetricField<Counter64> displayIncrementalRefreshes(
+    "sharding.chunkManager.incrementalRefreshes", &incrementalRefreshes);
+
+Counter64 chunksReused;
+ServerStatusMetricField<Counter64> displayChunksReused("sharding.chunkManager.chunksReused",
+                                                       &chunksReused);
+
+Counter64 chunksLoaded;
+ServerStatusMetricField<Counter64> displayChunksLoaded("sharding.chunkManager.chunksLoaded",
+                                                       &chunksLoaded);
+
+Counter64 chunksFromShardCache;
+ServerStatusMetricField<Counter64> displayChunksFromShardCache(
+    "sharding.chunkManager.chunksFromShardCache", &chunksFromShardCache);
+
+// Whether a router without any routing information for a collection should start from the routing
+// table cached by the primary shard instead of reading all the chunks from the config servers
+MONGO_EXPORT_SERVER_PARAMETER(loadRoutingTableFromPrimaryShard, bool, true);
+
 /**
  * This is an adapter so we can use config diffs - mongos and mongod do them slightly differently.
  *
@@ -86,10 +116,8 @@ public:
     CMConfigDiffTracker(const std::string& ns,
                         RangeMap* currMap,
                         ChunkVersion* maxVersion,
-                        MaxChunkVersionMap* maxShardVersions,
-                        ChunkManager* manager)
-        : ConfigDiffTracker<shared_ptr<Chunk>>(ns, currMap, maxVersion, maxShardVersions),
-          _manager(manager) {}
+                        MaxChunkVersionMap* maxShardVersions)
+        : ConfigDiffTracker<shared_ptr<Chunk>>(ns, currMap, maxVersion, maxShardVersions) {}
 
     bool isTracked(const ChunkType& chunk) const final {
         // Mongos tracks all shards
@@ -102,18 +130,94 @@ public:
 
     pair<BSONObj, shared_ptr<Chunk>> rangeFor(OperationContext* txn,
                                               const ChunkType& chunk) const final {
-        return std::make_pair(chunk.getMax(), std::make_shared<Chunk>(_manager, chunk));
+        return std::make_pair(chunk.getMax(), std::make_shared<Chunk>(chunk));
     }
 
     ShardId shardFor(OperationContext* txn, const ShardId& shardId) const final {
         const auto shard = uassertStatusOK(Grid::get(txn)->shardRegistry()->getShard(txn, shardId));
         return shard->getId();
     }
-
-private:
-    ChunkManager* const _manager;
 };
 
+/**
+ * Retrieves the routing table of 'ns', which the shard 'shardId' persisted in its routing metadata
+ * cache, in increasing version order. Returns an empty vector if it is not available for any
+ * reason, in which case all the chunks need to be read from the config servers.
+ *
+ * The shard chunk format does not include the jumbo flag, so it is only known for the chunks which
+ * are read from the config servers.
+ */
+std::vector<ChunkType> getCachedRoutingTable(OperationContext* txn,
+                                             const std::string& ns,
+                                             const ShardId& shardId,
+                                             const OID& epoch) {
+    std::vector<ChunkType> chunks;
+
+    Status status = [&] {
+        auto shardStatus = grid.shardRegistry()->getShard(txn, shardId);
+        if (!shardStatus.isOK()) {
+            return shardStatus.getStatus();
+        }
+
+        auto cmdStatus = shardStatus.getValue()->runCommandWithFixedRetryAttempts(
+            txn,
+            ReadPreferenceSetting{ReadPreference::PrimaryOnly},
+            "admin",
+            BSON("_getCachedRoutingTable" << ns),
+            Shard::RetryPolicy::kIdempotent);
+        if (!cmdStatus.isOK()) {
+            return cmdStatus.getStatus();
+        }
+        if (!cmdStatus.getValue().commandStatus.isOK()) {
+            return cmdStatus.getValue().commandStatus;
+        }
+
+        const BSONObj& response = cmdStatus.getValue().response;
+
+        OID cachedEpoch;
+        Status status = bsonExtractOIDField(response, "epoch", &cachedEpoch);
+        if (!status.isOK()) {
+            return status;
+        }
+        if (cachedEpoch != epoch) {
+            return Status(ErrorCodes::StaleEpoch,
+                          str::stream() << "cached routing table has epoch " << cachedEpoch
+                                        << " instead of "
+                                        << epoch);
+        }
+
+        BSONElement chunksElem;
+        status = bsonExtractTypedField(response, "chunks", Array, &chunksElem);
+        if (!status.isOK()) {
+            return status;
+        }
+
+        for (const auto& chunkElem : chunksElem.Obj()) {
+            if (chunkElem.type() != Object) {
+                return Status(ErrorCodes::TypeMismatch, "cached chunk is not an object");
+            }
+
+            auto statusWithChunk = ChunkType::fromShardBSON(chunkElem.Obj(), epoch);
+            if (!statusWithChunk.isOK()) {
+                return statusWithChunk.getStatus();
+            }
+
+            chunks.push_back(std::move(statusWithChunk.getValue()));
+            chunks.back().setNS(ns);
+        }
+
+        return Status::OK();
+    }();
+
+    if (!status.isOK()) {
+        LOG(1) << "Not using the routing table cached by shard " << shardId << " for " << ns
+               << causedBy(redact(status));
+        chunks.clear();
+    }
+
+    return chunks;
+}
+
 bool allOfType(BSONType type, const BSONObj& o) {
     BSONObjIterator it(o);
     while (it.more()) {
@@ -201,7 +305,9 @@ ChunkManager::ChunkManager(OperationContext* txn, const CollectionType& coll)
     }
 }
 
-void ChunkManager::loadExistingRanges(OperationContext* txn, const ChunkManager* oldManager) {
+void ChunkManager::loadExistingRanges(OperationContext* txn,
+                                      const ChunkManager* oldManager,
+                                      const ShardId& cacheShardId) {
     invariant(!_version.isSet());
 
     int tries = 3;
@@ -217,15 +323,29 @@ void ChunkManager::loadExistingRanges(OperationContext* txn, const ChunkManager*
         log() << "ChunkManager loading chunks for " << _ns << " sequenceNumber: " << _sequenceNumber
               << " based on: " << (oldManager ? oldManager->getVersion().toString() : "(empty)");
 
-        if (_load(txn, chunkMap, shardIds, &shardVersions, oldManager)) {
+        // Only the first attempt uses the cached routing table, in case it is what is inconsistent
+        if (_load(txn,
+                  chunkMap,
+                  shardIds,
+                  &shardVersions,
+                  oldManager,
+                  tries == 2 ? cacheShardId : ShardId())) {
             // TODO: Merge into diff code above, so we validate in one place
             if (isChunkMapValid(chunkMap)) {
                 _chunkMap = std::move(chunkMap);
                 _shardIds = std::move(shardIds);
                 _shardVersions = std::move(shardVersions);
                 _chunkRangeMap = _constructRanges(_chunkMap);
+                _routingIndex = (oldManager && oldManager->getVersion().isSet())
+                    ? ChunkRoutingIndex(_chunkMap, oldManager->_routingIndex)
+                    : ChunkRoutingIndex(_chunkMap);
 
-                log() << "ChunkManager load took " << t.millis() << " ms and found version "
+                const int millis = refreshStats.record(t);
+                if (oldManager && oldManager->getVersion().isSet()) {
+                    incrementalRefreshes.increment();
+                }
+
+                log() << "ChunkManager load took " << millis << " ms and found version "
                       << _version;
 
                 return;
@@ -248,7 +368,8 @@ bool ChunkManager::_load(OperationContext* txn,
                          ChunkMap& chunkMap,
                          set<ShardId>& shardIds,
                          ShardVersionMap* shardVersions,
-                         const ChunkManager* oldManager) {
+                         const ChunkManager* oldManager,
+                         const ShardId& cacheShardId) {
     // Reset the max version, but not the epoch, when we aren't loading from the oldManager
     _version = ChunkVersion(0, 0, _version.epoch());
 
@@ -261,23 +382,13 @@ bool ChunkManager::_load(OperationContext* txn,
         // Load a copy of the old versions
         *shardVersions = oldManager->_shardVersions;
 
-        // Load a copy of the chunk map, replacing the chunk manager with our own
+        // Chunks do not reference their owning manager, so the entries of the old chunk map can
+        // be shared with the new one. Copying the map clones its tree structure in linear time
+        // without any key comparisons and the diff below only replaces the chunks which changed.
         const ChunkMap& oldChunkMap = oldManager->getChunkMap();
+        chunkMap = oldChunkMap;
 
-        // Could be v.expensive
-        // TODO: If chunks were immutable and didn't reference the manager, we could do more
-        // interesting things here
-        for (const auto& oldChunkMapEntry : oldChunkMap) {
-            shared_ptr<Chunk> oldC = oldChunkMapEntry.second;
-            shared_ptr<Chunk> newC(new Chunk(this,
-                                             oldC->getMin(),
-                                             oldC->getMax(),
-                                             oldC->getShardId(),
-                                             oldC->getLastmod(),
-                                             oldC->getBytesWritten()));
-
-            chunkMap.insert(std::make_pair(oldC->getMax(), newC));
-        }
+        chunksReused.increment(oldChunkMap.size());
 
         LOG(2) << "loading chunk manager for collection " << _ns
                << " using old chunk manager w/ version " << _version.toString() << " and "
@@ -285,7 +396,37 @@ bool ChunkManager::_load(OperationContext* txn,
     }
 
     // Attach a diff tracker for the versioned chunk data
-    CMConfigDiffTracker differ(_ns, &chunkMap, &_version, shardVersions, this);
+    CMConfigDiffTracker differ(_ns, &chunkMap, &_version, shardVersions);
+
+    // Without a previous version to work from, the routing table cached by the primary shard can
+    // serve as the base for the diff instead, so that only the chunks which changed since it was
+    // written need to be read from the config servers
+    if (!_version.isSet() && _version.epoch().isSet() && cacheShardId.isValid() &&
+        loadRoutingTableFromPrimaryShard.load()) {
+        const auto cachedChunks = getCachedRoutingTable(txn, _ns, cacheShardId, _version.epoch());
+        if (!cachedChunks.empty()) {
+            int cachedApplied = -1;
+            try {
+                cachedApplied = differ.calculateConfigDiff(txn, cachedChunks);
+            } catch (const DBException& ex) {
+                LOG(1) << "Failed to apply the routing table cached by shard " << cacheShardId
+                       << " for " << _ns << causedBy(redact(ex));
+            }
+
+            if (cachedApplied > 0) {
+                chunksFromShardCache.increment(cachedApplied);
+
+                LOG(2) << "loading chunk manager for collection " << _ns
+                       << " using the routing table cached by shard " << cacheShardId
+                       << " w/ version " << _version.toString() << " and " << chunkMap.size()
+                       << " chunks";
+            } else {
+                chunkMap.clear();
+                shardVersions->clear();
+                _version = ChunkVersion(0, 0, _version.epoch());
+            }
+        }
+    }
 
     // Diff tracker should *always* find at least one chunk if collection exists
     // Get the diff query required
@@ -307,6 +448,8 @@ bool ChunkManager::_load(OperationContext* txn,
 
     int diffsApplied = differ.calculateConfigDiff(txn, chunks);
     if (diffsApplied > 0) {
+        chunksLoaded.increment(diffsApplied);
+
         LOG(2) << "loaded " << diffsApplied << " chunks into new chunk manager for " << _ns
                << " with version " << _version;
 
@@ -485,16 +628,7 @@ StatusWith<shared_ptr<Chunk>> ChunkManager::findIntersectingChunk(OperationConte
         }
     }
 
-    BSONObj chunkMin;
-    shared_ptr<Chunk> chunk;
-    {
-        ChunkMap::const_iterator it = _chunkMap.upper_bound(shardKey);
-        if (it != _chunkMap.end()) {
-            chunkMin = it->first;
-            chunk = it->second;
-        }
-    }
-
+    shared_ptr<Chunk> chunk = _routingIndex.findChunk(shardKey);
     if (!chunk) {
         // TODO: This should be an invariant
         msgasserted(8070,
@@ -512,7 +646,6 @@ StatusWith<shared_ptr<Chunk>> ChunkManager::findIntersectingChunk(OperationConte
     }
 
     // TODO: This should be an invariant
-    log() << redact(chunkMin.toString());
     log() << redact((*chunk).toString());
     log() << redact(shardKey);
 
@@ -534,6 +667,22 @@ shared_ptr<Chunk> ChunkManager::findIntersectingChunkWithSimpleCollation(
     return chunk.getValue();
 }
 
+void ChunkManager::findIntersectingChunksWithSimpleCollation(
+    OperationContext* txn,
+    const std::vector<BSONObj>& shardKeys,
+    std::vector<std::shared_ptr<Chunk>>* chunks) const {
+    _routingIndex.findChunks(shardKeys, chunks);
+
+    for (size_t i = 0; i < shardKeys.size(); i++) {
+        const auto& chunk = (*chunks)[i];
+        if (!chunk || !chunk->containsKey(shardKeys[i])) {
+            // Use the single key path so that the inconsistency is reported and the chunk manager
+            // gets reloaded
+            (*chunks)[i] = findIntersectingChunkWithSimpleCollation(txn, shardKeys[i]);
+        }
+    }
+}
+
 void ChunkManager::getShardIdsForQuery(OperationContext* txn,
                                        const BSONObj& query,
                                        const BSONObj& collation,
@@ -582,7 +731,16 @@ void ChunkManager::getShardIdsForQuery(OperationContext* txn,
     //   => Ranges { a : 1, b : 3 } => { a : 2, b : 4 }
     BoundList ranges = _keyPattern.flattenBounds(bounds);
 
+    // Point ranges, such as the ones produced by an $in on the shard key, are targeted together
+    // through the routing index, in a single pass over the chunk boundaries
+    vector<BSONObj> points;
+
     for (BoundList::const_iterator it = ranges.begin(); it != ranges.end(); ++it) {
+        if (SimpleBSONObjComparator::kInstance.evaluate(it->first == it->second)) {
+            points.push_back(it->first);
+            continue;
+        }
+
         getShardIdsForRange(*shardIds, it->first /*min*/, it->second /*max*/);
 
         // once we know we need to visit all shards no need to keep looping
@@ -590,6 +748,19 @@ void ChunkManager::getShardIdsForQuery(OperationContext* txn,
             break;
     }
 
+    if (!points.empty() && shardIds->size() < _shardIds.size()) {
+        vector<shared_ptr<Chunk>> chunks;
+        _routingIndex.findChunks(points, &chunks);
+
+        for (size_t i = 0; i < points.size(); i++) {
+            if (chunks[i] && chunks[i]->containsKey(points[i])) {
+                shardIds->insert(chunks[i]->getShardId());
+            } else {
+                getShardIdsForRange(*shardIds, points[i], points[i]);
+            }
+        }
+    }
+
     // SERVER-4914 Some clients of getShardIdsForQuery() assume at least one shard will be returned.
     // For now, we satisfy that assumption by adding a shard with no matches rather than returning
     // an empty set of shards.
@@ -792,15 +963,20 @@ ChunkManager::ChunkRangeMap ChunkManager::_constructRanges(const ChunkMap& chunk
         const BSONObj rangeMin = rangeFirst->second->getMin();
         const BSONObj rangeMax = rangeLast->second->getMax();
 
-        auto insertResult = chunkRangeMap.insert(std::make_pair(
-            rangeMax, ShardAndChunkRange(rangeMin, rangeMax, rangeFirst->second->getShardId())));
-        invariant(insertResult.second);
-        if (insertResult.first != chunkRangeMap.begin()) {
-            // Make sure there are no gaps in the ranges
-            insertResult.first--;
-            invariant(
-                SimpleBSONObjComparator::kInstance.evaluate(insertResult.first->first == rangeMin));
+        // Make sure there are no gaps in the ranges
+        if (!chunkRangeMap.empty()) {
+            invariant(SimpleBSONObjComparator::kInstance.evaluate(
+                chunkRangeMap.rbegin()->first == rangeMin));
         }
+
+        // The ranges are generated in increasing order, so hinting the insertion at the end of the
+        // map avoids searching the tree for each of them
+        const auto sizeBefore = chunkRangeMap.size();
+        chunkRangeMap.emplace_hint(
+            chunkRangeMap.end(),
+            rangeMax,
+            ShardAndChunkRange(rangeMin, rangeMax, rangeFirst->second->getShardId()));
+        invariant(chunkRangeMap.size() == sizeBefore + 1);
     }
 
     invariant(!chunkRangeMap.empty());
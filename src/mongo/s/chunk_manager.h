@@ -38,6 +38,7 @@
 #include "mongo/db/repl/optime.h"
 #include "mongo/s/catalog/type_chunk.h"
 #include "mongo/s/chunk.h"
+#include "mongo/s/chunk_routing_index.h"
 #include "mongo/s/chunk_version.h"
 #include "mongo/s/client/shard.h"
 #include "mongo/s/shard_key_pattern.h"
@@ -100,8 +101,12 @@ public:
                              const std::vector<BSONObj>* initPoints,
                              const std::set<ShardId>* initShardIds);
 
-    // Loads existing ranges based on info in chunk manager
-    void loadExistingRanges(OperationContext* txn, const ChunkManager* oldManager);
+    // Loads existing ranges based on info in chunk manager. Without an old manager to diff
+    // against, the routing table cached by 'cacheShardId' (normally the primary shard of the
+    // database) is used as the base, if it is valid and available.
+    void loadExistingRanges(OperationContext* txn,
+                            const ChunkManager* oldManager,
+                            const ShardId& cacheShardId = ShardId());
 
 
     // Helpers for load
@@ -143,6 +148,16 @@ public:
     std::shared_ptr<Chunk> findIntersectingChunkWithSimpleCollation(OperationContext* txn,
                                                                     const BSONObj& shardKey) const;
 
+    /**
+     * Batched variant of findIntersectingChunkWithSimpleCollation, which targets all the passed
+     * shard keys in a single pass over the chunk boundaries. On return, 'chunks' contains the
+     * intersecting chunk for each key, in the same order as 'shardKeys'.
+     */
+    void findIntersectingChunksWithSimpleCollation(
+        OperationContext* txn,
+        const std::vector<BSONObj>& shardKeys,
+        std::vector<std::shared_ptr<Chunk>>* chunks) const;
+
     /**
      * Finds the shard IDs for a given filter and collation. If collation is empty, we use the
      * collection default collation for targeting.
@@ -240,7 +255,8 @@ private:
                ChunkMap& chunks,
                std::set<ShardId>& shardIds,
                ShardVersionMap* shardVersions,
-               const ChunkManager* oldManager);
+               const ChunkManager* oldManager,
+               const ShardId& cacheShardId);
 
     /**
      * Merges consecutive chunks, which reside on the same shard into a single range.
@@ -261,6 +277,10 @@ private:
     ChunkMap _chunkMap;
     ChunkRangeMap _chunkRangeMap;
 
+    // Compact copy of _chunkMap used for targeting shard keys. Must be rebuilt whenever _chunkMap
+    // changes.
+    ChunkRoutingIndex _routingIndex;
+
     std::set<ShardId> _shardIds;
 
     // Max known version per shard
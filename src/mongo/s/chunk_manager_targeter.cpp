@@ -282,6 +282,30 @@ bool wasMetadataRefreshed(const shared_ptr<ChunkManager>& managerA,
     return false;
 }
 
+/**
+ * Extracts the shard key of a document which is being inserted in a sharded collection. Inserts
+ * must contain the exact shard key.
+ */
+StatusWith<BSONObj> extractInsertShardKey(const ShardKeyPattern& shardKeyPattern,
+                                          const BSONObj& doc) {
+    BSONObj shardKey = shardKeyPattern.extractShardKeyFromDoc(doc);
+
+    // Check shard key exists
+    if (shardKey.isEmpty()) {
+        return Status(ErrorCodes::ShardKeyNotFound,
+                      stream() << "document " << doc
+                               << " does not contain shard key for pattern "
+                               << shardKeyPattern.toString());
+    }
+
+    // Check shard key size on insert
+    Status status = ShardKeyPattern::checkShardKeySize(shardKey);
+    if (!status.isOK())
+        return status;
+
+    return shardKey;
+}
+
 }  // namespace
 
 ChunkManagerTargeter::ChunkManagerTargeter(const NamespaceString& nss, TargeterStats* stats)
@@ -311,26 +335,11 @@ Status ChunkManagerTargeter::targetInsert(OperationContext* txn,
     BSONObj shardKey;
 
     if (_manager) {
-        //
-        // Sharded collections have the following requirements for targeting:
-        //
-        // Inserts must contain the exact shard key.
-        //
-
-        shardKey = _manager->getShardKeyPattern().extractShardKeyFromDoc(doc);
-
-        // Check shard key exists
-        if (shardKey.isEmpty()) {
-            return Status(ErrorCodes::ShardKeyNotFound,
-                          stream() << "document " << doc
-                                   << " does not contain shard key for pattern "
-                                   << _manager->getShardKeyPattern().toString());
-        }
+        auto shardKeyStatus = extractInsertShardKey(_manager->getShardKeyPattern(), doc);
+        if (!shardKeyStatus.isOK())
+            return shardKeyStatus.getStatus();
 
-        // Check shard key size on insert
-        Status status = ShardKeyPattern::checkShardKeySize(shardKey);
-        if (!status.isOK())
-            return status;
+        shardKey = std::move(shardKeyStatus.getValue());
     }
 
     // Target the shard key or database primary
@@ -348,6 +357,69 @@ Status ChunkManagerTargeter::targetInsert(OperationContext* txn,
     }
 }
 
+void ChunkManagerTargeter::targetInserts(OperationContext* txn,
+                                         const vector<BSONObj>& docs,
+                                         vector<ShardEndpoint*>* endpoints,
+                                         vector<BSONObj>* chunkMins,
+                                         vector<Status>* statuses) const {
+    if (!_manager) {
+        for (const BSONObj& doc : docs) {
+            ShardEndpoint* endpoint = NULL;
+            statuses->push_back(targetInsert(txn, doc, &endpoint));
+            endpoints->push_back(endpoint);
+            chunkMins->push_back(BSONObj());
+        }
+        return;
+    }
+
+    const size_t firstResult = endpoints->size();
+    endpoints->resize(firstResult + docs.size(), NULL);
+    chunkMins->resize(firstResult + docs.size());
+    statuses->resize(firstResult + docs.size(), Status::OK());
+
+    // Extract the shard keys of all the documents first, so they can be looked up together
+    vector<BSONObj> shardKeys;
+    vector<size_t> shardKeyDocs;
+    shardKeys.reserve(docs.size());
+    shardKeyDocs.reserve(docs.size());
+
+    for (size_t i = 0; i < docs.size(); i++) {
+        auto shardKeyStatus = extractInsertShardKey(_manager->getShardKeyPattern(), docs[i]);
+        if (!shardKeyStatus.isOK()) {
+            (*statuses)[firstResult + i] = shardKeyStatus.getStatus();
+            continue;
+        }
+
+        shardKeys.push_back(std::move(shardKeyStatus.getValue()));
+        shardKeyDocs.push_back(i);
+    }
+
+    if (shardKeys.empty()) {
+        return;
+    }
+
+    vector<shared_ptr<Chunk>> chunks;
+    _manager->findIntersectingChunksWithSimpleCollation(txn, shardKeys, &chunks);
+
+    for (size_t i = 0; i < shardKeys.size(); i++) {
+        const auto& chunk = chunks[i];
+
+        (*endpoints)[firstResult + shardKeyDocs[i]] =
+            new ShardEndpoint(chunk->getShardId(), _manager->getVersion(chunk->getShardId()));
+        (*chunkMins)[firstResult + shardKeyDocs[i]] = chunk->getMin();
+    }
+}
+
+void ChunkManagerTargeter::noteInsertAdded(const BSONObj& chunkMin, int sizeBytes) const {
+    if (chunkMin.isEmpty()) {
+        return;
+    }
+
+    // Track autosplit stats for sharded collections
+    // Note: this is only best effort accounting and is not accurate.
+    _stats->chunkSizeDelta[chunkMin] += sizeBytes;
+}
+
 Status ChunkManagerTargeter::targetUpdate(OperationContext* txn,
                                           const BatchedUpdateDocument& updateDoc,
                                           vector<ShardEndpoint*>* endpoints) const {
@@ -76,6 +76,15 @@ public:
     // Returns ShardKeyNotFound if document does not have a full shard key.
     Status targetInsert(OperationContext* txn, const BSONObj& doc, ShardEndpoint** endpoint) const;
 
+    // Targets the shard keys of all the documents in one pass over the chunk boundaries.
+    void targetInserts(OperationContext* txn,
+                       const std::vector<BSONObj>& docs,
+                       std::vector<ShardEndpoint*>* endpoints,
+                       std::vector<BSONObj>* chunkMins,
+                       std::vector<Status>* statuses) const;
+
+    void noteInsertAdded(const BSONObj& chunkMin, int sizeBytes) const;
+
     // Returns ShardKeyNotFound if the update can't be targeted without a shard key.
     Status targetUpdate(OperationContext* txn,
                         const BatchedUpdateDocument& updateDoc,
@@ -30,12 +30,15 @@
 
 #include "mongo/platform/basic.h"
 
+#include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/db/json.h"
 #include "mongo/db/matcher/extensions_callback_noop.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/query/canonical_query.h"
 #include "mongo/db/query/query_test_service_context.h"
+#include "mongo/platform/random.h"
 #include "mongo/s/chunk_manager.h"
+#include "mongo/s/chunk_routing_index.h"
 #include "mongo/s/shard_key_pattern.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/log.h"
@@ -520,4 +523,158 @@ TEST(CMKeyBoundsTest, NonPointIntervalExpasion) {
     CheckBoundList(list, expectedList);
 }
 
+/**
+ * Builds a chunk map with the specified split points, which must be sorted, covering the whole key
+ * space of 'keyPattern'.
+ */
+ChunkMap makeChunkMap(const BSONObj& keyPattern, const std::vector<BSONObj>& splitPoints) {
+    ShardKeyPattern shardKeyPattern(keyPattern);
+
+    std::vector<BSONObj> bounds;
+    bounds.push_back(shardKeyPattern.getKeyPattern().globalMin());
+    bounds.insert(bounds.end(), splitPoints.begin(), splitPoints.end());
+    bounds.push_back(shardKeyPattern.getKeyPattern().globalMax());
+
+    ChunkMap chunkMap =
+        SimpleBSONObjComparator::kInstance.makeBSONObjIndexedMap<std::shared_ptr<Chunk>>();
+    for (size_t i = 1; i < bounds.size(); i++) {
+        chunkMap.emplace(bounds[i],
+                         std::make_shared<Chunk>(bounds[i - 1],
+                                                 bounds[i],
+                                                 ShardId(str::stream() << "shard" << (i % 10)),
+                                                 ChunkVersion(1, i, OID()),
+                                                 0));
+    }
+
+    return chunkMap;
+}
+
+/**
+ * Checks that the routing index returns the same chunks as an upper_bound lookup in the chunk map,
+ * both for single and batched lookups.
+ */
+void checkRoutingIndex(const ChunkMap& chunkMap, const std::vector<BSONObj>& shardKeys) {
+    ChunkRoutingIndex index(chunkMap);
+    ASSERT_EQ(chunkMap.size(), index.size());
+
+    std::vector<std::shared_ptr<Chunk>> batchedChunks;
+    index.findChunks(shardKeys, &batchedChunks);
+    ASSERT_EQ(shardKeys.size(), batchedChunks.size());
+
+    for (size_t i = 0; i < shardKeys.size(); i++) {
+        auto it = chunkMap.upper_bound(shardKeys[i]);
+        auto expected = (it == chunkMap.end()) ? nullptr : it->second;
+
+        ASSERT_EQ(expected.get(), index.findChunk(shardKeys[i]).get()) << shardKeys[i];
+        ASSERT_EQ(expected.get(), batchedChunks[i].get()) << shardKeys[i];
+    }
+}
+
+TEST(ChunkRoutingIndexTest, Empty) {
+    ChunkRoutingIndex index;
+    ASSERT(index.empty());
+    ASSERT(!index.findChunk(BSON("a" << 1)));
+}
+
+TEST(ChunkRoutingIndexTest, SingleChunk) {
+    const auto chunkMap = makeChunkMap(BSON("a" << 1), {});
+    checkRoutingIndex(chunkMap,
+                      {BSON("a" << MINKEY), BSON("a" << 0), BSON("a" << "x"), BSON("a" << MAXKEY)});
+}
+
+TEST(ChunkRoutingIndexTest, MixedNumericTypesAndBoundaries) {
+    const auto chunkMap = makeChunkMap(
+        BSON("a" << 1), {BSON("a" << -10), BSON("a" << 0), BSON("a" << 2.5), BSON("a" << 100LL)});
+    checkRoutingIndex(chunkMap,
+                      {BSON("a" << MINKEY),
+                       BSON("a" << -11),
+                       BSON("a" << -10),
+                       BSON("a" << -10.0),
+                       BSON("a" << 0LL),
+                       BSON("a" << 2),
+                       BSON("a" << 2.5),
+                       BSON("a" << 2.6),
+                       BSON("a" << 99.99),
+                       BSON("a" << 100),
+                       BSON("a" << 1000000000000LL),
+                       BSON("a" << "string"),
+                       BSON("a" << MAXKEY)});
+}
+
+TEST(ChunkRoutingIndexTest, CompoundKey) {
+    const auto chunkMap = makeChunkMap(BSON("a" << 1 << "b" << 1),
+                                       {BSON("a" << 1 << "b" << MINKEY),
+                                        BSON("a" << 1 << "b" << "m"),
+                                        BSON("a" << 2 << "b" << MINKEY),
+                                        BSON("a" << "x" << "b" << 5)});
+    checkRoutingIndex(chunkMap,
+                      {BSON("a" << 0 << "b" << "z"),
+                       BSON("a" << 1 << "b" << MINKEY),
+                       BSON("a" << 1 << "b" << "a"),
+                       BSON("a" << 1 << "b" << "m"),
+                       BSON("a" << 1 << "b" << "ma"),
+                       BSON("a" << 1.5 << "b" << 0),
+                       BSON("a" << "x" << "b" << 4),
+                       BSON("a" << "x" << "b" << 5),
+                       BSON("a" << MAXKEY << "b" << MAXKEY)});
+}
+
+TEST(ChunkRoutingIndexTest, RandomKeys) {
+    PseudoRandom random(1);
+
+    std::vector<BSONObj> splitPoints;
+    for (int i = 1; i < 1000; i++) {
+        splitPoints.push_back(BSON("a" << i * 1000));
+    }
+
+    const auto chunkMap = makeChunkMap(BSON("a" << 1), splitPoints);
+
+    std::vector<BSONObj> shardKeys;
+    for (int i = 0; i < 10000; i++) {
+        // Produce duplicates and keys on the chunk boundaries
+        shardKeys.push_back(BSON("a" << (random.nextInt32(1000 * 1000) / 10) * 10));
+    }
+
+    checkRoutingIndex(chunkMap, shardKeys);
+}
+
+TEST(ChunkRoutingIndexTest, RebuildFromPrevious) {
+    const auto oldChunkMap = makeChunkMap(BSON("a" << 1), {BSON("a" << 10), BSON("a" << 20)});
+    const ChunkRoutingIndex oldIndex(oldChunkMap);
+
+    // Split the middle chunk and replace the last one, keeping the first one as it is
+    ChunkMap chunkMap = oldChunkMap;
+    auto middle = chunkMap.find(BSON("a" << 20));
+    auto last = chunkMap.find(BSON("a" << MAXKEY));
+    chunkMap.erase(middle);
+    chunkMap.emplace(BSON("a" << 15),
+                     std::make_shared<Chunk>(BSON("a" << 10),
+                                             BSON("a" << 15),
+                                             ShardId("shard1"),
+                                             ChunkVersion(2, 0, OID()),
+                                             0));
+    chunkMap.emplace(BSON("a" << 20),
+                     std::make_shared<Chunk>(BSON("a" << 15),
+                                             BSON("a" << 20),
+                                             ShardId("shard2"),
+                                             ChunkVersion(2, 1, OID()),
+                                             0));
+    last->second = std::make_shared<Chunk>(BSON("a" << 20),
+                                           BSON("a" << MAXKEY),
+                                           ShardId("shard3"),
+                                           ChunkVersion(2, 2, OID()),
+                                           0);
+
+    const ChunkRoutingIndex index(chunkMap, oldIndex);
+    ASSERT_EQ(chunkMap.size(), index.size());
+
+    for (int key : {0, 9, 10, 14, 15, 19, 20, 1000}) {
+        auto it = chunkMap.upper_bound(BSON("a" << key));
+        ASSERT_EQ(it->second.get(), index.findChunk(BSON("a" << key)).get()) << key;
+    }
+
+    ASSERT_EQ(oldChunkMap.begin()->second.get(), index.findChunk(BSON("a" << 0)).get());
+    ASSERT(!index.findChunk(BSON("a" << MAXKEY)));
+}
+
 }  // namespace
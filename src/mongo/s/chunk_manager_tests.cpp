@@ -31,6 +31,7 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/client/remote_command_targeter_mock.h"
+#include "mongo/db/json.h"
 #include "mongo/db/operation_context_noop.h"
 #include "mongo/s/catalog/sharding_catalog_test_fixture.h"
 #include "mongo/s/catalog/type_chunk.h"
@@ -235,6 +236,17 @@ TEST_F(ChunkManagerTests, Basic) {
 
         ASSERT_EQ(numChunks, static_cast<int>(manager.getChunkMap().size()));
         ASSERT_EQ(laterVersion.toString(), newManager.getVersion().toString());
+
+        // Only the two chunks returned by the diff query should have been replaced, the rest must
+        // be shared with the old chunk manager
+        int numShared = 0;
+        for (const auto& entry : newManager.getChunkMap()) {
+            auto oldIt = manager.getChunkMap().find(entry.first);
+            if (oldIt != manager.getChunkMap().end() && oldIt->second == entry.second) {
+                numShared++;
+            }
+        }
+        ASSERT_EQ(numChunks - 2, numShared);
     });
     expectFindOnConfigSendBSONObjVector(std::vector<BSONObj>{chunks.back(), newChunk.obj()});
 
@@ -273,5 +285,95 @@ TEST_F(ChunkManagerTests, FullTest) {
     future.timed_get(kFutureTimeout);
 }
 
+/**
+ * Tests batched targeting of shard keys and targeting of point ranges against chunks which are
+ * distributed across two shards.
+ */
+TEST_F(ChunkManagerTests, TargetPointsOnTwoShards) {
+    const ShardId otherShardId{"shard0001"};
+    const OID epoch = OID::gen();
+
+    std::vector<BSONObj> shards{
+        BSON(ShardType::name() << _shardId << ShardType::host()
+                               << ConnectionString(HostAndPort("hostFooBar:27017")).toString()),
+        BSON(ShardType::name() << otherShardId << ShardType::host()
+                               << ConnectionString(HostAndPort("hostBarFoo:27017")).toString())};
+
+    // Chunks [MinKey, 0), [0, 10), ..., [90, MaxKey), alternating between the two shards
+    std::vector<BSONObj> chunks;
+    BSONObj min = BSON("x" << MINKEY);
+    for (int i = 0; i <= 10; i++) {
+        BSONObj max = (i < 10) ? BSON("x" << i * 10) : BSON("x" << MAXKEY);
+
+        ChunkType chunk;
+        chunk.setNS(_collName);
+        chunk.setMin(min);
+        chunk.setMax(max);
+        chunk.setShard(i % 2 ? otherShardId : _shardId);
+        chunk.setVersion(ChunkVersion(1, i, epoch));
+        chunks.push_back(chunk.toConfigBSON());
+
+        min = max;
+    }
+
+    CollectionType collType;
+    collType.setNs(NamespaceString{_collName});
+    collType.setEpoch(epoch);
+    collType.setUpdatedAt(jsTime());
+    collType.setKeyPattern(BSON("x" << 1));
+    collType.setUnique(false);
+    collType.setDropped(false);
+
+    OperationContextNoop txn;
+    ChunkManager manager(&txn, collType);
+    auto future = launchAsync([&] { manager.loadExistingRanges(operationContext(), nullptr); });
+    expectFindOnConfigSendBSONObjVector(chunks);
+    expectFindOnConfigSendBSONObjVector(shards);
+    future.timed_get(kFutureTimeout);
+
+    // Batched targeting returns the same chunks as targeting each key separately
+    vector<BSONObj> shardKeys{BSON("x" << 55),
+                              BSON("x" << MINKEY),
+                              BSON("x" << -1),
+                              BSON("x" << 0),
+                              BSON("x" << 90),
+                              BSON("x" << 10),
+                              BSON("x" << 1000)};
+
+    vector<std::shared_ptr<Chunk>> batchedChunks;
+    manager.findIntersectingChunksWithSimpleCollation(
+        operationContext(), shardKeys, &batchedChunks);
+    ASSERT_EQ(shardKeys.size(), batchedChunks.size());
+
+    for (size_t i = 0; i < shardKeys.size(); i++) {
+        auto chunk = manager.findIntersectingChunkWithSimpleCollation(operationContext(),
+                                                                      shardKeys[i]);
+        ASSERT(batchedChunks[i]);
+        ASSERT(batchedChunks[i]->containsKey(shardKeys[i]));
+        ASSERT_BSONOBJ_EQ(chunk->getMin(), batchedChunks[i]->getMin());
+    }
+
+    // An $in which only matches chunks on one shard targets only that shard
+    set<ShardId> shardIds;
+    manager.getShardIdsForQuery(
+        operationContext(), fromjson("{x: {$in: [5, 25, 45]}}"), BSONObj(), &shardIds);
+    ASSERT_EQ(1U, shardIds.size());
+    ASSERT_EQ(otherShardId, *shardIds.begin());
+
+    shardIds.clear();
+    manager.getShardIdsForQuery(
+        operationContext(), fromjson("{x: {$in: [-5, 15]}}"), BSONObj(), &shardIds);
+    ASSERT_EQ(1U, shardIds.size());
+    ASSERT_EQ(_shardId, *shardIds.begin());
+
+    // Point and range predicates are combined
+    shardIds.clear();
+    manager.getShardIdsForQuery(operationContext(),
+                                fromjson("{$or: [{x: {$in: [-5, 15]}}, {x: {$gt: 40, $lt: 45}}]}"),
+                                BSONObj(),
+                                &shardIds);
+    ASSERT_EQ(2U, shardIds.size());
+}
+
 }  // namespace
 }  // namespace mongo
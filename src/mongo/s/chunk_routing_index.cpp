@@ -0,0 +1,205 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/s/chunk_routing_index.h"
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+
+#include "mongo/bson/ordering.h"
+#include "mongo/db/storage/key_string.h"
+#include "mongo/s/chunk.h"
+
+namespace mongo {
+namespace {
+
+// Shard key fields are always compared in ascending order
+const Ordering kAllAscending = Ordering::make(BSONObj());
+
+const KeyString::Version kKeyStringVersion = KeyString::Version::V1;
+
+}  // namespace
+
+ChunkRoutingIndex::ChunkRoutingIndex(const BSONObjIndexedMap<std::shared_ptr<Chunk>>& chunkMap) {
+    _offsets.reserve(chunkMap.size() + 1);
+    _chunks.reserve(chunkMap.size());
+
+    KeyString ks(kKeyStringVersion);
+    for (const auto& chunkMapEntry : chunkMap) {
+        ks.resetToKey(chunkMapEntry.first, kAllAscending);
+
+        _offsets.push_back(_bounds.size());
+        _bounds.insert(_bounds.end(), ks.getBuffer(), ks.getBuffer() + ks.getSize());
+        _chunks.push_back(chunkMapEntry.second);
+    }
+
+    _offsets.push_back(_bounds.size());
+}
+
+ChunkRoutingIndex::ChunkRoutingIndex(const BSONObjIndexedMap<std::shared_ptr<Chunk>>& chunkMap,
+                                     const ChunkRoutingIndex& previous) {
+    _offsets.reserve(chunkMap.size() + 1);
+    _chunks.reserve(chunkMap.size());
+    _bounds.reserve(previous._bounds.size());
+
+    // Both the chunk map and the previous index are sorted by max bound and the chunks which were
+    // not replaced are the same objects in both, so a single merge pass finds them by identity.
+    // The bounds only need to be compared where the two sequences diverge.
+    KeyString ks(kKeyStringVersion);
+    size_t prevPos = 0;
+    for (const auto& chunkMapEntry : chunkMap) {
+        const Chunk* chunk = chunkMapEntry.second.get();
+
+        // Skip the previous chunks which were removed or replaced
+        while (prevPos < previous._chunks.size() && previous._chunks[prevPos].get() != chunk &&
+               previous._chunks[prevPos]->getMax().woCompare(chunkMapEntry.first) <= 0) {
+            prevPos++;
+        }
+
+        if (prevPos < previous._chunks.size() && previous._chunks[prevPos].get() == chunk) {
+            _appendFrom(previous, prevPos++);
+            continue;
+        }
+
+        ks.resetToKey(chunkMapEntry.first, kAllAscending);
+
+        _offsets.push_back(_bounds.size());
+        _bounds.insert(_bounds.end(), ks.getBuffer(), ks.getBuffer() + ks.getSize());
+        _chunks.push_back(chunkMapEntry.second);
+    }
+
+    _offsets.push_back(_bounds.size());
+}
+
+std::shared_ptr<Chunk> ChunkRoutingIndex::findChunk(const BSONObj& shardKey) const {
+    const KeyString ks(kKeyStringVersion, shardKey, kAllAscending);
+
+    const size_t pos = _upperBound(ks.getBuffer(), ks.getSize(), 0, _chunks.size());
+    if (pos == _chunks.size()) {
+        return nullptr;
+    }
+
+    return _chunks[pos];
+}
+
+void ChunkRoutingIndex::findChunks(const std::vector<BSONObj>& shardKeys,
+                                   std::vector<std::shared_ptr<Chunk>>* chunks) const {
+    chunks->assign(shardKeys.size(), nullptr);
+
+    // Encode all the keys into one buffer
+    std::vector<char> keys;
+    std::vector<uint32_t> keyOffsets;
+    keyOffsets.reserve(shardKeys.size() + 1);
+
+    KeyString ks(kKeyStringVersion);
+    for (const auto& shardKey : shardKeys) {
+        ks.resetToKey(shardKey, kAllAscending);
+
+        keyOffsets.push_back(keys.size());
+        keys.insert(keys.end(), ks.getBuffer(), ks.getBuffer() + ks.getSize());
+    }
+
+    keyOffsets.push_back(keys.size());
+
+    const auto compareKeys = [&](size_t lhs, size_t rhs) {
+        const size_t lhsSize = keyOffsets[lhs + 1] - keyOffsets[lhs];
+        const size_t rhsSize = keyOffsets[rhs + 1] - keyOffsets[rhs];
+        const int result = memcmp(keys.data() + keyOffsets[lhs],
+                                  keys.data() + keyOffsets[rhs],
+                                  std::min(lhsSize, rhsSize));
+        return result < 0 || (result == 0 && lhsSize < rhsSize);
+    };
+
+    // Visit the keys in increasing order
+    std::vector<size_t> order(shardKeys.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), compareKeys);
+
+    size_t pos = 0;
+    for (size_t keyIdx : order) {
+        const char* key = keys.data() + keyOffsets[keyIdx];
+        const size_t keySize = keyOffsets[keyIdx + 1] - keyOffsets[keyIdx];
+
+        // The chunk for this key is at or after the one for the previous key. Gallop forward from
+        // there so that runs of keys falling into the same or nearby chunks cost O(1) comparisons.
+        size_t step = 1;
+        size_t hi = pos;
+        while (hi < _chunks.size() && _compareToBound(key, keySize, hi) >= 0) {
+            pos = hi + 1;
+            hi += step;
+            step *= 2;
+        }
+
+        pos = _upperBound(key, keySize, pos, std::min(hi, _chunks.size()));
+        if (pos == _chunks.size()) {
+            // All the remaining keys are past the last bound, so they have no chunk
+            break;
+        }
+
+        (*chunks)[keyIdx] = _chunks[pos];
+    }
+}
+
+void ChunkRoutingIndex::_appendFrom(const ChunkRoutingIndex& other, size_t pos) {
+    const char* bound = other._bounds.data() + other._offsets[pos];
+
+    _offsets.push_back(_bounds.size());
+    _bounds.insert(_bounds.end(), bound, other._bounds.data() + other._offsets[pos + 1]);
+    _chunks.push_back(other._chunks[pos]);
+}
+
+size_t ChunkRoutingIndex::_upperBound(const char* key,
+                                      size_t keySize,
+                                      size_t begin,
+                                      size_t end) const {
+    while (begin < end) {
+        const size_t mid = begin + (end - begin) / 2;
+        if (_compareToBound(key, keySize, mid) >= 0) {
+            begin = mid + 1;
+        } else {
+            end = mid;
+        }
+    }
+
+    return begin;
+}
+
+int ChunkRoutingIndex::_compareToBound(const char* key, size_t keySize, size_t pos) const {
+    const size_t boundSize = _offsets[pos + 1] - _offsets[pos];
+    const int result = memcmp(key, _bounds.data() + _offsets[pos], std::min(keySize, boundSize));
+    if (result != 0) {
+        return result;
+    }
+
+    return keySize < boundSize ? -1 : (keySize > boundSize ? 1 : 0);
+}
+
+}  // namespace mongo
@@ -0,0 +1,117 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/bsonobj_comparator_interface.h"
+
+namespace mongo {
+
+class Chunk;
+
+/**
+ * Read-only routing index over the chunks of a collection. Stores the max bound of each chunk as a
+ * pre-encoded KeyString in a single contiguous buffer, sorted in chunk order, so that targeting a
+ * shard key is a binary search with memcmp over densely packed keys instead of a std::map walk
+ * with BSONObj::woCompare at every node.
+ *
+ * Lookups have the same semantics as ChunkMap::upper_bound, that is, they return the chunk with the
+ * smallest max bound which is strictly greater than the shard key.
+ */
+class ChunkRoutingIndex {
+public:
+    ChunkRoutingIndex() = default;
+
+    /**
+     * Builds the index from a map of chunks, indexed by their max bound.
+     */
+    explicit ChunkRoutingIndex(const BSONObjIndexedMap<std::shared_ptr<Chunk>>& chunkMap);
+
+    /**
+     * Builds the index for 'chunkMap', which was derived from the chunk map of 'previous' by
+     * replacing some of its chunks. The encoded bounds of the chunks which are shared with
+     * 'previous' are copied over as they are and only the replaced chunks are encoded again.
+     */
+    ChunkRoutingIndex(const BSONObjIndexedMap<std::shared_ptr<Chunk>>& chunkMap,
+                      const ChunkRoutingIndex& previous);
+
+    bool empty() const {
+        return _chunks.empty();
+    }
+
+    size_t size() const {
+        return _chunks.size();
+    }
+
+    /**
+     * Returns the chunk which contains 'shardKey', or nullptr if the key is past the last chunk's
+     * max bound.
+     */
+    std::shared_ptr<Chunk> findChunk(const BSONObj& shardKey) const;
+
+    /**
+     * Batched variant of findChunk. Fills 'chunks' with one entry for each of 'shardKeys', in the
+     * same order. The keys are encoded and sorted first, so that the chunk boundaries are traversed
+     * in a single forward pass instead of one binary search from the root per key.
+     */
+    void findChunks(const std::vector<BSONObj>& shardKeys,
+                    std::vector<std::shared_ptr<Chunk>>* chunks) const;
+
+private:
+    /**
+     * Appends the bound at position 'pos' of 'other' along with its chunk.
+     */
+    void _appendFrom(const ChunkRoutingIndex& other, size_t pos);
+
+    /**
+     * Returns the position of the first max bound in [begin, end) which is strictly greater than
+     * the encoded key.
+     */
+    size_t _upperBound(const char* key, size_t keySize, size_t begin, size_t end) const;
+
+    /**
+     * Compares the encoded key against the max bound at position 'pos'.
+     */
+    int _compareToBound(const char* key, size_t keySize, size_t pos) const;
+
+    // Concatenated KeyString encodings of the max bound of each chunk
+    std::vector<char> _bounds;
+
+    // Offset of each chunk's max bound in _bounds, with one extra entry for the end of the buffer
+    std::vector<uint32_t> _offsets;
+
+    // The chunks, in the same order as their bounds
+    std::vector<std::shared_ptr<Chunk>> _chunks;
+};
+
+}  // namespace mongo
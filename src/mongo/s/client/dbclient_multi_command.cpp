@@ -148,7 +148,10 @@ void DBClientMultiCommand::sendAll() {
          it != _pendingCommands.end();
          ++it) {
         PendingCommand* command = *it;
-        dassert(!command->conn);
+
+        // Skip commands which were already sent, or failed to send, by a previous sendAll
+        if (command->conn || !command->status.isOK())
+            continue;
 
         try {
             dassert(command->endpoint.type() == ConnectionString::MASTER ||
@@ -59,9 +59,9 @@ public:
                             const BSONObj& request) = 0;
 
     /**
-     * Sends all the commands in this dispatch to their endpoints, in undefined order and
-     * without waiting for responses.  May block on full send queue (though this should be
-     * rare).
+     * Sends all the commands added since the last sendAll to their endpoints, in undefined order
+     * and without waiting for responses.  May block on full send queue (though this should be
+     * rare).  May be called while responses to previously sent commands are still pending.
      *
      * Any error which occurs during sendAll will be reported on recvAny, *does not throw.*
      */
@@ -74,7 +74,8 @@ public:
 
     /**
      * Blocks until a command response has come back.  Any outstanding command response may be
-     * returned with associated endpoint.
+     * returned with associated endpoint, but responses from the same endpoint are always
+     * returned in the order in which their commands were sent.
      *
      * Returns !OK on send/recv/parse failure, otherwise command-level errors are returned in
      * the response object itself.
@@ -305,6 +305,13 @@ void ClusterExplain::buildExecStats(const vector<Strategy::CommandResult>& shard
             singleShardBob.append(execStats["errorCode"]);
         }
 
+        // Time between sending the explain to the shard and receiving its response. Shards are
+        // contacted concurrently, so the slowest of them determines the overall latency.
+        if (shardResults[i].elapsed) {
+            singleShardBob.append("roundTripTimeMillis",
+                                  durationCount<Milliseconds>(*shardResults[i].elapsed));
+        }
+
         appendIfRoom(&singleShardBob, execStages, "executionStages");
 
         singleShardBob.doneFast();
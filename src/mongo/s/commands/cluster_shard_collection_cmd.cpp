@@ -50,21 +50,21 @@
 #include "mongo/db/operation_context.h"
 #include "mongo/db/query/collation/collator_factory_interface.h"
 #include "mongo/db/write_concern_options.h"
-#include "mongo/s/balancer_configuration.h"
 #include "mongo/s/catalog/catalog_cache.h"
 #include "mongo/s/catalog/sharding_catalog_client.h"
 #include "mongo/s/chunk_manager.h"
 #include "mongo/s/client/shard_registry.h"
 #include "mongo/s/commands/cluster_write.h"
 #include "mongo/s/config.h"
-#include "mongo/s/config_server_client.h"
 #include "mongo/s/grid.h"
-#include "mongo/s/migration_secondary_throttle_options.h"
-#include "mongo/s/shard_util.h"
 #include "mongo/s/sharding_raii.h"
+#include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
 
 namespace mongo {
+
+MONGO_FP_DECLARE(hangBeforeCreatingPreSplitChunks);
+
 namespace {
 
 /**
@@ -139,6 +139,186 @@ Status clusterCreateIndex(OperationContext* txn,
     return response.toStatus();
 }
 
+/**
+ * Runs 'cmdObj' against the primary of the given shard and returns the command status.
+ */
+Status runCommandOnShard(OperationContext* txn,
+                         const ShardId& shardId,
+                         const std::string& dbName,
+                         const BSONObj& cmdObj) {
+    auto shardStatus = Grid::get(txn)->shardRegistry()->getShard(txn, shardId);
+    if (!shardStatus.isOK()) {
+        return shardStatus.getStatus();
+    }
+
+    auto response = shardStatus.getValue()->runCommandWithFixedRetryAttempts(
+        txn,
+        ReadPreferenceSetting{ReadPreference::PrimaryOnly},
+        dbName,
+        cmdObj,
+        Shard::RetryPolicy::kIdempotent);
+    if (!response.isOK()) {
+        return response.getStatus();
+    }
+
+    return std::move(response.getValue().commandStatus);
+}
+
+/**
+ * Creates the empty collection 'nss', with the same options and indexes it has on the database
+ * primary shard, on each of 'shardIds' other than the primary. This prepares the shards which
+ * receive initial chunks to own them from the moment the collection is sharded, without any chunk
+ * migrations.
+ *
+ * Fails if the collection already contains documents on one of the shards, since they would
+ * become visible as soon as the shard owned a chunk.
+ */
+Status createEmptyCollectionOnShards(OperationContext* txn,
+                                     const NamespaceString& nss,
+                                     const ShardId& primaryShardId,
+                                     const std::set<ShardId>& shardIds,
+                                     const BSONObj& collectionOptions,
+                                     const std::list<BSONObj>& indexSpecs) {
+    BSONObjBuilder createCmd;
+    createCmd.append("create", nss.coll());
+    createCmd.appendElements(collectionOptions);
+    const BSONObj createCmdObj = createCmd.obj();
+
+    BSONObjBuilder createIndexesCmd;
+    createIndexesCmd.append("createIndexes", nss.coll());
+    {
+        BSONArrayBuilder indexesArr(createIndexesCmd.subarrayStart("indexes"));
+        for (const auto& spec : indexSpecs) {
+            // The _id index is created along with the collection.
+            if (spec["name"].str() != "_id_") {
+                indexesArr.append(spec);
+            }
+        }
+    }
+    const BSONObj createIndexesCmdObj = createIndexesCmd.obj();
+
+    for (const auto& shardId : shardIds) {
+        if (shardId == primaryShardId) {
+            continue;
+        }
+
+        Status status = runCommandOnShard(txn, shardId, nss.db().toString(), createCmdObj);
+        if (!status.isOK() && status != ErrorCodes::NamespaceExists) {
+            return {status.code(),
+                    str::stream() << "failed to create collection " << nss.ns() << " on shard "
+                                  << shardId
+                                  << causedBy(status)};
+        }
+
+        if (status == ErrorCodes::NamespaceExists) {
+            // A collection left over on this shard is only safe to use if it is empty.
+            auto shardStatus = Grid::get(txn)->shardRegistry()->getShard(txn, shardId);
+            if (!shardStatus.isOK()) {
+                return shardStatus.getStatus();
+            }
+
+            auto countResponse = shardStatus.getValue()->runCommandWithFixedRetryAttempts(
+                txn,
+                ReadPreferenceSetting{ReadPreference::PrimaryOnly},
+                nss.db().toString(),
+                BSON("count" << nss.coll()),
+                Shard::RetryPolicy::kIdempotent);
+            if (!countResponse.isOK()) {
+                return countResponse.getStatus();
+            }
+            if (!countResponse.getValue().commandStatus.isOK()) {
+                return countResponse.getValue().commandStatus;
+            }
+
+            long long numDocs = 0;
+            Status countStatus =
+                bsonExtractIntegerField(countResponse.getValue().response, "n", &numDocs);
+            if (!countStatus.isOK()) {
+                return countStatus;
+            }
+
+            if (numDocs != 0) {
+                return {ErrorCodes::IllegalOperation,
+                        str::stream() << "cannot pre-distribute chunks of " << nss.ns()
+                                      << " because the collection already contains "
+                                      << numDocs
+                                      << " documents on shard "
+                                      << shardId};
+            }
+        }
+
+        if (createIndexesCmdObj["indexes"].Obj().isEmpty()) {
+            continue;
+        }
+
+        status = runCommandOnShard(txn, shardId, nss.db().toString(), createIndexesCmdObj);
+        if (!status.isOK()) {
+            return {status.code(),
+                    str::stream() << "failed to create indexes for " << nss.ns() << " on shard "
+                                  << shardId
+                                  << causedBy(status)};
+        }
+    }
+
+    return Status::OK();
+}
+
+/**
+ * Has the database primary shard create the initial chunks of 'nss', split at 'splitPoints' and
+ * assigned round-robin to 'initShardIds', while it keeps routers from writing to the collection.
+ * Sets 'chunksDistributed' to false if the primary found the collection no longer empty and
+ * created all the chunks itself.
+ */
+Status shardCollectionOnPrimary(OperationContext* txn,
+                                const NamespaceString& nss,
+                                const ShardId& primaryShardId,
+                                const ShardKeyPattern& shardKeyPattern,
+                                const BSONObj& defaultCollation,
+                                bool unique,
+                                const std::vector<BSONObj>& splitPoints,
+                                const std::set<ShardId>& initShardIds,
+                                bool* chunksDistributed) {
+    BSONObjBuilder cmdBuilder;
+    cmdBuilder.append("_shardsvrShardCollection", nss.ns());
+    cmdBuilder.append("key", shardKeyPattern.toBSON());
+    cmdBuilder.appendBool("unique", unique);
+    cmdBuilder.append("collation", defaultCollation);
+    {
+        BSONArrayBuilder splitPointsArr(cmdBuilder.subarrayStart("initialSplitPoints"));
+        for (const auto& splitPoint : splitPoints) {
+            splitPointsArr.append(splitPoint);
+        }
+    }
+    {
+        BSONArrayBuilder shardIdsArr(cmdBuilder.subarrayStart("initShardIds"));
+        for (const auto& shardId : initShardIds) {
+            shardIdsArr.append(shardId.toString());
+        }
+    }
+
+    auto shardStatus = Grid::get(txn)->shardRegistry()->getShard(txn, primaryShardId);
+    if (!shardStatus.isOK()) {
+        return shardStatus.getStatus();
+    }
+
+    // Not retried, since a retry would find the collection sharded by the first attempt
+    auto response = shardStatus.getValue()->runCommandWithFixedRetryAttempts(
+        txn,
+        ReadPreferenceSetting{ReadPreference::PrimaryOnly},
+        "admin",
+        cmdBuilder.obj(),
+        Shard::RetryPolicy::kNoRetry);
+    if (!response.isOK()) {
+        return response.getStatus();
+    }
+    if (!response.getValue().commandStatus.isOK()) {
+        return response.getValue().commandStatus;
+    }
+
+    *chunksDistributed = response.getValue().response["chunksDistributed"].trueValue();
+    return Status::OK();
+}
+
 class ShardCollectionCmd : public Command {
 public:
     ShardCollectionCmd() : Command("shardCollection", false, "shardcollection") {}
@@ -158,7 +338,10 @@ public:
     void help(std::stringstream& help) const override {
         help << "Shard a collection. Requires key. Optional unique."
              << " Sharding must already be enabled for the database.\n"
-             << "   { enablesharding : \"<dbname>\" }\n";
+             << "   { enablesharding : \"<dbname>\" }\n"
+             << " An empty collection may be pre-split with numInitialChunks (hashed shard keys)"
+             << " or initialSplitPoints (other shard keys), in which case its chunks are"
+             << " distributed across all the shards when it is sharded.\n";
     }
 
     Status checkAuthForCommand(Client* client,
@@ -278,6 +461,57 @@ public:
             return false;
         }
 
+        // Explicit split points with which to pre-split an empty collection with a ranged shard
+        // key. Hashed shard keys are pre-split evenly using numInitialChunks instead.
+        std::vector<BSONObj> initialSplitPoints;
+        if (cmdObj.hasField("initialSplitPoints")) {
+            if (isHashedShardKey) {
+                return appendCommandStatus(result,
+                                           {ErrorCodes::InvalidOptions,
+                                            "initialSplitPoints is not supported with a hashed "
+                                            "shard key, use numInitialChunks instead."});
+            }
+
+            if (cmdObj["initialSplitPoints"].type() != BSONType::Array) {
+                return appendCommandStatus(
+                    result,
+                    {ErrorCodes::TypeMismatch, "initialSplitPoints must be an array"});
+            }
+
+            const BSONObj globalMin = proposedKeyPattern.getKeyPattern().globalMin();
+            const BSONObj globalMax = proposedKeyPattern.getKeyPattern().globalMax();
+
+            for (const auto& splitPointElem : cmdObj["initialSplitPoints"].Obj()) {
+                if (splitPointElem.type() != BSONType::Object ||
+                    !proposedKeyPattern.isShardKey(splitPointElem.Obj())) {
+                    return appendCommandStatus(
+                        result,
+                        {ErrorCodes::InvalidOptions,
+                         str::stream() << "initial split point " << splitPointElem
+                                       << " is not a valid shard key for "
+                                       << proposedKey});
+                }
+
+                BSONObj splitPoint = proposedKeyPattern.normalizeShardKey(splitPointElem.Obj());
+                if (SimpleBSONObjComparator::kInstance.evaluate(splitPoint == globalMin) ||
+                    SimpleBSONObjComparator::kInstance.evaluate(splitPoint == globalMax)) {
+                    return appendCommandStatus(
+                        result,
+                        {ErrorCodes::InvalidOptions,
+                         str::stream() << "initial split point " << splitPoint
+                                       << " cannot be the minimum or maximum of the key space"});
+                }
+
+                initialSplitPoints.push_back(splitPoint.getOwned());
+            }
+
+            if (static_cast<int>(initialSplitPoints.size()) >= maxNumInitialChunksTotal) {
+                errmsg = str::stream() << "initialSplitPoints cannot create more than "
+                                       << maxNumInitialChunksTotal << " chunks";
+                return false;
+            }
+        }
+
         // The rest of the checks require a connection to the primary db
         const ConnectionString shardConnString = [&]() {
             const auto shard =
@@ -299,6 +533,7 @@ public:
         }
 
         BSONObj defaultCollation;
+        BSONObj collectionOptions;
 
         if (!res.isEmpty()) {
             // Check that namespace is not a view.
@@ -318,9 +553,8 @@ public:
                 }
             }
 
-            BSONObj collectionOptions;
             if (res["options"].type() == BSONType::Object) {
-                collectionOptions = res["options"].Obj();
+                collectionOptions = res["options"].Obj().getOwned();
             }
 
             // Check that collection is not capped.
@@ -497,7 +731,8 @@ public:
         } else {
             // 5. If no useful index exists, and collection empty, create one on proposedKey.
             //    Only need to call ensureIndex on primary shard, since indexes get copied to
-            //    receiving shard whenever a migrate occurs.
+            //    receiving shard whenever a migrate occurs, or when the initial chunks are
+            //    distributed below.
             //    If the collection has a default collation, explicitly send the simple
             //    collation as part of the createIndex request.
             BSONObj collationArg =
@@ -514,21 +749,26 @@ public:
 
         bool isEmpty = (conn->count(nss.ns()) == 0);
 
+        // The indexes to create on the other shards, if the chunks are distributed at creation
+        const std::list<BSONObj> indexSpecs =
+            isEmpty ? conn->getIndexSpecs(nss.ns()) : std::list<BSONObj>();
+
         conn.done();
 
         // Pre-splitting:
-        // For new collections which use hashed shard keys, we can can pre-split the
-        // range of possible hashes into a large number of chunks, and distribute them
-        // evenly at creation time. Until we design a better initialization scheme, the
-        // safest way to pre-split is to
-        // 1. make one big chunk for each shard
-        // 2. move them one at a time
-        // 3. split the big chunks to achieve the desired total number of initial chunks
-
-        std::vector<BSONObj> initSplits;  // there will be at most numShards-1 of these
-        std::vector<BSONObj> allSplits;   // all of the initial desired split points
-
-        // only pre-split when using a hashed shard key and collection is still empty
+        // For new, empty collections we can pre-split the key space into a large number of chunks
+        // and distribute them evenly across the shards at creation time, so that inserts go to all
+        // the shards from the start. For hashed shard keys the range of possible hashes is split
+        // evenly into numInitialChunks chunks; for other shard keys the split points may be given
+        // in initialSplitPoints. The shards which will own chunks get the collection and its
+        // indexes first, and the chunks are then created directly on their owning shards, in
+        // round-robin order, as part of sharding the collection. No chunk migrations are needed.
+        // If documents reach the primary shard before it stops accepting writes for the
+        // collection, all the chunks are created on the primary instead.
+
+        std::vector<BSONObj> allSplits;  // all of the initial desired split points
+
+        // only pre-split when the collection is still empty
         if (isHashedShardKey && isEmpty) {
             if (numChunks <= 0) {
                 // default number of initial chunks
@@ -554,21 +794,9 @@ public:
                 allSplits.push_back(BSON(proposedKey.firstElementFieldName() << -current));
                 current += intervalSize;
             }
-
-            sort(allSplits.begin(),
-                 allSplits.end(),
-                 SimpleBSONObjComparator::kInstance.makeLessThan());
-
-            // 1. the initial splits define the "big chunks" that we will subdivide later
-            int lastIndex = -1;
-            for (int i = 1; i < numShards; i++) {
-                if (lastIndex < (i * numChunks) / numShards - 1) {
-                    lastIndex = (i * numChunks) / numShards - 1;
-                    initSplits.push_back(allSplits[lastIndex]);
-                }
-            }
+        } else if (!initialSplitPoints.empty() && isEmpty) {
+            allSplits = std::move(initialSplitPoints);
         } else if (numChunks > 0) {
-            conn.done();
             return appendCommandStatus(
                 result,
                 {ErrorCodes::InvalidOptions,
@@ -576,125 +804,92 @@ public:
                                                        "when the shard key is not hashed."
                                                      : "numInitialChunks is not supported "
                                                        "when the collection is not empty.")});
+        } else if (!initialSplitPoints.empty()) {
+            return appendCommandStatus(result,
+                                       {ErrorCodes::InvalidOptions,
+                                        "initialSplitPoints is not supported when the "
+                                        "collection is not empty."});
         }
 
-        LOG(0) << "CMD: shardcollection: " << cmdObj;
+        // The shards which receive initial chunks. The chunks are assigned to them round-robin in
+        // shard id order, so if there are fewer chunks than shards only the first shards get one.
+        std::set<ShardId> initShardIds;
+        if (!allSplits.empty()) {
+            auto uniqueSplits = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+            uniqueSplits.insert(allSplits.begin(), allSplits.end());
+            const size_t numInitialChunks = uniqueSplits.size() + 1;
 
-        audit::logShardCollection(Client::getCurrent(), nss.ns(), proposedKey, careAboutUnique);
-
-        uassertStatusOK(catalogClient->shardCollection(txn,
-                                                       nss.ns(),
-                                                       proposedShardKey,
-                                                       defaultCollation,
-                                                       careAboutUnique,
-                                                       initSplits,
-                                                       std::set<ShardId>{}));
-
-        // Make sure the cached metadata for the collection knows that we are now sharded
-        config->getChunkManager(txn, nss.ns(), true /* reload */);
-
-        result << "collectionsharded" << nss.ns();
-
-        // Only initially move chunks when using a hashed shard key
-        if (isHashedShardKey && isEmpty) {
-            // Reload the new config info.  If we created more than one initial chunk, then
-            // we need to move them around to balance.
-            auto chunkManager = config->getChunkManager(txn, nss.ns(), true);
-            ChunkMap chunkMap = chunkManager->getChunkMap();
-
-            // 2. Move and commit each "big chunk" to a different shard.
-            int i = 0;
-            for (ChunkMap::const_iterator c = chunkMap.begin(); c != chunkMap.end(); ++c, ++i) {
-                const ShardId& shardId = shardIds[i % numShards];
-                const auto toStatus = shardRegistry->getShard(txn, shardId);
-                if (!toStatus.isOK()) {
-                    continue;
-                }
-                const auto to = toStatus.getValue();
-
-                auto chunk = c->second;
-
-                // Can't move chunk to shard it's already on
-                if (to->getId() == chunk->getShardId()) {
-                    continue;
-                }
-
-                ChunkType chunkType;
-                chunkType.setNS(nss.ns());
-                chunkType.setMin(chunk->getMin());
-                chunkType.setMax(chunk->getMax());
-                chunkType.setShard(chunk->getShardId());
-                chunkType.setVersion(chunkManager->getVersion());
-
-                Status moveStatus = configsvr_client::moveChunk(
-                    txn,
-                    chunkType,
-                    to->getId(),
-                    Grid::get(txn)->getBalancerConfiguration()->getMaxChunkSizeBytes(),
-                    MigrationSecondaryThrottleOptions::create(
-                        MigrationSecondaryThrottleOptions::kOff),
-                    true);
-                if (!moveStatus.isOK()) {
-                    warning() << "couldn't move chunk " << redact(chunk->toString()) << " to shard "
-                              << *to << " while sharding collection " << nss.ns()
-                              << causedBy(redact(moveStatus));
+            for (const auto& shardId : std::set<ShardId>(shardIds.begin(), shardIds.end())) {
+                if (initShardIds.size() == numInitialChunks) {
+                    break;
                 }
+                initShardIds.insert(shardId);
             }
 
-            if (allSplits.empty()) {
-                return true;
+            Status status = createEmptyCollectionOnShards(
+                txn, nss, config->getPrimaryId(), initShardIds, collectionOptions, indexSpecs);
+            if (!status.isOK()) {
+                return appendCommandStatus(result, status);
             }
 
-            // Reload the config info, after all the migrations
-            chunkManager = config->getChunkManager(txn, nss.ns(), true);
-
-            // 3. Subdivide the big chunks by splitting at each of the points in "allSplits"
-            //    that we haven't already split by.
-            auto currentChunk =
-                chunkManager->findIntersectingChunkWithSimpleCollation(txn, allSplits[0]);
-
-            std::vector<BSONObj> subSplits;
-            for (unsigned i = 0; i <= allSplits.size(); i++) {
-                if (i == allSplits.size() || !currentChunk->containsKey(allSplits[i])) {
-                    if (!subSplits.empty()) {
-                        auto splitStatus = shardutil::splitChunkAtMultiplePoints(
-                            txn,
-                            currentChunk->getShardId(),
-                            nss,
-                            chunkManager->getShardKeyPattern(),
-                            chunkManager->getVersion(),
-                            ChunkRange(currentChunk->getMin(), currentChunk->getMax()),
-                            subSplits);
-                        if (!splitStatus.isOK()) {
-                            warning() << "couldn't split chunk " << redact(currentChunk->toString())
-                                      << " while sharding collection " << nss.ns()
-                                      << causedBy(redact(splitStatus.getStatus()));
-                        }
-
-                        subSplits.clear();
-                    }
+            if (MONGO_FAIL_POINT(hangBeforeCreatingPreSplitChunks)) {
+                // This log output is used in js tests so please leave it.
+                log() << "shardCollection - hangBeforeCreatingPreSplitChunks fail point enabled. "
+                         "Blocking until fail point is disabled.";
+                MONGO_FAIL_POINT_PAUSE_WHILE_SET(hangBeforeCreatingPreSplitChunks);
+            }
+        }
 
-                    if (i < allSplits.size()) {
-                        currentChunk = chunkManager->findIntersectingChunkWithSimpleCollation(
-                            txn, allSplits[i]);
-                    }
-                } else {
-                    BSONObj splitPoint(allSplits[i]);
+        LOG(0) << "CMD: shardcollection: " << cmdObj;
 
-                    // Do not split on the boundaries
-                    if (currentChunk->getMin().woCompare(splitPoint) == 0) {
-                        continue;
-                    }
+        audit::logShardCollection(Client::getCurrent(), nss.ns(), proposedKey, careAboutUnique);
 
-                    subSplits.push_back(splitPoint);
-                }
+        if (allSplits.empty()) {
+            uassertStatusOK(catalogClient->shardCollection(txn,
+                                                           nss.ns(),
+                                                           proposedShardKey,
+                                                           defaultCollation,
+                                                           careAboutUnique,
+                                                           allSplits,
+                                                           initShardIds));
+        } else {
+            // Chunks may only be created on shards other than the primary while the primary keeps
+            // routers that consider the collection unsharded from writing to it, so the primary
+            // creates them.
+            bool chunksDistributed = false;
+            Status status = shardCollectionOnPrimary(txn,
+                                                     nss,
+                                                     config->getPrimaryId(),
+                                                     proposedShardKey,
+                                                     defaultCollation,
+                                                     careAboutUnique,
+                                                     allSplits,
+                                                     initShardIds,
+                                                     &chunksDistributed);
+            if (status == ErrorCodes::CommandNotFound) {
+                // A primary shard of an older version cannot do this, so all the chunks are
+                // created on it and left to the balancer
+                status = catalogClient->shardCollection(txn,
+                                                        nss.ns(),
+                                                        proposedShardKey,
+                                                        defaultCollation,
+                                                        careAboutUnique,
+                                                        allSplits,
+                                                        std::set<ShardId>{});
             }
+            uassertStatusOK(status);
 
-            // Proactively refresh the chunk manager. Not really necessary, but this way it's
-            // immediately up-to-date the next time it's used.
-            config->getChunkManager(txn, nss.ns(), true);
+            if (!chunksDistributed) {
+                log() << "the initial chunks of " << nss.ns() << " were all created on primary "
+                      << "shard " << config->getPrimaryId() << " and are left to the balancer";
+            }
         }
 
+        // Make sure the cached metadata for the collection knows that we are now sharded
+        config->getChunkManager(txn, nss.ns(), true /* reload */);
+
+        result << "collectionsharded" << nss.ns();
+
         return true;
     }
 
@@ -39,6 +39,7 @@
 #include "mongo/bson/util/builder.h"
 #include "mongo/client/dbclientcursor.h"
 #include "mongo/client/parallel.h"
+#include "mongo/client/remote_command_targeter.h"
 #include "mongo/db/audit.h"
 #include "mongo/db/auth/action_type.h"
 #include "mongo/db/auth/authorization_session.h"
@@ -51,6 +52,7 @@
 #include "mongo/db/query/query_request.h"
 #include "mongo/db/stats/counters.h"
 #include "mongo/db/views/resolved_view.h"
+#include "mongo/executor/task_executor_pool.h"
 #include "mongo/rpc/get_status_from_command_result.h"
 #include "mongo/rpc/metadata/server_selection_metadata.h"
 #include "mongo/s/catalog/catalog_cache.h"
@@ -61,12 +63,16 @@
 #include "mongo/s/grid.h"
 #include "mongo/s/query/cluster_cursor_manager.h"
 #include "mongo/s/query/cluster_find.h"
+#include "mongo/s/sharding_raii.h"
 #include "mongo/s/stale_exception.h"
 #include "mongo/s/write_ops/batch_upconvert.h"
 #include "mongo/s/write_ops/batched_command_request.h"
 #include "mongo/s/write_ops/batched_command_response.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/scopeguard.h"
 #include "mongo/util/timer.h"
 
 namespace mongo {
@@ -79,6 +85,10 @@ using std::stringstream;
 
 namespace {
 
+// Maximum number of times to re-target and resend a command, which failed with a stale sharding
+// error
+const int kMaxStaleConfigRetries = 10;
+
 void runAgainstRegistered(OperationContext* txn,
                           const char* ns,
                           BSONObj& jsobj,
@@ -352,25 +362,162 @@ void Strategy::commandOp(OperationContext* txn,
                          const BSONObj& targetingQuery,
                          const BSONObj& targetingCollation,
                          std::vector<CommandResult>* results) {
-    QuerySpec qSpec(db + ".$cmd", command, BSONObj(), 0, 1, options);
+    const NamespaceString nss(versionedNS);
+
+    // The read preference is used for choosing the host from each shard and is sent to it as
+    // metadata, so it should not be forwarded as part of the command
+    const auto readPref = uassertStatusOK(
+        ClusterFind::extractUnwrappedReadPref(command, options & QueryOption_SlaveOk));
+
+    BSONObjBuilder metadataBuilder;
+    rpc::ServerSelectionMetadata metadata(readPref.pref != ReadPreference::PrimaryOnly, readPref);
+    uassertStatusOK(metadata.writeToMetadata(&metadataBuilder));
+    const BSONObj metadataObj = metadataBuilder.obj();
+
+    for (int retries = 1;; ++retries) {
+        auto scopedCMStatus = ScopedChunkManager::get(txn, nss);
+        if (scopedCMStatus == ErrorCodes::NamespaceNotFound) {
+            // The database does not exist, so there are no shards to target
+            return;
+        }
+        uassertStatusOK(scopedCMStatus.getStatus());
+
+        const auto& scopedCM = scopedCMStatus.getValue();
+        const auto chunkManager = scopedCM.cm();
+
+        set<ShardId> shardIds;
+        if (chunkManager) {
+            chunkManager->getShardIdsForQuery(txn, targetingQuery, targetingCollation, &shardIds);
+        } else {
+            shardIds.insert(scopedCM.primary()->getId());
+        }
+
+        std::vector<ShardCommandRequest> requests;
+        for (const ShardId& shardId : shardIds) {
+            const auto shard =
+                uassertStatusOK(Grid::get(txn)->shardRegistry()->getShard(txn, shardId));
+
+            BSONObjBuilder cmdBuilder;
+            for (const auto& elem : command) {
+                if (elem.fieldNameStringData() != QueryRequest::kUnwrappedReadPrefField &&
+                    elem.fieldNameStringData() != ChunkVersion::kShardVersionField) {
+                    cmdBuilder.append(elem);
+                }
+            }
+
+            if (chunkManager) {
+                chunkManager->getVersion(shardId).appendForCommands(&cmdBuilder);
+            } else if (!nss.isOnInternalDb()) {
+                ChunkVersion::UNSHARDED().appendForCommands(&cmdBuilder);
+            }
+
+            requests.emplace_back(shard, cmdBuilder.obj());
+        }
+
+        scatterGather(txn, db, readPref, metadataObj, &requests);
+
+        // Stale sharding errors mean that the routing information which was used for targeting
+        // is not current, so the command needs to be re-targeted and sent again
+        Status staleStatus = Status::OK();
+        for (const auto& request : requests) {
+            auto status = getStatusFromCommandResult(request.response.data);
+            if (ErrorCodes::isStaleShardingError(status.code())) {
+                staleStatus = std::move(status);
+                break;
+            }
+        }
 
-    ParallelSortClusteredCursor cursor(
-        qSpec, CommandInfo(versionedNS, targetingQuery, targetingCollation));
+        if (staleStatus.isOK()) {
+            for (auto& request : requests) {
+                CommandResult result;
+                result.shardTargetId = request.shard->getId();
+                result.target = request.shard->getConnString();
+                result.result = request.response.data.getOwned();
+                result.elapsed = request.response.elapsedMillis;
+                results->push_back(std::move(result));
+            }
+
+            return;
+        }
+
+        LOG(1) << "Received stale sharding error for command " << redact(command)
+               << " on attempt " << retries << " of " << kMaxStaleConfigRetries
+               << causedBy(redact(staleStatus));
+
+        uassert(staleStatus.code(),
+                str::stream() << "Retried " << kMaxStaleConfigRetries
+                              << " times without successfully establishing shard version"
+                              << causedBy(staleStatus),
+                retries < kMaxStaleConfigRetries);
+
+        if (staleStatus == ErrorCodes::StaleEpoch) {
+            Grid::get(txn)->catalogCache()->invalidate(nss.db().toString());
+        } else {
+            scopedCM.db()->getChunkManagerIfExists(txn, nss.ns(), true);
+        }
+    }
+}
+
+void Strategy::scatterGather(OperationContext* txn,
+                             const string& db,
+                             const ReadPreferenceSetting& readPref,
+                             const BSONObj& metadataObj,
+                             std::vector<ShardCommandRequest>* requests) {
+    auto executor = Grid::get(txn)->getExecutorPool()->getArbitraryExecutor();
+
+    // The callbacks count the responses under this mutex, so that waiting for them goes through
+    // the operation context and can be interrupted by killOp or maxTimeMS
+    stdx::mutex mutex;
+    stdx::condition_variable responseReceivedCV;
+    size_t numResponses = 0;
+
+    std::vector<executor::TaskExecutor::CallbackHandle> callbackHandles;
+
+    // Make sure that none of the callbacks can outlive the requests they fill in, regardless of how
+    // this function exits
+    ON_BLOCK_EXIT([&] {
+        for (const auto& cbHandle : callbackHandles) {
+            executor->cancel(cbHandle);
+            executor->wait(cbHandle);
+        }
+    });
+
+    // Send the command to all the shards before waiting for any of the responses, so that the
+    // overall latency is that of the slowest shard and not the sum of the latencies
+    for (auto& request : *requests) {
+        const auto host = uassertStatusOK(
+            request.shard->getTargeter()->findHostWithMaxWait(readPref, Seconds{20}));
+
+        const executor::RemoteCommandRequest remoteRequest(
+            host, db, request.cmdObj, metadataObj, txn);
+
+        auto* const response = &request.response;
+        callbackHandles.push_back(uassertStatusOK(executor->scheduleRemoteCommand(
+            remoteRequest,
+            [&, response](const executor::TaskExecutor::RemoteCommandCallbackArgs& args) {
+                stdx::lock_guard<stdx::mutex> lk(mutex);
+                *response = args.response;
+                ++numResponses;
+                responseReceivedCV.notify_one();
+            })));
+    }
 
-    // Initialize the cursor
-    cursor.init(txn);
+    {
+        stdx::unique_lock<stdx::mutex> lk(mutex);
+        txn->waitForConditionOrInterrupt(
+            responseReceivedCV, lk, [&] { return numResponses == callbackHandles.size(); });
+    }
 
-    set<ShardId> shardIds;
-    cursor.getQueryShardIds(shardIds);
+    // All the callbacks have run, but they may not have returned yet, so wait for them before
+    // the requests go out of scope
+    for (const auto& cbHandle : callbackHandles) {
+        executor->wait(cbHandle);
+    }
 
-    for (const ShardId& shardId : shardIds) {
-        CommandResult result;
-        result.shardTargetId = shardId;
+    callbackHandles.clear();
 
-        result.target = fassertStatusOK(
-            34417, ConnectionString::parse(cursor.getShardCursor(shardId)->originalHost()));
-        result.result = cursor.getShardCursor(shardId)->peekFirst().getOwned();
-        results->push_back(result);
+    for (const auto& request : *requests) {
+        uassertStatusOK(request.response.status);
     }
 }
 
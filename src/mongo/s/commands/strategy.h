@@ -31,8 +31,11 @@
 #include <atomic>
 
 #include "mongo/client/connection_string.h"
+#include "mongo/client/read_preference.h"
 #include "mongo/db/query/explain_common.h"
+#include "mongo/executor/remote_command_response.h"
 #include "mongo/s/client/shard.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
@@ -105,6 +108,9 @@ public:
         ShardId shardTargetId;
         ConnectionString target;
         BSONObj result;
+
+        // Round-trip time of the command to the shard, if known
+        boost::optional<Milliseconds> elapsed;
     };
 
     /**
@@ -114,6 +120,10 @@ public:
      *
      * This version should be used by internal commands when possible.
      *
+     * The command is sent to all the targeted shards concurrently and is retargeted and resent if
+     * any of them reports a stale sharding error. Throws on network errors or if the shard version
+     * could not be established.
+     *
      * TODO: Replace these methods and all other methods of command dispatch with a more general
      * command op framework.
      */
@@ -125,6 +135,31 @@ public:
                           const BSONObj& targetingQuery,
                           const BSONObj& targetingCollation,
                           std::vector<CommandResult>* results);
+
+private:
+    /**
+     * Command to be sent to a single shard as part of a scatter-gather operation, along with the
+     * response which was received for it.
+     */
+    struct ShardCommandRequest {
+        ShardCommandRequest(std::shared_ptr<Shard> inShard, BSONObj inCmdObj)
+            : shard(std::move(inShard)), cmdObj(std::move(inCmdObj)) {}
+
+        std::shared_ptr<Shard> shard;
+        BSONObj cmdObj;
+        executor::RemoteCommandResponse response;
+    };
+
+    /**
+     * Schedules all the specified requests on the task executor at the same time and waits for
+     * all of them to complete, filling in their responses. Throws if any of the shards could not
+     * be targeted or reached, or if the operation is interrupted while waiting.
+     */
+    static void scatterGather(OperationContext* txn,
+                              const std::string& db,
+                              const ReadPreferenceSetting& readPref,
+                              const BSONObj& metadataObj,
+                              std::vector<ShardCommandRequest>* requests);
 };
 
 }  // namespace mongo
@@ -323,7 +323,7 @@ bool DBConfig::_loadIfNeeded(OperationContext* txn, Counter reloadIteration) {
         if (!coll.getDropped()) {
             // Do the blocking collection load
             std::unique_ptr<ChunkManager> manager(stdx::make_unique<ChunkManager>(txn, coll));
-            manager->loadExistingRanges(txn, nullptr);
+            manager->loadExistingRanges(txn, nullptr, _primaryId);
 
             // Collections with no chunks are unsharded, no matter what the collections entry says
             if (manager->numChunks()) {
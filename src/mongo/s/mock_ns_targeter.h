@@ -95,6 +95,23 @@ public:
         return Status::OK();
     }
 
+    void targetInserts(OperationContext* txn,
+                       const std::vector<BSONObj>& docs,
+                       std::vector<ShardEndpoint*>* endpoints,
+                       std::vector<BSONObj>* chunkMins,
+                       std::vector<Status>* statuses) const {
+        for (const BSONObj& doc : docs) {
+            ShardEndpoint* endpoint = NULL;
+            statuses->push_back(targetInsert(txn, doc, &endpoint));
+            endpoints->push_back(endpoint);
+            chunkMins->push_back(BSONObj());
+        }
+    }
+
+    void noteInsertAdded(const BSONObj& chunkMin, int sizeBytes) const {
+        // No-op
+    }
+
     /**
      * Returns the first ShardEndpoint for the query from the mock ranges.  Only can handle
      * queries of the form { field : { $gte : <value>, $lt : <value> } }.
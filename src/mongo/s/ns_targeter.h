@@ -87,6 +87,28 @@ public:
                                 const BSONObj& doc,
                                 ShardEndpoint** endpoint) const = 0;
 
+    /**
+     * Batched variant of targetInsert. Appends one endpoint, one chunk min and one status to
+     * 'endpoints', 'chunkMins' and 'statuses' for each of 'docs', in the same order. The endpoint
+     * is NULL for every document which could not be targeted, and the chunk min is empty for every
+     * document which was not targeted to a chunk. The caller takes ownership of the returned
+     * endpoints.
+     *
+     * Unlike targetInsert, this does not count the documents towards the size of their chunks,
+     * since not all of them are necessarily sent. See noteInsertAdded.
+     */
+    virtual void targetInserts(OperationContext* txn,
+                               const std::vector<BSONObj>& docs,
+                               std::vector<ShardEndpoint*>* endpoints,
+                               std::vector<BSONObj>* chunkMins,
+                               std::vector<Status>* statuses) const = 0;
+
+    /**
+     * Informs the targeter that an insert of 'sizeBytes' bytes, which targetInserts targeted to
+     * the chunk starting at 'chunkMin', has been added to a batch.
+     */
+    virtual void noteInsertAdded(const BSONObj& chunkMin, int sizeBytes) const = 0;
+
     /**
      * Returns a vector of ShardEndpoints for a potentially multi-shard update.
      *
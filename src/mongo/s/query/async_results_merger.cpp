@@ -36,6 +36,7 @@
 #include "mongo/db/query/cursor_response.h"
 #include "mongo/db/query/getmore_request.h"
 #include "mongo/db/query/killcursors_request.h"
+#include "mongo/db/storage/key_string.h"
 #include "mongo/executor/remote_command_request.h"
 #include "mongo/executor/remote_command_response.h"
 #include "mongo/rpc/metadata/server_selection_metadata.h"
@@ -51,13 +52,46 @@ namespace {
 // Maximum number of retries for network and replication notMaster errors (per host).
 const int kMaxNumFailedHostRetryAttempts = 3;
 
+// The largest number of fields in a sort pattern which can be described by an Ordering, and hence
+// the largest sort for which the merge can compare KeyString-encoded sort keys.
+const int kMaxEncodedSortKeyFields = 32;
+
+/**
+ * Returns the number of results the router stages above the ARM can consume, or boost::none if
+ * that number is not bounded.
+ */
+boost::optional<long long> getMaxResultsNeeded(const ClusterClientCursorParams& params) {
+    // Tailable cursors are not closed once they reach the limit.
+    if (!params.limit || params.isTailable) {
+        return boost::none;
+    }
+
+    // The sum of the limit and the skip has already been validated against overflow when the
+    // find command was forwarded to the shards.
+    return *params.limit + params.skip.value_or(0);
+}
+
+/**
+ * Returns the Ordering with which to encode sort keys as KeyStrings, or boost::none if the merge
+ * must compare the BSON sort keys directly.
+ */
+boost::optional<Ordering> getSortKeyOrdering(const BSONObj& sort) {
+    if (sort.isEmpty() || sort.nFields() > kMaxEncodedSortKeyFields) {
+        return boost::none;
+    }
+
+    return Ordering::make(sort);
+}
+
 }  // namespace
 
 AsyncResultsMerger::AsyncResultsMerger(executor::TaskExecutor* executor,
                                        ClusterClientCursorParams&& params)
     : _executor(executor),
       _params(std::move(params)),
-      _mergeQueue(MergingComparator(_remotes, _params.sort)) {
+      _maxResultsNeeded(getMaxResultsNeeded(_params)),
+      _sortKeyOrdering(getSortKeyOrdering(_params.sort)),
+      _mergeQueue(MergingComparator(_remotes, _params.sort, static_cast<bool>(_sortKeyOrdering))) {
     for (const auto& remote : _params.remotes) {
         if (remote.shardId) {
             invariant(remote.cmdObj);
@@ -102,6 +136,59 @@ bool AsyncResultsMerger::remotesExhausted_inlock() {
     return true;
 }
 
+bool AsyncResultsMerger::limitSatisfied_inlock() const {
+    return _maxResultsNeeded && _numResultsReturned >= *_maxResultsNeeded;
+}
+
+boost::optional<long long> AsyncResultsMerger::remainingResultsNeeded_inlock(
+    size_t remoteIndex) const {
+    if (!_maxResultsNeeded) {
+        return boost::none;
+    }
+
+    long long remaining = *_maxResultsNeeded - _numResultsReturned;
+
+    // Without a sort, every buffered result will be returned before any result of the next
+    // batch, so results buffered from other remotes count towards the limit. With a sort, any of
+    // the remaining results may come from this remote.
+    if (_params.sort.isEmpty()) {
+        for (size_t i = 0; i < _remotes.size(); ++i) {
+            if (i != remoteIndex) {
+                remaining -= static_cast<long long>(_remotes[i].docBuffer.size());
+            }
+        }
+    }
+
+    return std::max(remaining, 0LL);
+}
+
+void AsyncResultsMerger::killUnneededRemoteCursors_inlock() {
+    invariant(limitSatisfied_inlock());
+
+    // The merge queue must be drained before the buffers it refers to are cleared.
+    while (!_mergeQueue.empty()) {
+        _mergeQueue.pop();
+    }
+
+    for (auto& remote : _remotes) {
+        std::queue<ClusterQueryResult> emptyBuffer;
+        std::swap(remote.docBuffer, emptyBuffer);
+        std::queue<std::string> emptySortKeys;
+        std::swap(remote.encodedSortKeys, emptySortKeys);
+
+        // Remotes with an outstanding request are handled when the response arrives.
+        if (remote.cbHandle.isValid() || !remote.status.isOK()) {
+            continue;
+        }
+
+        if (remote.cursorId && !remote.exhausted()) {
+            scheduleKillCursor_inlock(remote);
+        }
+
+        remote.cursorId = 0;
+    }
+}
+
 Status AsyncResultsMerger::setAwaitDataTimeout(Milliseconds awaitDataTimeout) {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
 
@@ -135,6 +222,11 @@ bool AsyncResultsMerger::ready_inlock() {
         return true;
     }
 
+    if (limitSatisfied_inlock()) {
+        // No further results are needed, so we are ready to return boost::none.
+        return true;
+    }
+
     for (const auto& remote : _remotes) {
         // First check whether any of the remotes reported an error.
         if (!remote.status.isOK()) {
@@ -198,8 +290,22 @@ StatusWith<ClusterQueryResult> AsyncResultsMerger::nextReady() {
         return {ClusterQueryResult()};
     }
 
+    if (limitSatisfied_inlock()) {
+        return {ClusterQueryResult()};
+    }
+
     const bool hasSort = !_params.sort.isEmpty();
-    return hasSort ? nextReadySorted() : nextReadyUnsorted();
+    auto next = hasSort ? nextReadySorted() : nextReadyUnsorted();
+
+    if (!next.isEOF() && _maxResultsNeeded) {
+        // As soon as the last useful result is handed out, close the remote cursors rather than
+        // leaving them open until the client cursor is destroyed.
+        if (++_numResultsReturned >= *_maxResultsNeeded) {
+            killUnneededRemoteCursors_inlock();
+        }
+    }
+
+    return next;
 }
 
 ClusterQueryResult AsyncResultsMerger::nextReadySorted() {
@@ -218,6 +324,9 @@ ClusterQueryResult AsyncResultsMerger::nextReadySorted() {
 
     ClusterQueryResult front = _remotes[smallestRemote].docBuffer.front();
     _remotes[smallestRemote].docBuffer.pop();
+    if (_sortKeyOrdering) {
+        _remotes[smallestRemote].encodedSortKeys.pop();
+    }
 
     // Re-populate the merging queue with the next result from 'smallestRemote', if it has a
     // next result.
@@ -276,6 +385,14 @@ Status AsyncResultsMerger::askForNextBatch_inlock(size_t remoteIndex) {
             adjustedBatchSize = *_params.batchSize - remote.fetchedCount;
         }
 
+        // Never ask a remote for more results than could still be returned within the limit. The
+        // remote is only asked for a batch when at least one more result may be needed from it.
+        auto remaining = remainingResultsNeeded_inlock(remoteIndex);
+        if (remaining && *remaining > 0 &&
+            (!adjustedBatchSize || *adjustedBatchSize > *remaining)) {
+            adjustedBatchSize = *remaining;
+        }
+
         cmdObj = GetMoreRequest(_params.nsString,
                                 *remote.cursorId,
                                 adjustedBatchSize,
@@ -345,7 +462,8 @@ StatusWith<executor::TaskExecutor::EventHandle> AsyncResultsMerger::nextEvent()
             return remote.status;
         }
 
-        if (!remote.hasNext() && !remote.exhausted() && !remote.cbHandle.isValid()) {
+        if (!remote.hasNext() && !remote.exhausted() && !remote.cbHandle.isValid() &&
+            remainingResultsNeeded_inlock(i).value_or(1) > 0) {
             // If we already have established a cursor with this remote, and there is no outstanding
             // request for which we have a valid callback handle, then schedule work to retrieve the
             // next batch.
@@ -473,6 +591,11 @@ void AsyncResultsMerger::handleBatchResponse(
             result.setViewDefinition(resolvedViewObj.getOwned());
 
             remote.docBuffer.push(result);
+            if (_sortKeyOrdering) {
+                // Keep the sort keys aligned with 'docBuffer'. The view definition is the only
+                // result from this remote, so the key is never compared.
+                remote.encodedSortKeys.push(std::string());
+            }
             remote.cursorId = 0;
             remote.status = Status::OK();
 
@@ -537,6 +660,8 @@ void AsyncResultsMerger::handleBatchResponse(
             // Clear the results buffer and cursor id.
             std::queue<ClusterQueryResult> emptyBuffer;
             std::swap(remote.docBuffer, emptyBuffer);
+            std::queue<std::string> emptySortKeys;
+            std::swap(remote.encodedSortKeys, emptySortKeys);
             remote.cursorId = 0;
         }
 
@@ -548,6 +673,16 @@ void AsyncResultsMerger::handleBatchResponse(
     remote.cursorId = cursorResponse.getCursorId();
     remote.initialCmdObj = boost::none;
 
+    // If the limit was satisfied while this request was outstanding, the batch is of no use.
+    // Close the remote cursor instead of buffering its results.
+    if (limitSatisfied_inlock()) {
+        if (!remote.exhausted()) {
+            scheduleKillCursor_inlock(remote);
+            remote.cursorId = 0;
+        }
+        return;
+    }
+
     for (const auto& obj : cursorResponse.getBatch()) {
         // If there's a sort, we're expecting the remote node to give us back a sort key.
         if (!_params.sort.isEmpty() &&
@@ -560,8 +695,7 @@ void AsyncResultsMerger::handleBatchResponse(
             return;
         }
 
-        ClusterQueryResult result(obj);
-        remote.docBuffer.push(result);
+        bufferResult_inlock(remote, obj);
         ++remote.fetchedCount;
     }
 
@@ -582,7 +716,8 @@ void AsyncResultsMerger::handleBatchResponse(
     //
     // We do not ask for the next batch if the cursor is tailable, as batches received from remote
     // tailable cursors should be passed through to the client without asking for more batches.
-    if (!_params.isTailable && !remote.hasNext() && !remote.exhausted()) {
+    if (!_params.isTailable && !remote.hasNext() && !remote.exhausted() &&
+        remainingResultsNeeded_inlock(remoteIndex).value_or(1) > 0) {
         remote.status = askForNextBatch_inlock(remoteIndex);
         if (!remote.status.isOK()) {
             return;
@@ -595,6 +730,19 @@ void AsyncResultsMerger::handleBatchResponse(
     signalCurrentEventIfReady_inlock();
 }
 
+void AsyncResultsMerger::bufferResult_inlock(RemoteCursorData& remote, const BSONObj& obj) {
+    remote.docBuffer.push(ClusterQueryResult(obj));
+
+    if (_sortKeyOrdering) {
+        // The sort key values have already been mapped to their collation comparison keys by the
+        // shard, so a binary comparison of the encodings matches the woCompare order.
+        KeyString sortKey(KeyString::Version::V1,
+                          obj[ClusterClientCursorParams::kSortKeyField].Obj(),
+                          *_sortKeyOrdering);
+        remote.encodedSortKeys.emplace(sortKey.getBuffer(), sortKey.getSize());
+    }
+}
+
 void AsyncResultsMerger::signalCurrentEventIfReady_inlock() {
     if (ready_inlock() && _currentEvent.isValid()) {
         // To prevent ourselves from signalling the event twice, we set '_currentEvent' as
@@ -622,18 +770,22 @@ void AsyncResultsMerger::scheduleKillCursors_inlock() {
         invariant(!remote.cbHandle.isValid());
 
         if (remote.status.isOK() && remote.cursorId && !remote.exhausted()) {
-            BSONObj cmdObj = KillCursorsRequest(_params.nsString, {*remote.cursorId}).toBSON();
-
-            executor::RemoteCommandRequest request(
-                remote.getTargetHost(), _params.nsString.db().toString(), cmdObj, _params.txn);
-
-            _executor->scheduleRemoteCommand(
-                request,
-                stdx::bind(&AsyncResultsMerger::handleKillCursorsResponse, stdx::placeholders::_1));
+            scheduleKillCursor_inlock(remote);
         }
     }
 }
 
+void AsyncResultsMerger::scheduleKillCursor_inlock(const RemoteCursorData& remote) {
+    BSONObj cmdObj = KillCursorsRequest(_params.nsString, {*remote.cursorId}).toBSON();
+
+    executor::RemoteCommandRequest request(
+        remote.getTargetHost(), _params.nsString.db().toString(), cmdObj, _params.txn);
+
+    _executor->scheduleRemoteCommand(
+        request,
+        stdx::bind(&AsyncResultsMerger::handleKillCursorsResponse, stdx::placeholders::_1));
+}
+
 void AsyncResultsMerger::handleKillCursorsResponse(
     const executor::TaskExecutor::RemoteCommandCallbackArgs& cbData) {
     // We just ignore any killCursors command responses.
@@ -733,6 +885,10 @@ std::shared_ptr<Shard> AsyncResultsMerger::RemoteCursorData::getShard() {
 //
 
 bool AsyncResultsMerger::MergingComparator::operator()(const size_t& lhs, const size_t& rhs) {
+    if (_useEncodedSortKeys) {
+        return _remotes[lhs].encodedSortKeys.front() > _remotes[rhs].encodedSortKeys.front();
+    }
+
     const ClusterQueryResult& leftDoc = _remotes[lhs].docBuffer.front();
     const ClusterQueryResult& rightDoc = _remotes[rhs].docBuffer.front();
 
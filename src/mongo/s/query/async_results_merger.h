@@ -30,11 +30,13 @@
 
 #include <boost/optional.hpp>
 #include <queue>
+#include <string>
 #include <vector>
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/base/status_with.h"
 #include "mongo/bson/bsonobj.h"
+#include "mongo/bson/ordering.h"
 #include "mongo/db/cursor_id.h"
 #include "mongo/executor/task_executor.h"
 #include "mongo/s/query/cluster_client_cursor_params.h"
@@ -243,6 +245,12 @@ private:
         boost::optional<CursorId> cursorId;
 
         std::queue<ClusterQueryResult> docBuffer;
+
+        // If the merge is sorted and the sort key can be encoded as a KeyString, holds the
+        // encoded sort key of each result in 'docBuffer', in the same order. Comparing the
+        // encoded keys is a memcmp, which is considerably cheaper than a BSON woCompare.
+        std::queue<std::string> encodedSortKeys;
+
         executor::TaskExecutor::CallbackHandle cbHandle;
         Status status = Status::OK();
 
@@ -263,8 +271,10 @@ private:
 
     class MergingComparator {
     public:
-        MergingComparator(const std::vector<RemoteCursorData>& remotes, const BSONObj& sort)
-            : _remotes(remotes), _sort(sort) {}
+        MergingComparator(const std::vector<RemoteCursorData>& remotes,
+                          const BSONObj& sort,
+                          bool useEncodedSortKeys)
+            : _remotes(remotes), _sort(sort), _useEncodedSortKeys(useEncodedSortKeys) {}
 
         bool operator()(const size_t& lhs, const size_t& rhs);
 
@@ -272,6 +282,9 @@ private:
         const std::vector<RemoteCursorData>& _remotes;
 
         const BSONObj& _sort;
+
+        // Whether to compare the pre-encoded KeyString sort keys rather than the BSON sort keys.
+        const bool _useEncodedSortKeys;
     };
 
     enum LifecycleState { kAlive, kKillStarted, kKillComplete };
@@ -305,6 +318,26 @@ private:
      */
     bool remotesExhausted_inlock();
 
+    /**
+     * Returns true if the cursor has a limit and the ARM has already returned enough results to
+     * satisfy the limit and skip of the router stages above it.
+     */
+    bool limitSatisfied_inlock() const;
+
+    /**
+     * If the cursor has a limit, returns how many more results could still be useful to the
+     * caller when asking 'remoteIndex' for its next batch. Returns boost::none if there is no
+     * limit on the number of results.
+     */
+    boost::optional<long long> remainingResultsNeeded_inlock(size_t remoteIndex) const;
+
+    /**
+     * Called once the limit is satisfied. Discards all buffered results and kills the remote
+     * cursors which do not have a request outstanding, marking them as exhausted. Remotes with an
+     * outstanding request are killed as soon as their response arrives.
+     */
+    void killUnneededRemoteCursors_inlock();
+
     //
     // Helpers for ready().
     //
@@ -320,6 +353,12 @@ private:
     ClusterQueryResult nextReadySorted();
     ClusterQueryResult nextReadyUnsorted();
 
+    /**
+     * Buffers 'obj' as the next result from 'remote'. If the merge is sorted using encoded sort
+     * keys, also encodes the result's sort key.
+     */
+    void bufferResult_inlock(RemoteCursorData& remote, const BSONObj& obj);
+
     /**
      * When nextEvent() schedules remote work, it passes this method as a callback. The TaskExecutor
      * will call this function, passing the response from the remote.
@@ -350,11 +389,27 @@ private:
      */
     void scheduleKillCursors_inlock();
 
+    /**
+     * Schedules a killCursors command for the open cursor on 'remote'. The response is ignored.
+     */
+    void scheduleKillCursor_inlock(const RemoteCursorData& remote);
+
     // Not owned here.
     executor::TaskExecutor* _executor;
 
     ClusterClientCursorParams _params;
 
+    // If there is a limit, the total number of results which the router stages above the ARM can
+    // consume, i.e. the limit plus the skip. Unset if there is no limit or the cursor is tailable.
+    boost::optional<long long> _maxResultsNeeded;
+
+    // The number of results returned from nextReady() so far.
+    long long _numResultsReturned = 0;
+
+    // If set, the sorted merge compares KeyString encodings of the sort keys made with this
+    // Ordering. Unset if there is no sort or the sort pattern has too many fields for an Ordering.
+    boost::optional<Ordering> _sortKeyOrdering;
+
     // The metadata obj to pass along with the command request. Used to indicate that the command is
     // ok to run on secondaries.
     BSONObj _metadataObj;
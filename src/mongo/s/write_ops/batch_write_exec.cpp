@@ -32,22 +32,24 @@
 
 #include "mongo/s/write_ops/batch_write_exec.h"
 
+#include <deque>
+
 #include "mongo/base/error_codes.h"
-#include "mongo/base/owned_pointer_map.h"
 #include "mongo/base/status.h"
 #include "mongo/bson/util/builder.h"
 #include "mongo/client/connection_string.h"
 #include "mongo/client/remote_command_targeter.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/s/client/multi_command_dispatch.h"
 #include "mongo/s/client/shard_registry.h"
 #include "mongo/s/grid.h"
 #include "mongo/s/write_ops/batch_write_op.h"
 #include "mongo/s/write_ops/write_error_detail.h"
 #include "mongo/util/log.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
-using std::make_pair;
 using std::stringstream;
 using std::vector;
 
@@ -56,15 +58,46 @@ BatchWriteExec::BatchWriteExec(NSTargeter* targeter, MultiCommandDispatch* dispa
 
 namespace {
 
+// The maximum number of child batches of a client write batch which may be outstanding against
+// a single shard host at once.
+MONGO_EXPORT_SERVER_PARAMETER(maxInFlightWriteBatchesPerShard, int, 2);
+
+/**
+ * A child batch which has been sent to a host, along with a timer started when it was sent.
+ */
+struct InFlightBatch {
+    InFlightBatch(std::unique_ptr<TargetedWriteBatch> batch) : batch(std::move(batch)) {}
+
+    std::unique_ptr<TargetedWriteBatch> batch;
+    Timer timer;
+};
+
 //
-// Map which allows associating ConnectionString hosts with TargetedWriteBatches
-// This is needed since the dispatcher only returns hosts with responses.
+// Map which allows associating ConnectionString hosts with the TargetedWriteBatches sent to
+// them. This is needed since the dispatcher only returns hosts with responses.
 //
+typedef std::map<ConnectionString, std::deque<InFlightBatch>> InFlightBatchMap;
 
-// TODO: Unordered map?
-typedef OwnedPointerMap<ConnectionString, TargetedWriteBatch> OwnedHostBatchMap;
+/**
+ * Returns the host of the primary of the given shard, to which write batches are dispatched.
+ */
+StatusWith<ConnectionString> resolveShardHost(OperationContext* txn, const ShardId& shardId) {
+    auto shardStatus = Grid::get(txn)->shardRegistry()->getShard(txn, shardId);
+    if (!shardStatus.isOK()) {
+        return shardStatus.getStatus();
+    }
+
+    const ReadPreferenceSetting readPref(ReadPreference::PrimaryOnly, TagSet());
+    auto swHostAndPort = shardStatus.getValue()->getTargeter()->findHostNoWait(readPref);
+    if (!swHostAndPort.isOK()) {
+        return swHostAndPort.getStatus();
+    }
+
+    return ConnectionString(std::move(swHostAndPort.getValue()));
 }
 
+}  // namespace
+
 static void buildErrorFrom(const Status& status, WriteErrorDetail* error) {
     error->setErrCode(status.code());
     error->setErrMessage(status.reason());
@@ -125,111 +158,105 @@ void BatchWriteExec::executeBatch(OperationContext* txn,
         //    exactly when the metadata changed.
         //
 
-        OwnedPointerVector<TargetedWriteBatch> childBatchesOwned;
-        vector<TargetedWriteBatch*>& childBatches = childBatchesOwned.mutableVector();
-
         // If we've already had a targeting error, we've refreshed the metadata once and can
         // record target errors definitively.
         bool recordTargetErrors = refreshedTargeter;
-        Status targetStatus =
-            batchOp.targetBatch(txn, *_targeter, recordTargetErrors, &childBatches);
-        if (!targetStatus.isOK()) {
-            // Don't do anything until a targeter refresh
-            _targeter->noteCouldNotTarget();
-            refreshedTargeter = true;
-            ++stats->numTargetErrors;
-            dassert(childBatches.size() == 0u);
-        }
 
         //
-        // Send all child batches
+        // Within a round, child batches are pipelined: as soon as a batch is sent, the next
+        // writes are targeted, and their batches are sent to any host which has fewer than
+        // 'maxInFlightWriteBatchesPerShard' batches outstanding. The round ends once there is
+        // nothing left to target or send and all responses have been received.
         //
+        // Ordered batches are targeted once per round, since a write may only be sent after
+        // the results of all the writes which precede it are known. Targeting also stops for
+        // the rest of the round on a targeting error or a stale response, since the targeter
+        // must be refreshed before the affected writes can be retargeted.
+        //
+
+        const size_t maxInFlightPerHost =
+            static_cast<size_t>(std::max(1, maxInFlightWriteBatchesPerShard.load()));
 
-        size_t numSent = 0;
-        size_t numToSend = childBatches.size();
-        while (numSent != numToSend) {
-            // Collect batches out on the network, mapped by endpoint
-            OwnedHostBatchMap ownedPendingBatches;
-            OwnedHostBatchMap::MapType& pendingBatches = ownedPendingBatches.mutableMap();
+        // Batches which have been targeted and resolved to a host, but not yet sent
+        std::deque<std::pair<ConnectionString, std::unique_ptr<TargetedWriteBatch>>>
+            waitingBatches;
 
+        // Batches out on the network, in the order they were sent to each host
+        InFlightBatchMap inFlightBatches;
+        size_t numInFlight = 0;
+
+        bool targetingComplete = false;
+
+        while (true) {
             //
-            // Send side
+            // Get child batches to send using the targeter
             //
 
-            // Get as many batches as we can at once
-            for (vector<TargetedWriteBatch*>::iterator it = childBatches.begin();
-                 it != childBatches.end();
-                 ++it) {
-                //
-                // Collect the info needed to dispatch our targeted batch
-                //
+            if (!targetingComplete && waitingBatches.empty()) {
+                OwnedPointerVector<TargetedWriteBatch> childBatchesOwned;
+                vector<TargetedWriteBatch*>& childBatches = childBatchesOwned.mutableVector();
+
+                Status targetStatus =
+                    batchOp.targetBatch(txn, *_targeter, recordTargetErrors, &childBatches);
+                if (!targetStatus.isOK()) {
+                    // Don't do anything until a targeter refresh
+                    _targeter->noteCouldNotTarget();
+                    refreshedTargeter = true;
+                    ++stats->numTargetErrors;
+                    dassert(childBatches.size() == 0u);
+                }
 
-                TargetedWriteBatch* nextBatch = *it;
-                // If the batch is NULL, we sent it previously, so skip
-                if (nextBatch == NULL)
-                    continue;
+                if (childBatches.empty() || clientRequest.getOrdered()) {
+                    targetingComplete = true;
+                }
 
-                // Figure out what host we need to dispatch our targeted batch
-                const ReadPreferenceSetting readPref(ReadPreference::PrimaryOnly, TagSet());
-                auto shardStatus = Grid::get(txn)->shardRegistry()->getShard(
-                    txn, nextBatch->getEndpoint().shardName);
-
-                bool resolvedHost = false;
-                ConnectionString shardHost;
-                if (!shardStatus.isOK()) {
-                    Status status(std::move(shardStatus.getStatus()));
-
-                    // Record a resolve failure
-                    // TODO: It may be necessary to refresh the cache if stale, or maybe just
-                    // cancel and retarget the batch
-                    WriteErrorDetail error;
-                    buildErrorFrom(status, &error);
-                    LOG(4) << "unable to send write batch to " << nextBatch->getEndpoint().shardName
-                           << causedBy(status);
-                    batchOp.noteBatchError(*nextBatch, error);
-                } else {
-                    auto shard = shardStatus.getValue();
-
-                    auto swHostAndPort = shard->getTargeter()->findHostNoWait(readPref);
-                    if (!swHostAndPort.isOK()) {
+                for (auto& childBatch : childBatches) {
+                    std::unique_ptr<TargetedWriteBatch> nextBatch(childBatch);
+                    childBatch = NULL;
 
+                    // Figure out what host we need to dispatch our targeted batch
+                    auto swShardHost = resolveShardHost(txn, nextBatch->getEndpoint().shardName);
+                    if (!swShardHost.isOK()) {
                         // Record a resolve failure
                         // TODO: It may be necessary to refresh the cache if stale, or maybe just
                         // cancel and retarget the batch
                         WriteErrorDetail error;
-                        buildErrorFrom(swHostAndPort.getStatus(), &error);
+                        buildErrorFrom(swShardHost.getStatus(), &error);
                         LOG(4) << "unable to send write batch to "
                                << nextBatch->getEndpoint().shardName
-                               << causedBy(swHostAndPort.getStatus());
+                               << causedBy(swShardHost.getStatus());
                         batchOp.noteBatchError(*nextBatch, error);
-                    } else {
-                        shardHost = ConnectionString(std::move(swHostAndPort.getValue()));
-                        resolvedHost = true;
+
+                        ++stats->numResolveErrors;
+                        continue;
                     }
+
+                    waitingBatches.emplace_back(std::move(swShardHost.getValue()),
+                                                std::move(nextBatch));
                 }
+            }
 
-                if (!resolvedHost) {
-                    ++stats->numResolveErrors;
+            //
+            // Send side
+            //
 
-                    // We're done with this batch
-                    // Clean up when we can't resolve a host
-                    delete *it;
-                    *it = NULL;
-                    --numToSend;
-                    continue;
-                }
+            for (auto it = waitingBatches.begin(); it != waitingBatches.end();) {
+                const ConnectionString& shardHost = it->first;
 
-                // If we already have a batch for this host, wait until the next time
-                OwnedHostBatchMap::MapType::iterator pendingIt = pendingBatches.find(shardHost);
-                if (pendingIt != pendingBatches.end())
+                // If this host already has as many batches outstanding as we allow, wait until
+                // one of its responses comes back
+                auto& hostInFlight = inFlightBatches[shardHost];
+                if (hostInFlight.size() >= maxInFlightPerHost) {
+                    ++it;
                     continue;
+                }
 
                 //
                 // We now have all the info needed to dispatch the batch
                 //
 
                 BatchedCommandRequest request(clientRequest.getBatchType());
-                batchOp.buildBatchRequest(*nextBatch, &request);
+                batchOp.buildBatchRequest(*it->second, &request);
 
                 // Internally we use full namespaces for request/response, but we send the
                 // command to a database with the collection name in the request.
@@ -241,75 +268,92 @@ void BatchWriteExec::executeBatch(OperationContext* txn,
 
                 _dispatcher->addCommand(shardHost, nss.db(), request.toBSON());
 
-                // Indicate we're done by setting the batch to NULL
-                // We'll only get duplicate hostEndpoints if we have broadcast and non-broadcast
-                // endpoints for the same host, so this should be pretty efficient without
-                // moving stuff around.
-                *it = NULL;
+                // Recv-side is responsible for cleaning up the batch when used
+                hostInFlight.emplace_back(std::move(it->second));
+                ++numInFlight;
 
-                // Recv-side is responsible for cleaning up the nextBatch when used
-                pendingBatches.insert(make_pair(shardHost, nextBatch));
+                it = waitingBatches.erase(it);
             }
 
             // Send them all out
             _dispatcher->sendAll();
-            numSent += pendingBatches.size();
+
+            if (numInFlight == 0) {
+                // Nothing is outstanding, so every waiting batch has been sent
+                dassert(waitingBatches.empty());
+
+                if (targetingComplete) {
+                    break;
+                }
+
+                continue;
+            }
 
             //
             // Recv side
             //
 
-            while (_dispatcher->numPending() > 0) {
-                // Get the response
-                ConnectionString shardHost;
-                BatchedCommandResponse response;
-                Status dispatchStatus = _dispatcher->recvAny(&shardHost, &response);
+            // Get the response
+            ConnectionString shardHost;
+            BatchedCommandResponse response;
+            Status dispatchStatus = _dispatcher->recvAny(&shardHost, &response);
 
-                // Get the TargetedWriteBatch to find where to put the response
-                dassert(pendingBatches.find(shardHost) != pendingBatches.end());
-                TargetedWriteBatch* batch = pendingBatches.find(shardHost)->second;
+            // Responses from a host come back in the order the batches were sent, so the
+            // oldest outstanding batch for the host is the one this response belongs to
+            auto& hostInFlight = inFlightBatches[shardHost];
+            invariant(!hostInFlight.empty());
+            InFlightBatch inFlight(std::move(hostInFlight.front()));
+            hostInFlight.pop_front();
+            --numInFlight;
 
-                if (dispatchStatus.isOK()) {
-                    TrackedErrors trackedErrors;
-                    trackedErrors.startTracking(ErrorCodes::StaleShardVersion);
+            const TargetedWriteBatch* batch = inFlight.batch.get();
 
-                    LOG(4) << "write results received from " << shardHost.toString() << ": "
-                           << redact(response.toString());
+            stats->noteShardBatchLatency(batch->getEndpoint().shardName,
+                                         Milliseconds(inFlight.timer.millis()));
 
-                    // Dispatch was ok, note response
-                    batchOp.noteBatchResponse(*batch, response, &trackedErrors);
+            if (dispatchStatus.isOK()) {
+                TrackedErrors trackedErrors;
+                trackedErrors.startTracking(ErrorCodes::StaleShardVersion);
 
-                    // Note if anything was stale
-                    const vector<ShardError*>& staleErrors =
-                        trackedErrors.getErrors(ErrorCodes::StaleShardVersion);
+                LOG(4) << "write results received from " << shardHost.toString() << ": "
+                       << redact(response.toString());
 
-                    if (staleErrors.size() > 0) {
-                        noteStaleResponses(staleErrors, _targeter);
-                        ++stats->numStaleBatches;
-                    }
+                // Dispatch was ok, note response
+                batchOp.noteBatchResponse(*batch, response, &trackedErrors);
 
-                    // Remember that we successfully wrote to this shard
-                    // NOTE: This will record lastOps for shards where we actually didn't update
-                    // or delete any documents, which preserves old behavior but is conservative
-                    stats->noteWriteAt(
-                        shardHost,
-                        response.isLastOpSet() ? response.getLastOp() : repl::OpTime(),
-                        response.isElectionIdSet() ? response.getElectionId() : OID());
-                } else {
-                    // Error occurred dispatching, note it
+                // Note if anything was stale
+                const vector<ShardError*>& staleErrors =
+                    trackedErrors.getErrors(ErrorCodes::StaleShardVersion);
 
-                    stringstream msg;
-                    msg << "write results unavailable from " << shardHost.toString()
-                        << causedBy(dispatchStatus.toString());
+                if (staleErrors.size() > 0) {
+                    noteStaleResponses(staleErrors, _targeter);
+                    ++stats->numStaleBatches;
 
-                    WriteErrorDetail error;
-                    buildErrorFrom(Status(ErrorCodes::RemoteResultsUnavailable, msg.str()), &error);
+                    // Stale writes go back to being ready, and must not be retargeted until
+                    // the targeter is refreshed at the end of this round
+                    targetingComplete = true;
+                }
 
-                    LOG(4) << "unable to receive write results from " << shardHost.toString()
-                           << causedBy(redact(dispatchStatus.toString()));
+                // Remember that we successfully wrote to this shard
+                // NOTE: This will record lastOps for shards where we actually didn't update
+                // or delete any documents, which preserves old behavior but is conservative
+                stats->noteWriteAt(shardHost,
+                                   response.isLastOpSet() ? response.getLastOp() : repl::OpTime(),
+                                   response.isElectionIdSet() ? response.getElectionId() : OID());
+            } else {
+                // Error occurred dispatching, note it
 
-                    batchOp.noteBatchError(*batch, error);
-                }
+                stringstream msg;
+                msg << "write results unavailable from " << shardHost.toString()
+                    << causedBy(dispatchStatus.toString());
+
+                WriteErrorDetail error;
+                buildErrorFrom(Status(ErrorCodes::RemoteResultsUnavailable, msg.str()), &error);
+
+                LOG(4) << "unable to receive write results from " << shardHost.toString()
+                       << causedBy(redact(dispatchStatus.toString()));
+
+                batchOp.noteBatchError(*batch, error);
             }
         }
 
@@ -369,6 +413,14 @@ void BatchWriteExec::executeBatch(OperationContext* txn,
                    : "")
            << (clientResponse->isWriteConcernErrorSet() ? " with write concern error" : "")
            << " for " << clientRequest.getNS();
+    if (shouldLog(logger::LogSeverity::Debug(2))) {
+        for (const auto& shardStats : stats->getShardBatchStats()) {
+            LOG(2) << "sent " << shardStats.second.numBatches << " write batches for "
+                   << clientRequest.getNS() << " to shard " << shardStats.first
+                   << ", total latency: " << shardStats.second.totalLatency
+                   << ", max latency: " << shardStats.second.maxLatency;
+        }
+    }
 }
 
 void BatchWriteExecStats::noteWriteAt(const ConnectionString& host,
@@ -380,4 +432,15 @@ void BatchWriteExecStats::noteWriteAt(const ConnectionString& host,
 const HostOpTimeMap& BatchWriteExecStats::getWriteOpTimes() const {
     return _writeOpTimes;
 }
+
+void BatchWriteExecStats::noteShardBatchLatency(const ShardId& shardId, Milliseconds latency) {
+    auto& shardStats = _shardBatchStats[shardId];
+    ++shardStats.numBatches;
+    shardStats.totalLatency += latency;
+    shardStats.maxLatency = std::max(shardStats.maxLatency, latency);
+}
+
+const ShardBatchStatsMap& BatchWriteExecStats::getShardBatchStats() const {
+    return _shardBatchStats;
+}
 }
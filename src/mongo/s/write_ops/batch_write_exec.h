@@ -36,8 +36,10 @@
 #include "mongo/bson/timestamp.h"
 #include "mongo/db/repl/optime.h"
 #include "mongo/s/ns_targeter.h"
+#include "mongo/s/shard_id.h"
 #include "mongo/s/write_ops/batched_command_request.h"
 #include "mongo/s/write_ops/batched_command_response.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
@@ -59,6 +61,9 @@ class OperationContext;
  * Both the targeter and dispatcher are assumed to be dedicated to this particular
  * BatchWriteExec instance.
  *
+ * Child batches are pipelined: while some are outstanding, further writes are targeted and sent
+ * to shards which have fewer than the maximum number of batches in flight.
+ *
  */
 class BatchWriteExec {
     MONGO_DISALLOW_COPYING(BatchWriteExec);
@@ -94,6 +99,17 @@ struct HostOpTime {
 
 typedef std::map<ConnectionString, HostOpTime> HostOpTimeMap;
 
+/**
+ * Round-trip latencies of the child batches sent to a single shard.
+ */
+struct ShardBatchStats {
+    int numBatches = 0;
+    Milliseconds totalLatency{0};
+    Milliseconds maxLatency{0};
+};
+
+typedef std::map<ShardId, ShardBatchStats> ShardBatchStatsMap;
+
 class BatchWriteExecStats {
 public:
     BatchWriteExecStats()
@@ -103,6 +119,10 @@ public:
 
     const HostOpTimeMap& getWriteOpTimes() const;
 
+    void noteShardBatchLatency(const ShardId& shardId, Milliseconds latency);
+
+    const ShardBatchStatsMap& getShardBatchStats() const;
+
     // Expose via helpers if this gets more complex
 
     // Number of round trips required for the batch
@@ -116,5 +136,6 @@ public:
 
 private:
     HostOpTimeMap _writeOpTimes;
+    ShardBatchStatsMap _shardBatchStats;
 };
 }
@@ -172,6 +172,35 @@ TEST_F(BatchWriteExecTest, SingleOpError) {
 // Test retryable errors
 //
 
+TEST_F(BatchWriteExecTest, UnorderedChildBatchesArePipelined) {
+    //
+    // An unordered batch too large for a single child batch should still complete in one round,
+    // with the child batches to the same shard sent without waiting for each other
+    //
+
+    BatchedCommandRequest request(BatchedCommandRequest::BatchType_Insert);
+    request.setNS(nss);
+    request.setOrdered(false);
+    request.setWriteConcern(BSONObj());
+
+    // Two documents which together exceed the maximum size of a single child batch
+    const std::string bigString(10 * 1024 * 1024, 'x');
+    request.getInsertRequest()->addToDocuments(BSON("x" << 1 << "data" << bigString));
+    request.getInsertRequest()->addToDocuments(BSON("x" << 2 << "data" << bigString));
+
+    BatchedCommandResponse response;
+    BatchWriteExecStats stats;
+    exec->executeBatch(operationContext(), request, &response, &stats);
+    ASSERT(response.getOk());
+
+    ASSERT_EQUALS(stats.numRounds, 1);
+
+    const auto& shardBatchStats = stats.getShardBatchStats();
+    ASSERT_EQUALS(shardBatchStats.size(), 1U);
+    ASSERT_EQUALS(shardBatchStats.begin()->first, ShardId(shardName));
+    ASSERT_EQUALS(shardBatchStats.begin()->second.numBatches, 2);
+}
+
 TEST_F(BatchWriteExecTest, StaleOp) {
     //
     // Retry op in exec b/c of stale config
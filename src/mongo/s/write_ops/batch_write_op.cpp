@@ -40,6 +40,10 @@ using std::set;
 using std::stringstream;
 using std::vector;
 
+// Ordered batches stop targeting at the first write which goes to a new shard endpoint, so their
+// inserts are targeted in windows of at most this many write ops instead of all at once
+static const size_t kMaxOrderedInsertTargetingWindow = 64;
+
 /**
  * Returns a new write concern that has the copy of every field from the original
  * document but with a w set to 1. This is intended for upgrading { w: 0 } write
@@ -65,7 +69,11 @@ static BSONObj upgradeWriteConcern(const BSONObj& origWriteConcern) {
 BatchWriteStats::BatchWriteStats()
     : numInserted(0), numUpserted(0), numMatched(0), numModified(0), numDeleted(0) {}
 
-BatchWriteOp::BatchWriteOp() : _clientRequest(NULL), _writeOps(NULL), _stats(new BatchWriteStats) {}
+BatchWriteOp::BatchWriteOp()
+    : _clientRequest(NULL),
+      _writeOps(NULL),
+      _orderedInsertTargetingWindow(kMaxOrderedInsertTargetingWindow),
+      _stats(new BatchWriteStats) {}
 
 void BatchWriteOp::initClientRequest(const BatchedCommandRequest* clientRequest) {
     dassert(clientRequest->isValid(NULL));
@@ -203,6 +211,45 @@ static bool wouldMakeBatchesTooBig(const vector<TargetedWrite*>& writes,
     return false;
 }
 
+// Helper function to target the documents of all the _Ready inserts in writeOps[begin, end) with a
+// single batched targeting call. The endpoints, chunk mins and statuses are indexed by the
+// position of the write op relative to 'begin', and inserts which are not _Ready get a NULL
+// endpoint.
+static void targetInsertWindow(OperationContext* txn,
+                               const NSTargeter& targeter,
+                               WriteOp* writeOps,
+                               size_t begin,
+                               size_t end,
+                               vector<ShardEndpoint*>* endpoints,
+                               vector<BSONObj>* chunkMins,
+                               vector<Status>* statuses) {
+    vector<BSONObj> docs;
+    vector<size_t> docPositions;
+
+    for (size_t i = begin; i < end; ++i) {
+        if (writeOps[i].getWriteState() != WriteOpState_Ready)
+            continue;
+
+        docs.push_back(writeOps[i].getWriteItem().getDocument());
+        docPositions.push_back(i - begin);
+    }
+
+    vector<ShardEndpoint*> docEndpoints;
+    vector<BSONObj> docChunkMins;
+    vector<Status> docStatuses;
+    targeter.targetInserts(txn, docs, &docEndpoints, &docChunkMins, &docStatuses);
+
+    endpoints->assign(end - begin, NULL);
+    chunkMins->assign(end - begin, BSONObj());
+    statuses->assign(end - begin, Status::OK());
+
+    for (size_t i = 0; i < docs.size(); ++i) {
+        (*endpoints)[docPositions[i]] = docEndpoints[i];
+        (*chunkMins)[docPositions[i]] = docChunkMins[i];
+        (*statuses)[docPositions[i]] = docStatuses[i];
+    }
+}
+
 // Helper function to cancel all the write ops of targeted batches in a map
 static void cancelBatches(const WriteErrorDetail& why,
                           WriteOp* writeOps,
@@ -278,6 +325,21 @@ Status BatchWriteOp::targetBatch(OperationContext* txn,
     int numTargetErrors = 0;
 
     size_t numWriteOps = _clientRequest->sizeWriteOps();
+
+    // Inserts are targeted in batches, so that the chunk boundaries are traversed once for many
+    // documents instead of once for every document
+    const bool targetInsertsInBatches =
+        _clientRequest->getBatchType() == BatchedCommandRequest::BatchType_Insert &&
+        !_clientRequest->isInsertIndexRequest();
+
+    OwnedPointerVector<ShardEndpoint> insertEndpointsOwned;
+    vector<ShardEndpoint*>& insertEndpoints = insertEndpointsOwned.mutableVector();
+    vector<BSONObj> insertChunkMins;
+    vector<Status> insertStatuses;
+    size_t insertWindowBegin = 0;
+    size_t insertWindowEnd = 0;
+    size_t numAddedFromInsertWindow = 0;
+
     for (size_t i = 0; i < numWriteOps; ++i) {
         WriteOp& writeOp = _writeOps[i];
 
@@ -293,7 +355,37 @@ Status BatchWriteOp::targetBatch(OperationContext* txn,
         OwnedPointerVector<TargetedWrite> writesOwned;
         vector<TargetedWrite*>& writes = writesOwned.mutableVector();
 
-        Status targetStatus = writeOp.targetWrites(txn, targeter, &writes);
+        Status targetStatus = Status::OK();
+
+        if (targetInsertsInBatches) {
+            if (i >= insertWindowEnd) {
+                insertWindowBegin = i;
+                // Unordered rounds stop once the batch for some shard is full, so targeting all
+                // the remaining inserts in every round would make large batches quadratic
+                const size_t windowSize = ordered ? _orderedInsertTargetingWindow
+                                                  : BatchedCommandRequest::kMaxWriteBatchSize;
+                insertWindowEnd = std::min(numWriteOps, insertWindowBegin + windowSize);
+                numAddedFromInsertWindow = 0;
+
+                insertEndpointsOwned.clear();
+                targetInsertWindow(txn,
+                                   targeter,
+                                   _writeOps,
+                                   insertWindowBegin,
+                                   insertWindowEnd,
+                                   &insertEndpoints,
+                                   &insertChunkMins,
+                                   &insertStatuses);
+            }
+
+            const size_t windowPos = i - insertWindowBegin;
+            targetStatus = insertStatuses[windowPos];
+            if (targetStatus.isOK() && insertEndpoints[windowPos]) {
+                writeOp.targetInsert(*insertEndpoints[windowPos], &writes);
+            }
+        } else {
+            targetStatus = writeOp.targetWrites(txn, targeter, &writes);
+        }
 
         if (!targetStatus.isOK()) {
             WriteErrorDetail targetError;
@@ -378,6 +470,12 @@ Status BatchWriteOp::targetBatch(OperationContext* txn,
         // Relinquish ownership of TargetedWrites, now the TargetedBatches own them
         writesOwned.mutableVector().clear();
 
+        // Only inserts which are actually sent count towards the size of their chunks
+        if (targetInsertsInBatches) {
+            targeter.noteInsertAdded(insertChunkMins[i - insertWindowBegin], writeSizeBytes);
+            ++numAddedFromInsertWindow;
+        }
+
         //
         // Break if we're ordered and we have more than one endpoint - later writes cannot be
         // enforced as ordered across multiple shard endpoints.
@@ -387,6 +485,18 @@ Status BatchWriteOp::targetBatch(OperationContext* txn,
             break;
     }
 
+    //
+    // Size the next ordered insert window after how many writes of this one could be sent, so
+    // that inserts which alternate between shards are not targeted over and over again
+    //
+
+    if (targetInsertsInBatches && ordered && insertWindowEnd > insertWindowBegin) {
+        const size_t windowSize = insertWindowEnd - insertWindowBegin;
+        _orderedInsertTargetingWindow = numAddedFromInsertWindow < windowSize
+            ? numAddedFromInsertWindow + 1
+            : std::min(2 * windowSize, kMaxOrderedInsertTargetingWindow);
+    }
+
     //
     // Send back our targeted batches
     //
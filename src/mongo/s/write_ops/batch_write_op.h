@@ -168,6 +168,9 @@ private:
     // Array of ops being processed from the client request
     WriteOp* _writeOps;
 
+    // Number of write ops targeted at once by the next round of an ordered insert batch
+    size_t _orderedInsertTargetingWindow;
+
     // Current outstanding batch op write requests
     // Not owned here but tracked for reporting
     std::set<const TargetedWriteBatch*> _targeted;
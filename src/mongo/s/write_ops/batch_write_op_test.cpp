@@ -74,6 +74,28 @@ void initTargeterHalfRange(const NamespaceString& nss,
     targeter->init(mockRanges);
 }
 
+/**
+ * Counts the inserts which go through batched targeting and the ones which are added to a batch.
+ */
+class CountingNSTargeter : public MockNSTargeter {
+public:
+    void targetInserts(OperationContext* txn,
+                       const std::vector<BSONObj>& docs,
+                       std::vector<ShardEndpoint*>* endpoints,
+                       std::vector<BSONObj>* chunkMins,
+                       std::vector<Status>* statuses) const {
+        numInsertsTargeted += docs.size();
+        MockNSTargeter::targetInserts(txn, docs, endpoints, chunkMins, statuses);
+    }
+
+    void noteInsertAdded(const BSONObj& chunkMin, int sizeBytes) const {
+        ++numInsertsAdded;
+    }
+
+    mutable size_t numInsertsTargeted = 0;
+    mutable size_t numInsertsAdded = 0;
+};
+
 BatchedDeleteDocument* buildDelete(const BSONObj& query, int limit) {
     BatchedDeleteDocument* deleteDoc = new BatchedDeleteDocument;
     deleteDoc->setQuery(query);
@@ -523,6 +545,119 @@ TEST(WriteOpTests, MultiOpTwoShardsOrdered) {
     ASSERT_EQUALS(clientResponse.getN(), 2);
 }
 
+TEST(WriteOpTests, ManyInsertsTwoShardsOrdered) {
+    //
+    // Ordered insert batch which is longer than the window in which ordered inserts are
+    // targeted, with the switch between the shards falling inside a later window
+    // There should be two batches, one with all the inserts for each shard
+    //
+
+    OperationContextNoop txn;
+    NamespaceString nss("foo.bar");
+    ShardEndpoint endpointA(ShardId("shardA"), ChunkVersion::IGNORED());
+    ShardEndpoint endpointB(ShardId("shardB"), ChunkVersion::IGNORED());
+    MockNSTargeter targeter;
+    initTargeterSplitRange(nss, endpointA, endpointB, &targeter);
+
+    const int numDocsPerShard = 150;
+
+    BatchedCommandRequest request(BatchedCommandRequest::BatchType_Insert);
+    request.setNS(nss);
+    request.setOrdered(true);
+    for (int i = 0; i < numDocsPerShard; ++i) {
+        request.getInsertRequest()->addToDocuments(BSON("x" << -1 - i));
+    }
+    for (int i = 0; i < numDocsPerShard; ++i) {
+        request.getInsertRequest()->addToDocuments(BSON("x" << i));
+    }
+
+    BatchWriteOp batchOp;
+    batchOp.initClientRequest(&request);
+
+    OwnedPointerVector<TargetedWriteBatch> targetedOwned;
+    vector<TargetedWriteBatch*>& targeted = targetedOwned.mutableVector();
+    Status status = batchOp.targetBatch(&txn, targeter, false, &targeted);
+
+    ASSERT(status.isOK());
+    ASSERT_EQUALS(targeted.size(), 1u);
+    ASSERT_EQUALS(targeted.front()->getWrites().size(), static_cast<size_t>(numDocsPerShard));
+    assertEndpointsEqual(targeted.front()->getEndpoint(), endpointA);
+
+    BatchedCommandResponse response;
+    buildResponse(numDocsPerShard, &response);
+
+    batchOp.noteBatchResponse(*targeted.front(), response, NULL);
+    ASSERT(!batchOp.isFinished());
+
+    targetedOwned.clear();
+    status = batchOp.targetBatch(&txn, targeter, false, &targeted);
+    ASSERT(status.isOK());
+    ASSERT_EQUALS(targeted.size(), 1u);
+    ASSERT_EQUALS(targeted.front()->getWrites().size(), static_cast<size_t>(numDocsPerShard));
+    assertEndpointsEqual(targeted.front()->getEndpoint(), endpointB);
+
+    batchOp.noteBatchResponse(*targeted.front(), response, NULL);
+    ASSERT(batchOp.isFinished());
+
+    BatchedCommandResponse clientResponse;
+    batchOp.buildClientResponse(&clientResponse);
+    ASSERT(clientResponse.getOk());
+    ASSERT_EQUALS(clientResponse.getN(), 2 * numDocsPerShard);
+}
+
+TEST(WriteOpTests, AlternatingInsertsTwoShardsOrdered) {
+    //
+    // Ordered insert batch whose inserts alternate between two shards, so that only one of them
+    // can be sent at a time
+    // The inserts should not be retargeted for every round, and each should be counted towards
+    // the size of its chunk once
+    //
+
+    OperationContextNoop txn;
+    NamespaceString nss("foo.bar");
+    ShardEndpoint endpointA(ShardId("shardA"), ChunkVersion::IGNORED());
+    ShardEndpoint endpointB(ShardId("shardB"), ChunkVersion::IGNORED());
+    CountingNSTargeter targeter;
+    initTargeterSplitRange(nss, endpointA, endpointB, &targeter);
+
+    const size_t numDocs = 200;
+
+    BatchedCommandRequest request(BatchedCommandRequest::BatchType_Insert);
+    request.setNS(nss);
+    request.setOrdered(true);
+    for (size_t i = 0; i < numDocs; ++i) {
+        request.getInsertRequest()->addToDocuments(BSON("x" << (i % 2 ? 1 : -1)));
+    }
+
+    BatchWriteOp batchOp;
+    batchOp.initClientRequest(&request);
+
+    BatchedCommandResponse response;
+    buildResponse(1, &response);
+
+    for (size_t i = 0; i < numDocs; ++i) {
+        OwnedPointerVector<TargetedWriteBatch> targetedOwned;
+        vector<TargetedWriteBatch*>& targeted = targetedOwned.mutableVector();
+        Status status = batchOp.targetBatch(&txn, targeter, false, &targeted);
+
+        ASSERT(status.isOK());
+        ASSERT_EQUALS(targeted.size(), 1u);
+        ASSERT_EQUALS(targeted.front()->getWrites().size(), 1u);
+        assertEndpointsEqual(targeted.front()->getEndpoint(), i % 2 ? endpointB : endpointA);
+
+        batchOp.noteBatchResponse(*targeted.front(), response, NULL);
+    }
+    ASSERT(batchOp.isFinished());
+
+    ASSERT_EQUALS(targeter.numInsertsAdded, numDocs);
+    ASSERT_LESS_THAN_OR_EQUALS(targeter.numInsertsTargeted, 64 + 2 * numDocs);
+
+    BatchedCommandResponse clientResponse;
+    batchOp.buildClientResponse(&clientResponse);
+    ASSERT(clientResponse.getOk());
+    ASSERT_EQUALS(clientResponse.getN(), static_cast<int>(numDocs));
+}
+
 TEST(WriteOpTests, MultiOpTwoShardsUnordered) {
     //
     // Multi-op, multi-endpoint targeting test (unordered)
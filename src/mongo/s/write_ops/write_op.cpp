@@ -116,7 +116,22 @@ Status WriteOp::targetWrites(OperationContext* txn,
     if (!targetStatus.isOK())
         return targetStatus;
 
-    for (vector<ShardEndpoint*>::iterator it = endpoints.begin(); it != endpoints.end(); ++it) {
+    addTargetedWrites(endpoints, targetedWrites);
+    return Status::OK();
+}
+
+void WriteOp::targetInsert(const ShardEndpoint& endpoint,
+                           std::vector<TargetedWrite*>* targetedWrites) {
+    dassert(_itemRef.getOpType() == BatchedCommandRequest::BatchType_Insert);
+
+    ShardEndpoint endpointCopy(endpoint);
+    addTargetedWrites({&endpointCopy}, targetedWrites);
+}
+
+void WriteOp::addTargetedWrites(const std::vector<ShardEndpoint*>& endpoints,
+                                std::vector<TargetedWrite*>* targetedWrites) {
+    for (vector<ShardEndpoint*>::const_iterator it = endpoints.begin(); it != endpoints.end();
+         ++it) {
         ShardEndpoint* endpoint = *it;
 
         _childOps.push_back(new ChildWriteOp(this));
@@ -136,7 +151,6 @@ Status WriteOp::targetWrites(OperationContext* txn,
     }
 
     _state = WriteOpState_Pending;
-    return Status::OK();
 }
 
 size_t WriteOp::getNumTargeted() {
@@ -126,6 +126,12 @@ public:
                         const NSTargeter& targeter,
                         std::vector<TargetedWrite*>* targetedWrites);
 
+    /**
+     * Creates the TargetedWrite for an insert whose document was already targeted at 'endpoint'
+     * through NSTargeter::targetInserts, as part of a batch of inserts.
+     */
+    void targetInsert(const ShardEndpoint& endpoint, std::vector<TargetedWrite*>* targetedWrites);
+
     /**
      * Returns the number of child writes that were last targeted.
      */
@@ -164,6 +170,12 @@ public:
     void setOpError(const WriteErrorDetail& error);
 
 private:
+    /**
+     * Creates a pending child write and its TargetedWrite for each of the endpoints.
+     */
+    void addTargetedWrites(const std::vector<ShardEndpoint*>& endpoints,
+                           std::vector<TargetedWrite*>* targetedWrites);
+
     /**
      * Updates the op state after new information is received.
      */
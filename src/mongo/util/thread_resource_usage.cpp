@@ -0,0 +1,108 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/thread_resource_usage.h"
+
+#if defined(MONGO_HAVE_THREAD_CPU_CLOCK)
+#include <pthread.h>
+#include <sys/resource.h>
+#endif
+
+#include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/threadlocal.h"
+
+namespace mongo {
+
+namespace {
+MONGO_TRIVIALLY_CONSTRUCTIBLE_THREAD_LOCAL long long threadAllocatedBytes;
+
+#if defined(MONGO_HAVE_THREAD_CPU_CLOCK)
+long long readClockNanos(clockid_t clockId) {
+    struct timespec ts;
+    if (clock_gettime(clockId, &ts) != 0) {
+        return 0;
+    }
+    return static_cast<long long>(ts.tv_sec) * 1000 * 1000 * 1000 + ts.tv_nsec;
+}
+#endif
+}  // namespace
+
+void noteThreadAllocation(size_t bytes) {
+    threadAllocatedBytes += bytes;
+}
+
+long long getThreadAllocatedBytes() {
+    return threadAllocatedBytes;
+}
+
+long long getThreadBlockInputBytes() {
+#if defined(MONGO_HAVE_THREAD_CPU_CLOCK)
+    struct rusage usage;
+    if (getrusage(RUSAGE_THREAD, &usage) != 0) {
+        return -1;
+    }
+    // ru_inblock counts 512 byte blocks regardless of the device's block size.
+    return static_cast<long long>(usage.ru_inblock) * 512;
+#else
+    return -1;
+#endif
+}
+
+bool ThreadCpuTimer::isSupported() {
+#if defined(MONGO_HAVE_THREAD_CPU_CLOCK)
+    return true;
+#else
+    return false;
+#endif
+}
+
+void ThreadCpuTimer::start() {
+#if defined(MONGO_HAVE_THREAD_CPU_CLOCK)
+    // Use the clock of the calling thread itself rather than CLOCK_THREAD_CPUTIME_ID so that
+    // other threads can read it too.
+    if (pthread_getcpuclockid(pthread_self(), &_clockId) != 0) {
+        _clockId = CLOCK_THREAD_CPUTIME_ID;
+    }
+    _startNanos = readClockNanos(_clockId);
+#else
+    _startNanos = 0;
+#endif
+}
+
+long long ThreadCpuTimer::elapsedMicros() const {
+    invariant(isStarted());
+#if defined(MONGO_HAVE_THREAD_CPU_CLOCK)
+    return (readClockNanos(_clockId) - _startNanos) / 1000;
+#else
+    return 0;
+#endif
+}
+
+}  // namespace mongo
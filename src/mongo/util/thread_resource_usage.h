@@ -0,0 +1,85 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#if defined(__linux__)
+#include <time.h>
+#define MONGO_HAVE_THREAD_CPU_CLOCK
+#endif
+
+namespace mongo {
+
+/**
+ * Adds 'bytes' to the number of bytes allocated by the calling thread. This is called from
+ * allocator hooks, so it must not allocate.
+ */
+void noteThreadAllocation(size_t bytes);
+
+/**
+ * Returns the number of bytes allocated by the calling thread. This stays at zero unless an
+ * allocator hook reports allocations, see the trackThreadAllocations server parameter.
+ */
+long long getThreadAllocatedBytes();
+
+/**
+ * Returns the number of bytes the calling thread has read from block devices, or -1 if the
+ * platform does not report it. Reads served from the page cache are not counted.
+ */
+long long getThreadBlockInputBytes();
+
+/**
+ * Measures the CPU time used by the thread which called start(). The elapsed time may be read by
+ * any thread, but only while the measured thread is alive.
+ */
+class ThreadCpuTimer {
+public:
+    /**
+     * Returns false if this platform has no per-thread CPU clock, in which case elapsed time is
+     * always zero.
+     */
+    static bool isSupported();
+
+    void start();
+
+    bool isStarted() const {
+        return _startNanos >= 0;
+    }
+
+    long long elapsedMicros() const;
+
+private:
+#if defined(MONGO_HAVE_THREAD_CPU_CLOCK)
+    clockid_t _clockId;
+#endif
+    long long _startNanos = -1;
+};
+
+}  // namespace mongo
@@ -0,0 +1,79 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/thread_resource_usage.h"
+
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/timer.h"
+
+namespace mongo {
+namespace {
+
+TEST(ThreadResourceUsage, AllocationsAreCountedPerThread) {
+    const long long before = getThreadAllocatedBytes();
+    noteThreadAllocation(100);
+    noteThreadAllocation(28);
+    ASSERT_EQUALS(getThreadAllocatedBytes() - before, 128);
+
+    long long otherThreadBytes = -1;
+    stdx::thread other([&] { otherThreadBytes = getThreadAllocatedBytes(); });
+    other.join();
+    ASSERT_EQUALS(otherThreadBytes, 0);
+}
+
+TEST(ThreadResourceUsage, CpuTimeAdvancesWhileBusy) {
+    if (!ThreadCpuTimer::isSupported()) {
+        return;
+    }
+
+    ThreadCpuTimer cpuTimer;
+    ASSERT_FALSE(cpuTimer.isStarted());
+    cpuTimer.start();
+    ASSERT_TRUE(cpuTimer.isStarted());
+
+    Timer wallTimer;
+    volatile unsigned long long sink = 0;
+    while (wallTimer.millis() < 20) {
+        for (int i = 0; i < 1000; i++) {
+            sink += i;
+        }
+    }
+    ASSERT_GT(cpuTimer.elapsedMicros(), 0);
+}
+
+TEST(ThreadResourceUsage, BlockInputIsReportedWithCpuTime) {
+    if (ThreadCpuTimer::isSupported()) {
+        ASSERT_GTE(getThreadBlockInputBytes(), 0);
+    }
+}
+
+}  // namespace
+}  // namespace mongo